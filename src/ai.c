@@ -0,0 +1,653 @@
+/** @file
+ * Implementacja komputerowego gracza
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "ai.h"
+#include "hash_map.h"
+#include "playout.h"
+#include "transposition.h"
+
+/** Początkowa liczba węzłów drzewa jednego wątku. */
+#define AI_MIN_NODES 1024
+/** Największa liczba węzłów drzewa jednego wątku. */
+#define AI_MAX_NODES (1u << 20)
+/** Początkowa długość ścieżki od korzenia do liścia. */
+#define AI_MIN_PATH 64
+/** Stała eksploracji we wzorze UCT. */
+#define AI_EXPLORATION 0.7
+/** Szansa próby złotego ruchu w losowej rozgrywce (w %). */
+#define AI_GOLDEN_PERCENT 5
+/** Liczba wpisów wspólnej tablicy transpozycji. */
+#define AI_TABLE_ENTRIES (1u << 20)
+/** Największa liczba odwiedzin przejmowanych z tablicy transpozycji. */
+#define AI_PRIOR_LIMIT 32
+/** Jednostka wyniku zapisywanego w tablicy transpozycji. */
+#define AI_REWARD_SCALE 256
+/** Największa liczba odwiedzin zapisywana w tablicy transpozycji. */
+#define AI_TABLE_VISITS ((1u << 24) - 1)
+
+/** @brief Węzeł drzewa gry.
+ * Węzeł opisuje stan po ruchu @p move gracza @p mover. Dzieci węzła
+ * zajmują kolejne komórki tablicy węzłów, w losowej kolejności.
+ */
+typedef struct ai_node {
+    pair move;              ///< Pole ruchu prowadzącego do węzła.
+    uint32_t mover;         ///< Gracz, który wykonał ruch, 0 dla korzenia.
+    uint32_t to_move;       ///< Gracz, który ma ruch w węźle, 0 gdy gra się skończyła.
+    uint64_t first_child;   ///< Indeks pierwszego dziecka.
+    uint32_t children;      ///< Liczba dzieci.
+    uint32_t tried;         ///< Liczba dzieci odwiedzonych co najmniej raz.
+    bool golden;            ///< Czy ruch był złotym ruchem.
+    bool expanded;          ///< Czy dzieci węzła zostały utworzone.
+    uint64_t visits;        ///< Liczba rozgrywek przechodzących przez węzeł.
+    double reward;          ///< Suma wyników gracza @p mover w tych rozgrywkach.
+    uint64_t key;           ///< Klucz stanu w tablicy transpozycji.
+    uint32_t prior_visits;  ///< Odwiedziny przejęte z tablicy transpozycji.
+    double prior_reward;    ///< Suma wyników przejęta z tablicy transpozycji.
+} ai_node;
+
+/** @brief Dane jednego wątku przeszukiwania. */
+typedef struct ai_worker {
+    ai_t* ai;               ///< Wskaźnik na wspólny stan przeszukiwania.
+    pthread_t thread;       ///< Wątek przeszukiwania.
+    bool running;           ///< Czy wątek został uruchomiony.
+    ai_node* nodes;         ///< Tablica węzłów drzewa.
+    uint64_t count;         ///< Liczba używanych węzłów.
+    uint64_t capacity;      ///< Rozmiar tablicy węzłów.
+    uint64_t root;          ///< Indeks korzenia.
+    gamma_t* game;          ///< Kopia gry, na której wykonujemy ruchy.
+    pair* moves;            ///< Bufor na legalne ruchy.
+    uint64_t* path;         ///< Ścieżka od korzenia do aktualnego węzła.
+    uint64_t path_capacity; ///< Rozmiar tablicy @p path.
+    double* rewards;        ///< Wyniki graczy w ostatniej rozgrywce.
+    rng r;                  ///< Generator liczb losowych wątku.
+} ai_worker;
+
+/** @brief Wspólny stan przeszukiwania. */
+struct ai {
+    gamma_t* game;              ///< Prawdziwa gra.
+    gamma_t* root;              ///< Stan gry w korzeniu przeszukiwania.
+    uint32_t player;            ///< Gracz, który ma ruch w korzeniu.
+    uint32_t threads;           ///< Liczba wątków.
+    ai_worker* workers;         ///< Dane wątków.
+    transposition* table;       /**< @brief Tablica transpozycji.
+                                * Wspólne dla wszystkich wątków statystyki
+                                * stanów gry, niezależne od kolejności ruchów,
+                                * które do nich prowadzą.
+                                */
+    atomic_bool stop;           ///< Czy wątki mają się zatrzymać.
+    atomic_uint_fast64_t playouts; ///< Liczba rozgrywek od uruchomienia.
+    bool running;               ///< Czy przeszukiwanie trwa.
+};
+
+/** @brief Czyści drzewo wątku, zostawiając tylko korzeń.
+ * @param[in,out] w     - dane wątku
+ */
+static void reset_tree(ai_worker *w) {
+    w->count = 1;
+    w->root = 0;
+    w->nodes[0] = (ai_node){.move = make_pair(0, 0)};
+}
+
+/** @brief Sprawdza, czy gracz ma jakikolwiek ruch.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] player    - numer gracza
+ * @return Wartość @p true, jeżeli gracz może zająć pole lub wykonać złoty ruch.
+ */
+static bool can_move(gamma_t *g, uint32_t player) {
+    uint64_t count = 0;
+    pair *targets;
+
+    if (gamma_free_fields(g, player) > 0)
+        return true;
+
+    if (!gamma_golden_possible(g, player))
+        return false;
+
+    targets = gamma_golden_targets(g, player, &count);
+    free(targets);
+
+    return count > 0;
+}
+
+/** @brief Podaje gracza, który ma ruch po graczu @p player.
+ * Pomija graczy, którzy nie mogą się ruszyć.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] player    - numer gracza, który właśnie się ruszył
+ * @return Numer gracza lub 0, gdy nikt nie może się ruszyć.
+ */
+static uint32_t next_player(gamma_t *g, uint32_t player) {
+    uint32_t players = gamma_how_many_players(g);
+
+    for (uint32_t i = 1; i <= players; i++) {
+        uint32_t p = (player + i - 1) % players + 1;
+
+        if (can_move(g, p))
+            return p;
+    }
+
+    return 0;
+}
+
+/** @brief Wykonuje na grze ruch zapisany w węźle.
+ * @param[in,out] g     - wskaźnik na grę
+ * @param[in] node      - węzeł
+ */
+static void apply_move(gamma_t *g, const ai_node *node) {
+    if (node->golden)
+        gamma_golden_move(g, node->mover, node->move.fst, node->move.snd);
+    else
+        gamma_move(g, node->mover, node->move.fst, node->move.snd);
+}
+
+/** @brief Tworzy dzieci węzła dla wszystkich ruchów gracza.
+ * @param[in,out] w     - dane wątku
+ * @param[in] node      - indeks węzła, którego stan jest w @p w->game
+ * @param[in] player    - gracz, który ma ruch w węźle, dodatni
+ * @return Wartość @p true, jeżeli się udało, @p false gdy drzewo jest pełne
+ * lub zabrakło pamięci.
+ */
+static bool expand(ai_worker *w, uint64_t node, uint32_t player) {
+    gamma_t *g = w->game;
+    uint64_t cap = (uint64_t)gamma_width(g) * gamma_height(g);
+    uint64_t placements, golden = 0, total;
+    pair *targets = NULL;
+
+    placements = gamma_legal_moves(g, player, w->moves, cap);
+
+    if (gamma_golden_possible(g, player)) {
+        targets = gamma_golden_targets(g, player, &golden);
+        if (targets == NULL)
+            return false;
+    }
+
+    total = placements + golden;
+
+    if (w->count + total > AI_MAX_NODES) {
+        free(targets);
+        return false;
+    }
+
+    if (w->count + total > w->capacity) {
+        uint64_t capacity = w->capacity;
+        ai_node *nodes;
+
+        while (capacity < w->count + total)
+            capacity *= 2;
+
+        nodes = realloc(w->nodes, capacity * sizeof(ai_node));
+        if (nodes == NULL) {
+            free(targets);
+            return false;
+        }
+
+        w->nodes = nodes;
+        w->capacity = capacity;
+    }
+
+    for (uint64_t i = 0; i < total; i++) {
+        ai_node *child = &w->nodes[w->count + i];
+
+        *child = (ai_node){.mover = player};
+        child->golden = i >= placements;
+        child->move = i < placements ? w->moves[i] : targets[i - placements];
+    }
+
+    /* Mieszamy dzieci, żeby nieodwiedzone wybierać po kolei. */
+    for (uint64_t i = total; i > 1; i--) {
+        uint64_t j = rng_below(&w->r, i);
+        ai_node tmp = w->nodes[w->count + i - 1];
+
+        w->nodes[w->count + i - 1] = w->nodes[w->count + j];
+        w->nodes[w->count + j] = tmp;
+    }
+
+    w->nodes[node].first_child = w->count;
+    w->nodes[node].children = total;
+    w->nodes[node].to_move = player;
+    w->nodes[node].expanded = true;
+    w->count += total;
+
+    free(targets);
+
+    return true;
+}
+
+/** @brief Wybiera dziecko węzła.
+ * Najpierw odwiedzamy każde dziecko raz, a potem wybieramy dziecko
+ * o największej wartości UCT.
+ * @param[in,out] w     - dane wątku
+ * @param[in] node      - indeks węzła z co najmniej jednym dzieckiem
+ * @return Indeks wybranego dziecka.
+ */
+static uint64_t select_child(ai_worker *w, uint64_t node) {
+    ai_node *parent = &w->nodes[node];
+    uint64_t best = parent->first_child;
+    double best_value = -1, log_visits, value;
+
+    if (parent->tried < parent->children)
+        return parent->first_child + parent->tried++;
+
+    log_visits = log((double)parent->visits);
+
+    for (uint64_t i = 0; i < parent->children; i++) {
+        ai_node *child = &w->nodes[parent->first_child + i];
+        double visits = (double)child->visits + child->prior_visits;
+
+        value = (child->reward + child->prior_reward) / visits +
+                AI_EXPLORATION * sqrt(log_visits / visits);
+
+        if (value > best_value) {
+            best_value = value;
+            best = parent->first_child + i;
+        }
+    }
+
+    return best;
+}
+
+/** @brief Wylicza klucz stanu w tablicy transpozycji.
+ * Ten sam układ planszy może być oceniany z punktu widzenia różnych graczy,
+ * więc klucz zależy też od gracza, który wykonał ostatni ruch.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] mover     - gracz, który wykonał ostatni ruch
+ * @return Klucz stanu.
+ */
+static uint64_t table_key(gamma_t *g, uint32_t mover) {
+    return gamma_hash(g) ^ (mover * 0x9e3779b97f4a7c15ULL);
+}
+
+/** @brief Przejmuje statystyki nowego węzła z tablicy transpozycji.
+ * Tablica zawiera wyniki innych wątków i wyniki dla tego samego stanu
+ * osiągniętego inną kolejnością ruchów. Przejmujemy ich ograniczoną część,
+ * żeby nie zagłuszyły własnych obserwacji wątku.
+ * @param[in,out] w     - dane wątku
+ * @param[in] node      - indeks węzła, którego stan jest w @p w->game
+ */
+static void load_prior(ai_worker *w, uint64_t node) {
+    ai_node *n = &w->nodes[node];
+    uint64_t data;
+    uint32_t visits;
+
+    n->key = table_key(w->game, n->mover);
+
+    if (!transposition_probe(w->ai->table, n->key, &data))
+        return;
+
+    visits = data >> 32;
+    if (visits == 0)
+        return;
+
+    n->prior_visits = visits < AI_PRIOR_LIMIT ? visits : AI_PRIOR_LIMIT;
+    n->prior_reward = (double)(uint32_t)data / AI_REWARD_SCALE *
+                      n->prior_visits / visits;
+}
+
+/** @brief Dopisuje wynik rozgrywki do tablicy transpozycji.
+ * @param[in,out] w     - dane wątku
+ * @param[in] n         - węzeł
+ */
+static void store_result(ai_worker *w, const ai_node *n) {
+    uint64_t data = 0, visits, reward;
+
+    transposition_probe(w->ai->table, n->key, &data);
+
+    visits = data >> 32;
+    reward = (uint32_t)data;
+
+    if (visits < AI_TABLE_VISITS) {
+        visits++;
+        reward += (uint64_t)(w->rewards[n->mover] * AI_REWARD_SCALE);
+        transposition_store(w->ai->table, n->key, visits << 32 | reward);
+    }
+}
+
+/** @brief Dopisuje węzeł do ścieżki.
+ * @param[in,out] w     - dane wątku
+ * @param[in] length    - aktualna długość ścieżki
+ * @param[in] node      - indeks węzła
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool push_path(ai_worker *w, uint64_t length, uint64_t node) {
+    if (length == w->path_capacity) {
+        uint64_t capacity = 2 * w->path_capacity;
+        uint64_t *path = realloc(w->path, capacity * sizeof(uint64_t));
+
+        if (path == NULL)
+            return false;
+
+        w->path = path;
+        w->path_capacity = capacity;
+    }
+
+    w->path[length] = node;
+
+    return true;
+}
+
+/** @brief Ocenia zakończoną grę.
+ * Gracze z największą liczbą pól dzielą się wygraną, pozostali dostają zero.
+ * @param[in] g         - wskaźnik na grę
+ * @param[out] rewards  - wyniki graczy, indeksowane numerem gracza
+ */
+static void score(gamma_t *g, double *rewards) {
+    uint32_t players = gamma_how_many_players(g), winners = 0;
+    uint64_t best = 0, fields;
+
+    for (uint32_t p = 1; p <= players; p++) {
+        fields = gamma_busy_fields(g, p);
+
+        if (fields > best) {
+            best = fields;
+            winners = 0;
+        }
+        if (fields == best)
+            winners++;
+    }
+
+    rewards[0] = 0;
+    for (uint32_t p = 1; p <= players; p++)
+        rewards[p] = gamma_busy_fields(g, p) == best ? 1.0 / winners : 0;
+}
+
+/** @brief Wykonuje jedną iterację przeszukiwania.
+ * Schodzi od korzenia do liścia, rozwija go, rozgrywa losowo grę do końca
+ * i dopisuje wynik do węzłów na ścieżce.
+ * @param[in,out] w     - dane wątku
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool iterate(ai_worker *w) {
+    ai_t *ai = w->ai;
+    gamma_t *g = w->game;
+    uint64_t node = w->root, length = 0;
+    uint32_t player = ai->player;
+
+    gamma_copy_into(g, ai->root);
+    w->path[length++] = node;
+
+    while (w->nodes[node].expanded && w->nodes[node].children > 0) {
+        node = select_child(w, node);
+        apply_move(g, &w->nodes[node]);
+        player = next_player(g, w->nodes[node].mover);
+
+        if (w->nodes[node].visits == 0)
+            load_prior(w, node);
+
+        if (!push_path(w, length++, node))
+            return false;
+    }
+
+    if (!w->nodes[node].expanded) {
+        if (player == 0) {
+            w->nodes[node].expanded = true;
+            w->nodes[node].to_move = 0;
+        }
+        else if (expand(w, node, player) && w->nodes[node].children > 0) {
+            node = select_child(w, node);
+            apply_move(g, &w->nodes[node]);
+            player = next_player(g, w->nodes[node].mover);
+            load_prior(w, node);
+
+            if (!push_path(w, length++, node))
+                return false;
+        }
+    }
+
+    if (player != 0)
+        playout_game(g, &w->r, player, PLAYOUT_RANDOM, AI_GOLDEN_PERCENT,
+                     w->moves, NULL);
+
+    score(g, w->rewards);
+
+    for (uint64_t i = 0; i < length; i++) {
+        ai_node *n = &w->nodes[w->path[i]];
+
+        n->visits++;
+        n->reward += w->rewards[n->mover];
+
+        if (n->mover != 0)
+            store_result(w, n);
+    }
+
+    return true;
+}
+
+/** @brief Pętla wątku przeszukiwania.
+ * @param[in,out] arg   - dane wątku
+ * @return NULL
+ */
+static void* search(void *arg) {
+    ai_worker *w = arg;
+    ai_t *ai = w->ai;
+
+    while (!atomic_load_explicit(&ai->stop, memory_order_relaxed)) {
+        if (!iterate(w))
+            break;
+
+        atomic_fetch_add_explicit(&ai->playouts, 1, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+ai_t* ai_new(gamma_t *g, uint32_t threads, uint64_t seed) {
+    ai_t *ai;
+    uint64_t fields;
+
+    if (g == NULL || threads == 0)
+        return NULL;
+
+    ai = calloc(1, sizeof(ai_t));
+    if (ai == NULL)
+        return NULL;
+
+    fields = (uint64_t)gamma_width(g) * gamma_height(g);
+
+    ai->game = g;
+    ai->threads = threads;
+    ai->root = gamma_copy(g);
+    ai->workers = calloc(threads, sizeof(ai_worker));
+    ai->table = transposition_new(AI_TABLE_ENTRIES);
+    atomic_init(&ai->stop, false);
+    atomic_init(&ai->playouts, 0);
+
+    if (ai->root == NULL || ai->workers == NULL || ai->table == NULL) {
+        ai_delete(ai);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < threads; i++) {
+        ai_worker *w = &ai->workers[i];
+
+        w->ai = ai;
+        w->capacity = AI_MIN_NODES;
+        w->nodes = malloc(w->capacity * sizeof(ai_node));
+        w->game = gamma_copy(g);
+        w->moves = malloc(fields * sizeof(pair));
+        w->path_capacity = AI_MIN_PATH;
+        w->path = malloc(w->path_capacity * sizeof(uint64_t));
+        w->rewards = malloc(((uint64_t)gamma_how_many_players(g) + 1) * sizeof(double));
+        rng_seed(&w->r, seed ^ ((i + 1) * 0x9e3779b97f4a7c15ULL));
+
+        if (w->nodes == NULL || w->game == NULL || w->moves == NULL ||
+            w->path == NULL || w->rewards == NULL) {
+            ai_delete(ai);
+            return NULL;
+        }
+
+        reset_tree(w);
+    }
+
+    return ai;
+}
+
+void ai_delete(ai_t *ai) {
+    if (ai == NULL)
+        return;
+
+    ai_stop(ai);
+
+    if (ai->workers != NULL) {
+        for (uint32_t i = 0; i < ai->threads; i++) {
+            ai_worker *w = &ai->workers[i];
+
+            free(w->nodes);
+            gamma_delete(w->game);
+            free(w->moves);
+            free(w->path);
+            free(w->rewards);
+        }
+    }
+
+    gamma_delete(ai->root);
+    transposition_delete(ai->table);
+    free(ai->workers);
+    free(ai);
+}
+
+bool ai_start(ai_t *ai, uint32_t player) {
+    bool started = false;
+
+    if (ai == NULL || ai->running)
+        return false;
+
+    gamma_copy_into(ai->root, ai->game);
+    ai->player = player;
+    atomic_store(&ai->stop, false);
+    atomic_store(&ai->playouts, 0);
+
+    for (uint32_t i = 0; i < ai->threads; i++) {
+        ai_worker *w = &ai->workers[i];
+        ai_node *root = &w->nodes[w->root];
+
+        if (root->expanded && root->to_move != player)
+            reset_tree(w);
+
+        w->running = pthread_create(&w->thread, NULL, search, w) == 0;
+        started = started || w->running;
+    }
+
+    ai->running = started;
+
+    return started;
+}
+
+void ai_stop(ai_t *ai) {
+    if (ai == NULL || !ai->running)
+        return;
+
+    atomic_store(&ai->stop, true);
+
+    for (uint32_t i = 0; i < ai->threads; i++) {
+        if (ai->workers[i].running)
+            pthread_join(ai->workers[i].thread, NULL);
+
+        ai->workers[i].running = false;
+    }
+
+    ai->running = false;
+}
+
+uint64_t ai_playouts(ai_t *ai) {
+    return atomic_load_explicit(&ai->playouts, memory_order_relaxed);
+}
+
+/** @brief Podaje klucz ruchu w tablicy haszującej.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] node      - węzeł ruchu
+ * @return Klucz, różny dla różnych ruchów.
+ */
+static uint64_t move_key(gamma_t *g, const ai_node *node) {
+    uint64_t index = (uint64_t)node->move.fst * gamma_height(g) + node->move.snd;
+
+    return 2 * index + node->golden;
+}
+
+bool ai_best(ai_t *ai, pair *field, bool *golden) {
+    hash_map visits;
+    uint64_t best_visits = 0, key, sum;
+    bool found = false;
+
+    if (ai == NULL || ai->running)
+        return false;
+
+    /* Przeszukiwanie mogło zostać zatrzymane przed pierwszą iteracją. */
+    if (!ai->workers[0].nodes[ai->workers[0].root].expanded)
+        iterate(&ai->workers[0]);
+
+    hash_map_init(&visits);
+
+    for (uint32_t i = 0; i < ai->threads; i++) {
+        ai_worker *w = &ai->workers[i];
+        ai_node *root = &w->nodes[w->root];
+
+        if (!root->expanded)
+            continue;
+
+        for (uint64_t c = 0; c < root->children; c++) {
+            ai_node *child = &w->nodes[root->first_child + c];
+
+            key = move_key(ai->root, child);
+            sum = 0;
+            hash_map_get(&visits, key, &sum);
+            sum += child->visits;
+
+            if (!hash_map_put(&visits, key, sum))
+                continue;
+
+            if (!found || sum > best_visits) {
+                best_visits = sum;
+                *field = child->move;
+                *golden = child->golden;
+                found = true;
+            }
+        }
+    }
+
+    hash_map_free(&visits);
+
+    return found;
+}
+
+void ai_played(ai_t *ai, uint32_t player, pair field, bool golden) {
+    if (ai == NULL || ai->running)
+        return;
+
+    for (uint32_t i = 0; i < ai->threads; i++) {
+        ai_worker *w = &ai->workers[i];
+        ai_node *root = &w->nodes[w->root];
+        uint64_t next = w->root;
+
+        for (uint64_t c = 0; root->expanded && c < root->children; c++) {
+            ai_node *child = &w->nodes[root->first_child + c];
+
+            if (child->mover == player && child->golden == golden &&
+                child->move.fst == field.fst && child->move.snd == field.snd) {
+                next = root->first_child + c;
+                break;
+            }
+        }
+
+        /* Węzły spoza poddrzewa zostają w tablicy, więc co jakiś czas
+         * zaczynamy od nowa, żeby drzewo mogło dalej rosnąć. */
+        if (next == w->root || w->count > AI_MAX_NODES / 2)
+            reset_tree(w);
+        else
+            w->root = next;
+    }
+}
+
+void ai_passed(ai_t *ai) {
+    if (ai == NULL || ai->running)
+        return;
+
+    for (uint32_t i = 0; i < ai->threads; i++)
+        reset_tree(&ai->workers[i]);
+}
@@ -0,0 +1,87 @@
+/** @file
+ * Interfejs komputerowego gracza
+ *
+ * Komputerowy gracz wybiera ruch przeszukiwaniem drzewa gry metodą
+ * Monte Carlo (UCT). Przeszukiwanie działa na wątkach w tle, więc wątek
+ * interfejsu może w tym czasie obsługiwać klawiaturę. Każdy wątek buduje
+ * własne drzewo na własnej kopii stanu gry, a przy wyborze ruchu sumujemy
+ * liczby odwiedzin ruchów z korzeni wszystkich drzew. <br>
+ * Po wykonaniu ruchu w prawdziwej grze drzewa są przycinane do poddrzewa
+ * tego ruchu, dzięki czemu wyniki przeszukiwania z tury przeciwnika nie
+ * przepadają.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_AI_H
+#define GAMMA_AI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+
+/** @brief Struktura przechowująca stan przeszukiwania. */
+typedef struct ai ai_t;
+
+/** @brief Tworzy komputerowego gracza dla danej gry.
+ * @param[in] g         - wskaźnik na grę, której stan będzie przeszukiwany
+ * @param[in] threads   - liczba wątków przeszukiwania, dodatnia
+ * @param[in] seed      - ziarno generatora liczb losowych
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy zabrakło pamięci.
+ */
+ai_t* ai_new(gamma_t *g, uint32_t threads, uint64_t seed);
+
+/** @brief Usuwa strukturę, zatrzymując wcześniej przeszukiwanie.
+ * @param[in] ai        - wskaźnik na usuwaną strukturę
+ */
+void ai_delete(ai_t *ai);
+
+/** @brief Rozpoczyna przeszukiwanie w tle.
+ * Zapamiętuje aktualny stan gry @p g podanej w @ref ai_new. Do czasu
+ * wywołania @ref ai_stop gra może być odczytywana, ale nie zmieniana.
+ * @param[in,out] ai    - wskaźnik na strukturę
+ * @param[in] player    - numer gracza, który ma teraz ruch
+ * @return Wartość @p true, jeżeli udało się uruchomić wątki.
+ */
+bool ai_start(ai_t *ai, uint32_t player);
+
+/** @brief Zatrzymuje przeszukiwanie i czeka na zakończenie wątków.
+ * @param[in,out] ai    - wskaźnik na strukturę
+ */
+void ai_stop(ai_t *ai);
+
+/** @brief Podaje liczbę rozgrywek od ostatniego @ref ai_start.
+ * Można wywoływać w trakcie przeszukiwania.
+ * @param[in] ai        - wskaźnik na strukturę
+ * @return Liczba wykonanych losowych rozgrywek.
+ */
+uint64_t ai_playouts(ai_t *ai);
+
+/** @brief Wybiera najlepszy ruch z zatrzymanego przeszukiwania.
+ * @param[in,out] ai    - wskaźnik na strukturę
+ * @param[out] field    - wybrane pole
+ * @param[out] golden   - czy ruch jest złotym ruchem
+ * @return Wartość @p true, jeżeli gracz ma jakiś ruch, @p false gdy
+ * powinien spasować.
+ */
+bool ai_best(ai_t *ai, pair *field, bool *golden);
+
+/** @brief Informuje o ruchu wykonanym w grze.
+ * Przeszukiwanie musi być zatrzymane. Drzewa są przycinane do poddrzewa
+ * wykonanego ruchu, a jeżeli go nie zawierają - czyszczone.
+ * @param[in,out] ai    - wskaźnik na strukturę
+ * @param[in] player    - numer gracza, który wykonał ruch
+ * @param[in] field     - pole ruchu
+ * @param[in] golden    - czy był to złoty ruch
+ */
+void ai_played(ai_t *ai, uint32_t player, pair field, bool golden);
+
+/** @brief Informuje, że gracz spasował.
+ * Drzewa nie zawierają pasów, więc są czyszczone.
+ * @param[in,out] ai    - wskaźnik na strukturę
+ */
+void ai_passed(ai_t *ai);
+
+#endif //GAMMA_AI_H
@@ -0,0 +1,374 @@
+/** @file
+ * Implementacja drzewa bloków i punktów artykulacji.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "block_tree.h"
+
+/** Początkowy rozmiar tablic bloków i ścieżek. */
+#define BLOCK_TREE_MIN_CAPACITY 16
+
+/** Brak wierzchołka (wierzchołki numerujemy od 0). */
+#define NO_VERTEX UINT64_MAX
+
+/** Maska liczby bloków w tablicy @p blocks_count. */
+#define BLOCK_TREE_COUNT_MASK 0x1f
+
+bool block_tree_init(block_tree *tree, uint64_t vertices) {
+    memset(tree, 0, sizeof(block_tree));
+
+    if (vertices > SIZE_MAX / sizeof(uint64_t))
+        return false;
+
+    tree->vertices = vertices;
+    tree->vertex_parent = calloc(vertices, sizeof(uint64_t));
+    tree->blocks_count = malloc(vertices * sizeof(uint8_t));
+
+    if (tree->vertex_parent == NULL || tree->blocks_count == NULL) {
+        block_tree_free(tree);
+        return false;
+    }
+
+    memset(tree->blocks_count, BLOCK_TREE_UNBUILT, vertices * sizeof(uint8_t));
+
+    return true;
+}
+
+bool block_tree_grow(block_tree *tree, uint64_t vertices) {
+    uint64_t *parent;
+    uint8_t *count;
+
+    if (vertices <= tree->vertices)
+        return true;
+
+    if (vertices > SIZE_MAX / sizeof(uint64_t))
+        return false;
+
+    parent = realloc(tree->vertex_parent, vertices * sizeof(uint64_t));
+    if (parent == NULL)
+        return false;
+    tree->vertex_parent = parent;
+
+    count = realloc(tree->blocks_count, vertices * sizeof(uint8_t));
+    if (count == NULL)
+        return false;
+    tree->blocks_count = count;
+
+    memset(parent + tree->vertices, 0,
+           (vertices - tree->vertices) * sizeof(uint64_t));
+    memset(count + tree->vertices, BLOCK_TREE_UNBUILT,
+           (vertices - tree->vertices) * sizeof(uint8_t));
+    tree->vertices = vertices;
+
+    return true;
+}
+
+void block_tree_clear(block_tree *tree) {
+    tree->blocks = 0;
+    memset(tree->vertex_parent, 0, tree->vertices * sizeof(uint64_t));
+    memset(tree->blocks_count, BLOCK_TREE_UNBUILT, tree->vertices * sizeof(uint8_t));
+}
+
+void block_tree_reset_vertex(block_tree *tree, uint64_t v) {
+    tree->vertex_parent[v] = BLOCK_TREE_NONE;
+    tree->blocks_count[v] = 0;
+}
+
+uint8_t block_tree_parts(const block_tree *tree, uint64_t v) {
+    return tree->blocks_count[v] & BLOCK_TREE_COUNT_MASK;
+}
+
+/** @brief Powiększa tablicę liczb.
+ * @param[in,out] arr       - wskaźnik na tablicę
+ * @param[in] capacity      - nowy rozmiar tablicy
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool grow_array(uint64_t **arr, uint64_t capacity) {
+    uint64_t *bigger = realloc(*arr, capacity * sizeof(uint64_t));
+
+    if (bigger == NULL)
+        return false;
+
+    *arr = bigger;
+    return true;
+}
+
+/** @brief Tworzy nowy blok.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] parent    - wierzchołek-rodzic nowego bloku
+ * @return Numer nowego bloku lub @ref BLOCK_TREE_NONE, gdy zabrakło pamięci.
+ */
+static uint64_t new_block(block_tree *tree, uint64_t parent) {
+    if (tree->blocks + 1 >= tree->capacity) {
+        uint64_t capacity = tree->capacity == 0 ?
+                            BLOCK_TREE_MIN_CAPACITY : 2 * tree->capacity;
+        uint8_t *rank;
+
+        if (!grow_array(&tree->block_parent, capacity) ||
+            !grow_array(&tree->block_union, capacity) ||
+            !grow_array(&tree->block_mark, capacity) ||
+            !grow_array(&tree->block_entry, capacity))
+            return BLOCK_TREE_NONE;
+
+        rank = realloc(tree->block_rank, capacity * sizeof(uint8_t));
+        if (rank == NULL)
+            return BLOCK_TREE_NONE;
+
+        tree->block_rank = rank;
+        tree->capacity = capacity;
+    }
+
+    uint64_t b = ++tree->blocks;
+
+    tree->block_parent[b] = parent;
+    tree->block_union[b] = b;
+    tree->block_rank[b] = 0;
+    tree->block_mark[b] = 0;
+
+    return b;
+}
+
+/** @brief Znajduje reprezentanta bloku.
+ * Skraca ścieżki metodą połowienia.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] b         - numer bloku
+ * @return Numer bloku, który reprezentuje blok @p b.
+ */
+static uint64_t find_block(block_tree *tree, uint64_t b) {
+    while (tree->block_union[b] != b) {
+        tree->block_union[b] = tree->block_union[tree->block_union[b]];
+        b = tree->block_union[b];
+    }
+
+    return b;
+}
+
+/** @brief Łączy dwa bloki w jeden.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] a         - reprezentant pierwszego bloku
+ * @param[in] b         - reprezentant drugiego bloku
+ * @return Reprezentant połączonego bloku.
+ */
+static uint64_t union_blocks(block_tree *tree, uint64_t a, uint64_t b) {
+    if (a == b)
+        return a;
+
+    if (tree->block_rank[a] < tree->block_rank[b]) {
+        uint64_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    tree->block_union[b] = a;
+
+    if (tree->block_rank[a] == tree->block_rank[b])
+        tree->block_rank[a]++;
+
+    return a;
+}
+
+/** @brief Podaje rodzica wierzchołka w lesie wierzchołków.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] v         - numer wierzchołka, który nie jest korzeniem
+ * @return Wierzchołek-rodzic bloku-rodzica wierzchołka @p v.
+ */
+static uint64_t grandparent(block_tree *tree, uint64_t v) {
+    return tree->block_parent[find_block(tree, tree->vertex_parent[v])];
+}
+
+/** @brief Czyni wierzchołek korzeniem jego drzewa.
+ * Odwraca kierunek krawędzi na ścieżce od @p x do korzenia.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] x         - numer wierzchołka
+ */
+static void reroot(block_tree *tree, uint64_t x) {
+    uint64_t prev = x, up, next;
+    uint64_t b = tree->vertex_parent[x];
+
+    tree->vertex_parent[x] = BLOCK_TREE_NONE;
+
+    while (b != BLOCK_TREE_NONE) {
+        b = find_block(tree, b);
+        up = tree->block_parent[b];
+        next = tree->vertex_parent[up];
+
+        tree->block_parent[b] = prev;
+        tree->vertex_parent[up] = b;
+
+        prev = up;
+        b = next;
+    }
+}
+
+/** @brief Łączy dwa drzewa nowym blokiem złożonym z jednej krawędzi.
+ * Korzeniem przestaje być ten z końców krawędzi, który leży płycej,
+ * bo koszt zmiany korzenia jest proporcjonalny do głębokości.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] u         - wierzchołek pierwszego drzewa
+ * @param[in] w         - wierzchołek drugiego drzewa
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool link(block_tree *tree, uint64_t u, uint64_t w) {
+    uint64_t a = u, b = w, x, y, k;
+
+    while (true) {
+        if (tree->vertex_parent[a] == BLOCK_TREE_NONE) {
+            x = u;
+            y = w;
+            break;
+        }
+        if (tree->vertex_parent[b] == BLOCK_TREE_NONE) {
+            x = w;
+            y = u;
+            break;
+        }
+        a = grandparent(tree, a);
+        b = grandparent(tree, b);
+    }
+
+    k = new_block(tree, y);
+    if (k == BLOCK_TREE_NONE)
+        return false;
+
+    reroot(tree, x);
+    tree->vertex_parent[x] = k;
+    tree->blocks_count[u]++;
+    tree->blocks_count[w]++;
+
+    return true;
+}
+
+/** @brief Dopisuje blok do ścieżki.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] side      - numer ścieżki, 0 lub 1
+ * @param[in] length    - aktualna długość ścieżki
+ * @param[in] b         - dopisywany blok
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool push_path(block_tree *tree, int side, uint64_t length, uint64_t b) {
+    if (length == tree->path_capacity[side]) {
+        uint64_t capacity = length == 0 ? BLOCK_TREE_MIN_CAPACITY : 2 * length;
+
+        if (!grow_array(&tree->path[side], capacity))
+            return false;
+
+        tree->path_capacity[side] = capacity;
+    }
+
+    tree->path[side][length] = b;
+
+    return true;
+}
+
+/** @brief Skleja bloki na ścieżce między końcami nowej krawędzi.
+ * Szuka najniższego wspólnego przodka, wchodząc na przemian w górę od obu
+ * końców i znacząc odwiedzone bloki. Wszystkie bloki na ścieżce stają się
+ * jednym blokiem, a wierzchołki wewnątrz ścieżki należą odtąd do o jeden
+ * bloku mniej.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] u         - pierwszy koniec krawędzi
+ * @param[in] w         - drugi koniec krawędzi, w tym samym drzewie co @p u
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool condense(block_tree *tree, uint64_t u, uint64_t w) {
+    uint64_t end[2] = {u, w}, length[2] = {0, 0};
+    bool done[2] = {false, false};
+    uint64_t base = tree->stamp + 1;
+    uint64_t top_block = BLOCK_TREE_NONE, top_vertex = NO_VERTEX;
+    uint64_t top_parent, b, y, merged = BLOCK_TREE_NONE;
+    int side = 0;
+
+    tree->stamp += 2;
+
+    while (!done[0] || !done[1]) {
+        if (!done[side]) {
+            if (tree->vertex_parent[end[side]] == BLOCK_TREE_NONE) {
+                done[side] = true;
+            }
+            else {
+                b = find_block(tree, tree->vertex_parent[end[side]]);
+
+                if (tree->block_mark[b] == base + 1 - side) {
+                    int other = 1 - side;
+                    uint64_t k = 0;
+
+                    while (tree->path[other][k] != b)
+                        k++;
+
+                    if (tree->block_entry[b] == end[side]) {
+                        top_vertex = end[side];
+                        length[other] = k;
+                    }
+                    else {
+                        top_block = b;
+                        length[other] = k + 1;
+                    }
+                    break;
+                }
+
+                if (!push_path(tree, side, length[side], b))
+                    return false;
+
+                tree->block_mark[b] = base + side;
+                tree->block_entry[b] = end[side];
+                length[side]++;
+                end[side] = tree->block_parent[b];
+            }
+        }
+        side = 1 - side;
+    }
+
+    if (top_block == BLOCK_TREE_NONE && top_vertex == NO_VERTEX)
+        top_vertex = end[0];
+
+    top_parent = top_block != BLOCK_TREE_NONE ?
+                 tree->block_parent[top_block] : top_vertex;
+
+    for (side = 0; side < 2; side++) {
+        for (uint64_t i = 0; i < length[side]; i++) {
+            b = tree->path[side][i];
+
+            if (b != top_block) {
+                y = tree->block_parent[b];
+
+                if (y != u && y != w && y != top_vertex)
+                    tree->blocks_count[y]--;
+            }
+
+            merged = merged == BLOCK_TREE_NONE ?
+                     b : union_blocks(tree, merged, b);
+        }
+    }
+
+    if (top_vertex != NO_VERTEX && top_vertex != u && top_vertex != w)
+        tree->blocks_count[top_vertex]--;
+
+    if (merged != BLOCK_TREE_NONE)
+        tree->block_parent[merged] = top_parent;
+
+    return true;
+}
+
+bool block_tree_add_edge(block_tree *tree, uint64_t u, uint64_t w, bool same_tree) {
+    if (same_tree)
+        return condense(tree, u, w);
+    else
+        return link(tree, u, w);
+}
+
+void block_tree_free(block_tree *tree) {
+    free(tree->vertex_parent);
+    free(tree->blocks_count);
+    free(tree->block_parent);
+    free(tree->block_union);
+    free(tree->block_rank);
+    free(tree->block_mark);
+    free(tree->block_entry);
+    free(tree->path[0]);
+    free(tree->path[1]);
+    memset(tree, 0, sizeof(block_tree));
+}
@@ -0,0 +1,106 @@
+/** @file
+ * Interfejs drzewa bloków i punktów artykulacji.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_BLOCK_TREE_H
+#define GAMMA_BLOCK_TREE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Brak bloku lub wierzchołka. */
+#define BLOCK_TREE_NONE 0
+
+/** @brief Struktura drzewa bloków (las bloków i wierzchołków).
+ * Dla grafu, do którego tylko dodajemy krawędzie, utrzymuje las, w którym
+ * wierzchołkami są wierzchołki grafu oraz bloki (dwuspójne składowe).
+ * Rodzicem wierzchołka jest blok, a rodzicem bloku wierzchołek należący
+ * do tego bloku. Bloki sklejone przez nowy cykl łączymy strukturą
+ * FIND & UNION. <br>
+ * Liczba bloków, do których należy wierzchołek, jest równa liczbie części,
+ * na które rozpadnie się jego spójna składowa po usunięciu tego wierzchołka.
+ * Wierzchołki numerujemy od 0, bloki od 1 (0 oznacza brak).
+ */
+typedef struct block_tree {
+    uint64_t vertices;          ///< Liczba wierzchołków.
+    uint64_t* vertex_parent;    ///< Blok-rodzic wierzchołka.
+    uint8_t* blocks_count;      ///< Liczba bloków zawierających wierzchołek i flagi.
+
+    uint64_t blocks;            ///< Liczba utworzonych bloków.
+    uint64_t capacity;          ///< Rozmiar tablic bloków.
+    uint64_t* block_parent;     ///< Wierzchołek-rodzic bloku.
+    uint64_t* block_union;      ///< Rodzic bloku w strukturze FIND & UNION.
+    uint8_t* block_rank;        ///< Ranga bloku w strukturze FIND & UNION.
+    uint64_t* block_mark;       ///< Znacznik odwiedzenia przy szukaniu ścieżki.
+    uint64_t* block_entry;      ///< Wierzchołek, z którego weszliśmy do bloku.
+    uint64_t stamp;             ///< Ostatnio użyty znacznik.
+
+    uint64_t* path[2];          ///< Bloki na ścieżkach od obu końców krawędzi.
+    uint64_t path_capacity[2];  ///< Rozmiary tablic @p path.
+} block_tree;
+
+/** Flaga wierzchołka czekającego na przebudowę. */
+#define BLOCK_TREE_PENDING 0x80
+/** Flaga wierzchołka, którego jeszcze nie wstawiliśmy. */
+#define BLOCK_TREE_UNBUILT 0x40
+/** Flaga wierzchołka odłożonego na stos w trakcie przebudowy. */
+#define BLOCK_TREE_QUEUED 0x20
+
+/** @brief Tworzy drzewo bloków.
+ * Wszystkie wierzchołki są oznaczone flagą @ref BLOCK_TREE_UNBUILT.
+ * @param[out] tree     - wskaźnik na inicjowaną strukturę
+ * @param[in] vertices  - liczba wierzchołków, liczba dodatnia
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+bool block_tree_init(block_tree *tree, uint64_t vertices);
+
+/** @brief Dokłada nowe wierzchołki.
+ * Nowe wierzchołki są oznaczone flagą @ref BLOCK_TREE_UNBUILT, a istniejące
+ * i bloki pozostają bez zmian. Przy niepowodzeniu drzewo też się nie zmienia.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] vertices  - nowa liczba wierzchołków, nie mniejsza od obecnej
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+bool block_tree_grow(block_tree *tree, uint64_t vertices);
+
+/** @brief Usuwa wszystkie bloki.
+ * Wszystkie wierzchołki ponownie oznaczamy flagą @ref BLOCK_TREE_UNBUILT.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ */
+void block_tree_clear(block_tree *tree);
+
+/** @brief Odłącza wierzchołek od wszystkich bloków.
+ * Wierzchołek staje się izolowanym korzeniem, a jego flagi są zerowane.
+ * Wywołujący musi odłączyć wszystkie wierzchołki, które były z nim w jednej
+ * spójnej składowej.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] v         - numer wierzchołka
+ */
+void block_tree_reset_vertex(block_tree *tree, uint64_t v);
+
+/** @brief Dodaje krawędź do grafu.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ * @param[in] u         - numer pierwszego końca krawędzi
+ * @param[in] w         - numer drugiego końca krawędzi
+ * @param[in] same_tree - czy @p u i @p w są już w jednej spójnej składowej
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+bool block_tree_add_edge(block_tree *tree, uint64_t u, uint64_t w, bool same_tree);
+
+/** @brief Podaje, na ile części rozpadnie się składowa po usunięciu wierzchołka.
+ * @param[in] tree      - wskaźnik na drzewo
+ * @param[in] v         - numer wierzchołka
+ * @return Liczba bloków zawierających wierzchołek @p v.
+ */
+uint8_t block_tree_parts(const block_tree *tree, uint64_t v);
+
+/** @brief Zwalnia pamięć drzewa.
+ * @param[in,out] tree  - wskaźnik na drzewo
+ */
+void block_tree_free(block_tree *tree);
+
+#endif //GAMMA_BLOCK_TREE_H
@@ -0,0 +1,217 @@
+/** @file
+ * Implementacja trybu wsadowego z punktami kontrolnymi
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "gamma.h"
+#include "new_parser.h"
+
+/** Wersja formatu pliku punktu kontrolnego. */
+#define CHECKPOINT_VERSION 1
+
+/** @brief Stan zapisywania punktów kontrolnych. */
+typedef struct checkpoint_state {
+    const checkpoint_config *config;    ///< Ustawienia.
+    uint64_t offset;            ///< Położenie następnej linii w wejściu.
+    uint64_t saved_line;        ///< Numer linii ostatniego punktu kontrolnego.
+    bool saved_game;            ///< Czy ostatni punkt kontrolny zawiera grę.
+    uint64_t tried_line;        ///< Numer linii ostatniej próby zapisu.
+    uint64_t tried_time;        ///< Czas ostatniej próby zapisu w sekundach.
+} checkpoint_state;
+
+/** @brief Podaje bieżący czas.
+ * @return Liczba sekund od ustalonej chwili w przeszłości.
+ */
+static uint64_t now_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec;
+}
+
+/** @brief Tworzy ścieżkę pliku pochodnego od ścieżki punktu kontrolnego.
+ * @param[in] path      - ścieżka punktu kontrolnego
+ * @param[in] suffix    - przyrostek dopisywany po kropce
+ * @return Zaalokowany napis lub NULL, gdy zabrakło pamięci.
+ */
+static char* derived_path(const char *path, const char *suffix) {
+    char *out;
+
+    if (asprintf(&out, "%s.%s", path, suffix) < 0)
+        return NULL;
+
+    return out;
+}
+
+/** @brief Tworzy ścieżkę zapisu gry z danego punktu kontrolnego.
+ * @param[in] path      - ścieżka punktu kontrolnego
+ * @param[in] line      - numer linii punktu kontrolnego
+ * @return Zaalokowany napis lub NULL, gdy zabrakło pamięci.
+ */
+static char* game_path(const char *path, uint64_t line) {
+    char number[24];
+
+    snprintf(number, sizeof(number), "%lu", line);
+
+    return derived_path(path, number);
+}
+
+/** @brief Zapisuje grę do pliku i czeka na zapisanie go na dysku.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] path      - ścieżka pliku
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool save_game(gamma_t *g, const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok;
+
+    if (fd < 0)
+        return false;
+
+    ok = gamma_save(g, fd, false) && fsync(fd) == 0;
+
+    return close(fd) == 0 && ok;
+}
+
+/** @brief Zapisuje punkt kontrolny po bieżącej linii.
+ * Najpierw zapisuje grę, potem atomowo podmienia plik punktu kontrolnego,
+ * a na końcu usuwa zapis gry z poprzedniego punktu.
+ * @param[in] batch     - stan parsera
+ * @param[in,out] state - stan zapisywania punktów kontrolnych
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool write_checkpoint(batch_state *batch, checkpoint_state *state) {
+    const char *path = state->config->path;
+    char *game = game_path(path, batch->lines);
+    char *temporary = derived_path(path, "tmp");
+    bool ok = game != NULL && temporary != NULL;
+    FILE *file = NULL;
+
+    fflush(batch->out);
+    fflush(batch->err);
+
+    if (ok && batch->gamma != NULL)
+        ok = save_game(batch->gamma, game);
+
+    if (ok)
+        ok = (file = fopen(temporary, "w")) != NULL;
+
+    if (ok) {
+        ok = fprintf(file, "gamma-checkpoint %d\nline %lu\noffset %lu\ngame %d\n",
+                     CHECKPOINT_VERSION, batch->lines, state->offset,
+                     batch->gamma != NULL) > 0;
+        ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+        ok = fclose(file) == 0 && ok && rename(temporary, path) == 0;
+    }
+
+    if (ok && state->saved_game && state->saved_line != batch->lines) {
+        free(game);
+        game = game_path(path, state->saved_line);
+
+        if (game != NULL)
+            unlink(game);
+    }
+
+    if (ok) {
+        state->saved_line = batch->lines;
+        state->saved_game = batch->gamma != NULL;
+    }
+
+    state->tried_line = batch->lines;
+    state->tried_time = now_seconds();
+    free(game);
+    free(temporary);
+
+    return ok;
+}
+
+/** @brief Wznawia wykonywanie od zapisanego punktu kontrolnego.
+ * @param[in] in        - strumień poleceń
+ * @param[in,out] batch - stan parsera przed pierwszą linią
+ * @param[in,out] state - stan zapisywania punktów kontrolnych
+ * @return Wartość @p true, jeżeli wznowiono wykonywanie lub punktu
+ * kontrolnego nie ma, @p false gdy jest niepoprawny.
+ */
+static bool resume(FILE *in, batch_state *batch, checkpoint_state *state) {
+    FILE *file = fopen(state->config->path, "r");
+    uint64_t line, offset;
+    int version, game;
+    char *path;
+
+    if (file == NULL)
+        return errno == ENOENT;
+
+    if (fscanf(file, "gamma-checkpoint %d line %lu offset %lu game %d",
+               &version, &line, &offset, &game) != 4 ||
+        version != CHECKPOINT_VERSION || fseeko(in, offset, SEEK_SET) != 0) {
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+
+    if (game) {
+        path = game_path(state->config->path, line);
+        batch->gamma = path == NULL ? NULL : gamma_load(path);
+        free(path);
+
+        if (batch->gamma == NULL)
+            return false;
+    }
+
+    batch->lines = line;
+    state->offset = offset;
+    state->saved_line = state->tried_line = line;
+    state->saved_game = game;
+
+    return true;
+}
+
+bool batch_checkpointed(FILE *in, FILE *out, FILE *err,
+                        const checkpoint_config *config) {
+    const uint64_t every_lines = config->every_lines;
+    const uint64_t every_seconds = config->every_seconds;
+    checkpoint_state state = {config, 0, 0, false, 0, now_seconds()};
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t length;
+    batch_state batch;
+    bool ok = true;
+
+    batch_init(&batch, out, err);
+    batch.runs = true;
+
+    if (config->resume && !resume(in, &batch, &state)) {
+        batch_free(&batch);
+        return false;
+    }
+
+    while ((length = getline(&line, &size, in)) != -1) {
+        state.offset += length;
+
+        if (!batch_line(&batch, line, length))
+            break;
+
+        if ((every_lines != 0 && batch.lines - state.tried_line >= every_lines) ||
+            (every_seconds != 0 && now_seconds() - state.tried_time >= every_seconds)) {
+            batch_flush(&batch);
+            ok = write_checkpoint(&batch, &state) && ok;
+        }
+    }
+
+    batch_flush(&batch);
+    batch_free(&batch);
+    free(line);
+
+    return ok;
+}
@@ -0,0 +1,48 @@
+/** @file
+ * Interfejs trybu wsadowego z punktami kontrolnymi
+ *
+ * Co określoną liczbę linii lub sekund zapisuje stan gry funkcją
+ * @ref gamma_save razem z numerem ostatniej wykonanej linii i położeniem
+ * następnej linii w pliku wejściowym. Po awarii można wznowić wykonywanie
+ * od ostatniego punktu kontrolnego, a numery linii w komunikatach
+ * @p ERROR pozostają takie jak przy wykonaniu od początku. <br>
+ * Punkt kontrolny o ścieżce @p path to plik tekstowy @p path z numerem linii
+ * i położeniem w wejściu oraz zapis gry @p path.N, gdzie N to numer linii.
+ * Plik @p path jest podmieniany atomowo dopiero po zapisaniu gry, więc
+ * przerwanie programu w dowolnej chwili zostawia poprawny punkt kontrolny.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_CHECKPOINT_H
+#define GAMMA_CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** @brief Ustawienia punktów kontrolnych. */
+typedef struct checkpoint_config {
+    const char *path;           ///< Ścieżka punktu kontrolnego.
+    uint64_t every_lines;       ///< Co ile linii zapisywać punkt, albo 0.
+    uint64_t every_seconds;     ///< Co ile sekund zapisywać punkt, albo 0.
+    bool resume;                ///< Czy wznowić od zapisanego punktu.
+} checkpoint_config;
+
+/** @brief Wykonuje polecenia trybu wsadowego, zapisując punkty kontrolne.
+ * Przy wznawianiu strumień @p in musi pozwalać na zmianę położenia
+ * (np. plik przekierowany na standardowe wejście). Jeżeli punkt kontrolny
+ * jeszcze nie istnieje, wykonywanie zaczyna się od początku.
+ * @param[in] in        - strumień poleceń
+ * @param[in] out       - strumień wyników
+ * @param[in] err       - strumień komunikatów o błędach
+ * @param[in] config    - ustawienia punktów kontrolnych
+ * @return Wartość @p true, jeżeli się udało, @p false gdy nie udało się
+ * wznowić wykonywania albo zapisać punktu kontrolnego.
+ */
+bool batch_checkpointed(FILE *in, FILE *out, FILE *err,
+                        const checkpoint_config *config);
+
+#endif //GAMMA_CHECKPOINT_H
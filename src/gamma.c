@@ -6,12 +6,33 @@
  * @date 14.04.2020
  */
 
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "gamma.h"
 #include "pairs.h"
 #include "stack_pairs.h"
+#include "index_set.h"
+#include "block_tree.h"
+#include "trace.h"
 #include <stdio.h>
+
+#ifdef GAMMA_STATS
+/** Zwiększa licznik @p counter gry @p g o @p value. */
+#define STAT_ADD(g, counter, value) ((g)->stats.counter += (value))
+#else
+/** Bez makra GAMMA_STATS liczniki znikają razem z obliczaniem argumentów. */
+#define STAT_ADD(g, counter, value) ((void)0)
+#endif
 /** @brief Struktura pola na planszy.
  *  Przechowuje informacje o jednym polu na planszy,
  *  numer gracza do którego należy dane pole,
@@ -23,9 +44,130 @@
 typedef struct square {
     uint32_t player;    ///< Numer właściciela (0 dla wolnego pola),
     pair parent;        ///< Współrzędne pola do którego należy,
-    uint32_t rank;      ///< Ranga pola
+    uint16_t rank;      ///< Ranga pola
+    uint16_t children;  /**< @brief Liczba pól, których rodzicem jest to pole.
+                         * Po dojściu do CHILDREN_SATURATED licznik przestaje
+                         * się zmieniać aż do zresetowania pola.
+                         */
 } square;
 
+/** Wartość licznika dzieci pola, od której licznik jest tylko ograniczeniem dolnym. */
+#define CHILDREN_SATURATED UINT16_MAX
+
+/** Logarytm dwójkowy największego boku kawałka planszy. */
+#define CHUNK_BITS 6
+/** Największa liczba kawałków, dla której katalog jest zwykłą tablicą. */
+#define DENSE_DIRECTORY_MAX (1 << 20)
+/** Początkowy rozmiar stosu przejść po obszarach. */
+#define STACK_INITIAL 64
+/** O ile ruchów naprzód @ref gamma_apply_moves sprowadza pole do pamięci podręcznej. */
+#define PREFETCH_AHEAD 8
+/** Po ilu próbach czytelnik czekający na koniec zmiany stanu gry oddaje procesor. */
+#define READ_SPINS 64
+
+#ifdef GAMMA_MORTON
+/** Czy pola kawałka leżą w porządku Mortona, a nie kolumnami. */
+#define MORTON_LAYOUT true
+#else
+/** Czy pola kawałka leżą w porządku Mortona, a nie kolumnami. */
+#define MORTON_LAYOUT false
+#endif
+
+#ifdef GAMMA_GENERIC
+/** Czy plansze 8x8, 19x19 i 64x64 dostają wyspecjalizowane operacje silnika. */
+#define FIXED_ENGINES false
+#else
+/** Czy plansze 8x8, 19x19 i 64x64 dostają wyspecjalizowane operacje silnika. */
+#define FIXED_ENGINES true
+#endif
+
+/** Początek pliku z zapisem gry. */
+#define SNAPSHOT_MAGIC "GAMMASNP"
+/** Wersja formatu zapisu gry. */
+#define SNAPSHOT_VERSION 2
+/** Wersja formatu zapisu gry bez liczników dzieci pól. */
+#define SNAPSHOT_VERSION_NO_CHILDREN 1
+/** Flaga zapisu z właścicielami pól zapisanymi seriami. */
+#define SNAPSHOT_RLE 1u
+/** Flaga zapisu z polami kawałków w porządku Mortona. */
+#define SNAPSHOT_MORTON 2u
+/** Flaga układu pól kawałka w tej kompilacji silnika. */
+#define SNAPSHOT_LAYOUT (MORTON_LAYOUT ? SNAPSHOT_MORTON : 0u)
+/** Rozmiar nagłówka zapisu gry w bajtach. */
+#define SNAPSHOT_HEADER 64
+/** Rozmiar nagłówka kawałka w nieskompresowanym zapisie gry. */
+#define SNAPSHOT_CHUNK_HEADER 24
+/** Rozmiar pola w nieskompresowanym zapisie gry. */
+#define SNAPSHOT_SQUARE 16
+
+/** @brief Mnoży liczby, sprawdzając, czy wynik jest poprawnym rozmiarem pamięci.
+ * Na planszach z ponad 2^32 polami iloczyny liczby pól i rozmiaru elementu
+ * mogą nie mieścić się w typie @p size_t.
+ * @param[in] a         - pierwszy czynnik
+ * @param[in] b         - drugi czynnik
+ * @param[out] out      - iloczyn, jeżeli się mieści
+ * @return Wartość @p true, jeżeli iloczyn nie przekracza SIZE_MAX.
+ */
+static bool checked_mul(uint64_t a, uint64_t b, uint64_t *out) {
+    if (b != 0 && a > SIZE_MAX / b)
+        return false;
+
+    *out = a * b;
+
+    return true;
+}
+
+/** @brief Alokuje tablicę o podanej liczbie elementów.
+ * @param[in] count     - liczba elementów
+ * @param[in] size      - rozmiar elementu w bajtach
+ * @return Wskaźnik na tablicę lub NULL, gdy rozmiar się przepełnia lub
+ * zabrakło pamięci.
+ */
+static void* malloc_array(uint64_t count, uint64_t size) {
+    uint64_t bytes;
+
+    if (!checked_mul(count, size, &bytes))
+        return NULL;
+
+    return malloc(bytes);
+}
+
+/** @brief Kawałek planszy.
+ * Planszę dzielimy na prostokąty o bokach będących potęgami dwójki, nie
+ * większych niż 2^CHUNK_BITS. Kawałek tworzymy dopiero przy zajęciu jego
+ * pierwszego pola, więc pamięć zależy od zajętej części planszy, a nie od
+ * jej rozmiaru. Pola wewnątrz kawałka leżą kolumnami, a w kompilacji
+ * z GAMMA_MORTON w porządku Mortona (zob. @ref morton_offset).
+ */
+typedef struct chunk {
+    uint64_t id;            ///< Numer kawałka, zob. @ref chunk_id.
+    uint64_t epoch;         ///< Przejście, którego dotyczy tablica @p visited.
+    uint64_t* visited;      /**< @brief Mapa bitowa pól odwiedzonych w przejściu @p epoch.
+                            * NULL, dopóki nie przygotowano dla kawałka
+                            * przejścia funkcją @ref prepare_traversal.
+                            */
+    square fields[];        ///< Pola kawałka.
+} chunk;
+
+/** @brief Operacje silnika wyspecjalizowane dla jednego rozmiaru planszy.
+ * Funkcje mają te same argumenty i wyniki co odpowiednie funkcje z gamma.h.
+ */
+typedef struct engine_ops {
+    bool (*move)(gamma_t *g, uint32_t player, uint32_t x, uint32_t y); ///< Zob. @ref gamma_move.
+    uint32_t (*player)(gamma_t *g, uint32_t x, uint32_t y);           ///< Zob. @ref gamma_player.
+} engine_ops;
+
+/** @brief Blokady trybu współbieżnych ruchów.
+ * Obszar składa się z pól jednego gracza, więc drzewa FIND & UNION, liczniki
+ * pól i obszarów gracza zmieniają tylko jego ruchy. Dzielimy więc stan gry
+ * według graczy: ruch bierze blokadę swojego gracza, a wolne pole zajmuje
+ * atomowo, bo może o nie walczyć ruch innego gracza.
+ */
+typedef struct concurrent_locks {
+    pthread_mutex_t chunks;     ///< Chroni katalog i listę kawałków przy tworzeniu kawałka.
+    pthread_mutex_t players[];  ///< Blokada drzew FIND & UNION i liczników każdego gracza.
+} concurrent_locks;
+
 /** @brief Struktura całej planszy.
  *  Przechowuje informacje o aktualnym stanie gry,
  *  zaiwera dwuwymiarową tablicę pól, rozmiar tablicy
@@ -36,16 +178,42 @@ typedef struct square {
  *  2) ilość pól zajętych <br>
  *  3) informacje czy wykonał już swój złoty ruch <br>
  *  Dodatkowo zawiera stos który pomaga pomocniczy do poruszać się po planszy,
- *  oraz tablicę @p visited, która określa odwiedzone dotychczas pola.
+ *  oraz znaczniki odwiedzonych pól w kawałkach planszy. Obie te pomocnicze
+ *  struktury tworzymy dopiero przed pierwszym przejściem po obszarze
+ *  i można je zwolnić funkcją @ref gamma_shrink.
  */
 struct gamma {
-    square** board;         /**< @brief Opis planszy.
-                            * Dwuwymiarowa tablica pól, o wymiarach
-                            * [@p width][@p height], w której komórka
-                            * [ @p x] [@p y] zawiera pole o współrzędnych
-                            * (@p x, @p y). Numer gracza który zajmuje to pole
-                            * jest równy 0, dla wolnego pola. <br> Indeksowane od (0,0).
+    chunk** directory;      /**< @brief Katalog kawałków planszy.
+                            * Tablica adresów kawałków indeksowana funkcją
+                            * @ref chunk_id, z wartością NULL dla kawałków,
+                            * na których nie zajęto jeszcze pola. Dla plansz
+                            * z więcej niż DENSE_DIRECTORY_MAX kawałkami
+                            * jest NULL i używamy @p chunk_map.
                             */
+    hash_map chunk_map;     ///< Katalog kawałków bardzo dużych plansz.
+    chunk** chunks;         ///< Wszystkie utworzone kawałki.
+    uint64_t chunks_count;  ///< Liczba utworzonych kawałków.
+    uint64_t chunks_capacity; ///< Rozmiar tablicy @p chunks.
+    const engine_ops* ops;  /**< @brief Operacje dobrane do rozmiaru planszy.
+                            * Ustawiane w @ref gamma_new dla plansz, dla
+                            * których jest wyspecjalizowany silnik, a NULL
+                            * dla pozostałych.
+                            */
+    uint32_t chunk_mask_x;  ///< Szerokość kawałka minus jeden.
+    uint32_t chunk_mask_y;  ///< Wysokość kawałka minus jeden.
+    uint8_t chunk_bits_x;   ///< Logarytm dwójkowy szerokości kawałka.
+    uint8_t chunk_bits_y;   ///< Logarytm dwójkowy wysokości kawałka.
+    uint8_t column_bits;    /**< @brief Logarytm dwójkowy liczby kawałków w kolumnie.
+                            * Liczbę kawałków w kolumnie zaokrąglamy w górę
+                            * do potęgi dwójki, żeby numer kawałka liczyć
+                            * bez mnożenia.
+                            */
+    void* mapping;          /**< @brief Odwzorowany w pamięci plik z zapisem gry.
+                            * Kawałki wczytane funkcją @ref gamma_load leżą
+                            * wprost w tym obszarze i nie są zwalniane
+                            * osobno. NULL, jeżeli gry nie wczytano w ten sposób.
+                            */
+    uint64_t mapping_size;  ///< Rozmiar obszaru @p mapping w bajtach.
 
     uint32_t* player_areas; /**< @brief Pamięta liczbę obszarów każdego z graczy.
                             * Wskaźnik na pierwszy element tablicy, w której
@@ -69,22 +237,80 @@ struct gamma {
     uint32_t width;         ///< Liczba kolumn w planszy.
     uint32_t height;        ///< Liczba wierszy w planszy.
 
-    stack* stk;             ///< Stos na ktorym bedziemy wywolywac bfs.
-    bool* visited;          /**< @brief Tablica odwiedzonych pól.
-                            * Jednowymiarowa tablica wartości logicznych,
-                            * określająca pola które już odwiedziliśmy
-                            * w danym wywołaniu funkcji.
-                            * Niech @p k oznacza całkowitą częśc dzielenia
-                            * @p i @p / @p wysokość_planszy.
-                            * Wtedy pozycja @p i w tablicy visited określa
-                            * pole o współrzędnych (k, i - k * wysokość_planszy).
+    stack* stk;             /**< @brief Stos na ktorym bedziemy wywolywac bfs.
+                            * Tworzymy go przed pierwszym przejściem po
+                            * obszarze, do tego czasu jest NULL. Przed
+                            * przejściem rezerwujemy na nim miejsce na
+                            * wszystkie pola właściciela obszaru.
+                            */
+    uint64_t visited_chunks; /**< @brief Liczba kawałków z mapą odwiedzin.
+                             * Mapy mają początkowe kawałki z tablicy
+                             * @p chunks, a późniejsze dostaną je przy
+                             * następnym przygotowaniu przejścia.
+                             */
+    uint64_t epoch;         /**< @brief Numer bieżącego przejścia po obszarze.
+                            * Pole jest odwiedzone, jeżeli jego bit jest
+                            * ustawiony w mapie kawałka o tym samym numerze
+                            * przejścia. Nowe przejście zwiększa numer, zamiast
+                            * czyścić znaczniki całej planszy.
+                            */
+    index_set* frontiers;   /**< @brief Pogranicza graczy.
+                            * Wskaźnik na pierwszy element tablicy, w której
+                            * element o indeksie @p i jest zbiorem wolnych pól
+                            * sąsiadujących z jakimś polem gracza
+                            * o numerze @p i @p + @p 1.
+                            */
+    block_tree* splits;     /**< @brief Pamięć podręczna punktów artykulacji.
+                            * Drzewo bloków obszarów wszystkich graczy,
+                            * wierzchołki numerujemy funkcją @ref slot_index.
+                            * Tworzymy je przy pierwszym wywołaniu
+                            * @ref gamma_split_count, do tego czasu jest NULL.
+                            */
+    hash_map chunk_slots;   /**< @brief Położenia kawałków w tablicy @p chunks.
+                            * Przypisuje numerowi kawałka jego indeks
+                            * w tablicy @p chunks. Kawałków nie usuwamy, więc
+                            * raz wpisany indeks pozostaje aktualny.
+                            */
+    uint64_t slotted_chunks; /**< @brief Liczba kawałków wpisanych do @p chunk_slots.
+                             * Są to początkowe kawałki z tablicy @p chunks,
+                             * zob. @ref number_chunks.
+                             */
+    uint64_t hash;          /**< @brief Skrót Zobrista stanu gry.
+                            * Suma xor kluczy @ref zobrist_field wszystkich
+                            * zajętych pól i kluczy @ref zobrist_gold graczy,
+                            * którzy wykonali już złoty ruch.
                             */
+    bool frontiers_ok;      /**< @brief Czy pogranicza są aktualne.
+                            * Ustawiamy na @p false, gdy przy ich aktualizacji
+                            * zabrakło pamięci, oraz po wczytaniu gry. Wtedy
+                            * przestajemy je aktualizować i odbudowujemy je
+                            * funkcją @ref rebuild_frontiers przy następnym
+                            * użyciu, a gdy to się nie uda, przeglądamy całą
+                            * planszę.
+                            */
+    _Atomic uint64_t sequence; /**< @brief Licznik zmian stanu gry (seqlock).
+                            * Jest nieparzysty, gdy trwa zmiana. Funkcje
+                            * czytające z innych wątków, np. @ref gamma_read_player,
+                            * powtarzają odczyt, jeżeli licznik był nieparzysty
+                            * albo zmienił się w jego trakcie.
+                            */
+    concurrent_locks* locks; /**< @brief Blokady trybu współbieżnych ruchów.
+                            * Poza trybem rozpoczętym funkcją
+                            * @ref gamma_concurrent_begin jest NULL.
+                            */
+#ifdef GAMMA_STATS
+    gamma_counters stats;   ///< Liczniki pracy silnika.
+#endif
 };
 
 uint32_t gamma_how_many_players(gamma_t *g) {
     return g->number_of_players;
 }
 
+uint64_t gamma_hash(gamma_t *g) {
+    return g == NULL ? 0 : g->hash;
+}
+
 uint32_t gamma_width(gamma_t *g) {
     return g->width;
 }
@@ -96,6 +322,251 @@ uint32_t gamma_height(gamma_t *g) {
 
 
 
+/** @brief Podaje numer kawałka zawierającego pole.
+ * Kawałki numerujemy kolumnami, tak jak pola.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Numer kawałka.
+ */
+static uint64_t chunk_id(gamma_t *g, pair coordinates) {
+    return ((uint64_t)(coordinates.fst >> g->chunk_bits_x) << g->column_bits) |
+           (coordinates.snd >> g->chunk_bits_y);
+}
+
+/** @brief Rozsuwa bity liczby na pozycje parzyste.
+ * @param[in] v             - liczba mniejsza od 2^16
+ * @return Liczba, której bit 2i jest bitem i liczby @p v.
+ */
+static uint32_t spread_bits(uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+
+    return v;
+}
+
+/** @brief Zsuwa parzyste bity liczby, odwrotność @ref spread_bits.
+ * @param[in] v             - liczba
+ * @return Liczba, której bit i jest bitem 2i liczby @p v.
+ */
+static uint32_t compact_bits(uint32_t v) {
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+
+    return v;
+}
+
+/** @brief Podaje indeks pola kawałka w układzie kolumnowym.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] x             - numer kolumny pola wewnątrz kawałka
+ * @param[in] y             - numer wiersza pola wewnątrz kawałka
+ * @return Indeks pola w tablicy pól kawałka.
+ */
+static uint64_t column_offset(gamma_t *g, uint32_t x, uint32_t y) {
+    return ((uint64_t)x << g->chunk_bits_y) | y;
+}
+
+/** @brief Podaje indeks pola kawałka w porządku Mortona (krzywej Z).
+ * Bity numerów wiersza i kolumny występują na przemian (wiersz na bitach
+ * parzystych), więc pola bliskie na planszy we wszystkich kierunkach są
+ * bliskie w pamięci. Gdy kawałek nie jest kwadratem, nadmiarowe wyższe bity
+ * dłuższego boku trafiają ponad przeplecione bity.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] x             - numer kolumny pola wewnątrz kawałka
+ * @param[in] y             - numer wiersza pola wewnątrz kawałka
+ * @return Indeks pola w tablicy pól kawałka.
+ */
+static uint64_t morton_offset(gamma_t *g, uint32_t x, uint32_t y) {
+    uint8_t k = g->chunk_bits_x < g->chunk_bits_y ? g->chunk_bits_x : g->chunk_bits_y;
+    uint32_t low = (1u << k) - 1;
+
+    return (spread_bits(x & low) << 1 | spread_bits(y & low)) |
+           (uint64_t)((x >> k) | (y >> k)) << (2 * k);
+}
+
+/** @brief Podaje położenie pola wewnątrz kawałka o danym indeksie.
+ * Odwrotność @ref column_offset lub @ref morton_offset.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] offset        - indeks pola w tablicy pól kawałka
+ * @param[in] morton        - czy pola leżą w porządku Mortona
+ * @return Współrzędne pola względem lewego dolnego rogu kawałka.
+ */
+static pair offset_field(gamma_t *g, uint64_t offset, bool morton) {
+    uint8_t k = g->chunk_bits_x < g->chunk_bits_y ? g->chunk_bits_x : g->chunk_bits_y;
+    uint32_t high = (uint32_t)(offset >> (2 * k));
+    uint32_t mixed = (uint32_t)offset & ((1u << (2 * k)) - 1);
+
+    if (!morton)
+        return make_pair((uint32_t)(offset >> g->chunk_bits_y),
+                         (uint32_t)(offset & g->chunk_mask_y));
+
+    return make_pair(compact_bits(mixed >> 1) | (g->chunk_bits_x > k ? high << k : 0),
+                     compact_bits(mixed) | (g->chunk_bits_y > k ? high << k : 0));
+}
+
+/** @brief Podaje położenie pola wewnątrz jego kawałka.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Indeks pola w tablicy pól kawałka.
+ */
+static uint64_t chunk_offset(gamma_t *g, pair coordinates) {
+    uint32_t x = coordinates.fst & g->chunk_mask_x;
+    uint32_t y = coordinates.snd & g->chunk_mask_y;
+
+    return MORTON_LAYOUT ? morton_offset(g, x, y) : column_offset(g, x, y);
+}
+
+/** @brief Podaje liczbę pól jednego kawałka.
+ * @param[in] g             - wskaźnik na planszę
+ * @return Liczba pól kawałka.
+ */
+static uint64_t chunk_size(gamma_t *g) {
+    return (uint64_t)1 << (g->chunk_bits_x + g->chunk_bits_y);
+}
+
+/** @brief Szuka kawałka w katalogu.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] id            - numer kawałka
+ * @return Adres kawałka lub NULL, gdy nie został jeszcze utworzony.
+ */
+static chunk* find_chunk(gamma_t *g, uint64_t id) {
+    uint64_t address;
+
+    /* Kawałek może w tej chwili dodawać inny wątek, zob. @ref add_chunk.
+     * Kawałek dodany przed wywołaniem, np. pod blokadą gracza, który
+     * zajął w nim pole, znajdziemy zawsze, także w trakcie powiększania
+     * tablicy. Dzięki temu @ref get_field nie zwraca NULL dla pól gracza. */
+    if (g->directory != NULL)
+        return __atomic_load_n(&g->directory[id], __ATOMIC_ACQUIRE);
+
+    if (hash_map_get_shared(&g->chunk_map, id, &address))
+        return (chunk *)(uintptr_t)address;
+
+    return NULL;
+}
+
+/** @brief Dopisuje kawałek do katalogu i listy kawałków.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] c             - kawałek z ustawionym numerem, którego nie ma
+ *                            jeszcze w katalogu
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool add_chunk(gamma_t *g, chunk *c) {
+    if (g->chunks_count == g->chunks_capacity) {
+        uint64_t capacity = g->chunks_capacity == 0 ? 4 : 2 * g->chunks_capacity;
+        chunk **chunks = realloc(g->chunks, capacity * sizeof(chunk *));
+
+        if (chunks == NULL)
+            return false;
+
+        g->chunks = chunks;
+        g->chunks_capacity = capacity;
+    }
+
+    if (g->directory == NULL &&
+        !hash_map_put(&g->chunk_map, c->id, (uint64_t)(uintptr_t)c))
+        return false;
+
+    /* Czytelnik z innego wątku zobaczy kawałek dopiero po jego wyzerowaniu. */
+    if (g->directory != NULL)
+        __atomic_store_n(&g->directory[c->id], c, __ATOMIC_RELEASE);
+
+    g->chunks[g->chunks_count++] = c;
+
+    return true;
+}
+
+/** @brief Sprawdza, czy kawałek leży w odwzorowanym pliku.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] c             - kawałek planszy
+ * @return Wartość @p true, jeżeli kawałek wczytano wprost z pliku funkcją
+ * @ref gamma_load i nie wolno go zwalniać.
+ */
+static bool in_mapping(gamma_t *g, chunk *c) {
+    uintptr_t begin = (uintptr_t)g->mapping;
+
+    return g->mapping != NULL && (uintptr_t)c >= begin &&
+           (uintptr_t)c < begin + g->mapping_size;
+}
+
+/** @brief Podaje kawałek o danym numerze, w razie potrzeby go tworząc.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] id            - numer kawałka
+ * @return Adres kawałka lub NULL, gdy zabrakło pamięci.
+ */
+static chunk* claim_chunk(gamma_t *g, uint64_t id) {
+    chunk *out = find_chunk(g, id);
+
+    if (out != NULL)
+        return out;
+
+    out = calloc(1, sizeof(chunk) + chunk_size(g) * sizeof(square));
+    if (out == NULL)
+        return NULL;
+
+    out->id = id;
+
+    if (!add_chunk(g, out)) {
+        free(out);
+        return NULL;
+    }
+
+    return out;
+}
+
+/** @brief Zwraca adres pola o danych współrzędnych.
+ * Zwraca adres pola które znajduje się na parze współrzędnych
+ * @p coordinates znajdujące się na planszy wskazywanej przez wskaźnik @p g.
+ * Kawałek zawierający pole musi już istnieć, co jest prawdą dla każdego
+ * zajętego pola. Wolne pola odczytujemy funkcją @ref get_player.
+ * Funkcja wywołujaca powinna uważać, czy wskaźnik na planszę nie jest pusty.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] cooridnates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Adres pola wskazywane przez daną parę współrzędnych.
+ */
+static square* get_field(gamma_t *g, pair cooridnates) {
+    return &find_chunk(g, chunk_id(g, cooridnates))->fields[chunk_offset(g, cooridnates)];
+}
+
+/** @brief Zwraca numer gracza do którego należy pole.
+ * Zwraca numer gracza do którego należy pole o współrzędnych (@p x, @p y)
+ * na planszy @p g. Pola nieistniejących kawałków są wolne.
+ * Funkcja wywołująca musi uważać na to, czy dane pole
+ * jest dobrze określone dla danej planszy,
+ * i czy wskaźnik na planszę nie jest pusty.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] x             - numer kolumny pola
+ * @param[in] y             - numer wiersza pola
+ * @return Numer gracza do którego należy dane pole.
+ */
+static uint32_t player_at(gamma_t *g, uint32_t x, uint32_t y) {
+    uint64_t id = ((uint64_t)(x >> g->chunk_bits_x) << g->column_bits) |
+                  (y >> g->chunk_bits_y);
+    chunk *c = find_chunk(g, id);
+
+    if (c == NULL)
+        return 0;
+
+    return c->fields[chunk_offset(g, make_pair(x, y))].player;
+}
+
+/** @brief Zwraca numer gracza do którego należy pole.
+ * Zwraca numer gracza do którego należy pole o współrzędnych @p coordinates
+ * na planszy @p g. Funkcja wywołująca musi uważać na to, czy dane pole
+ * jest dobrze określone dla danej planszy,
+ * i czy wskaźnik na planszę nie jest pusty.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Numer gracza do którego należy dane pole.
+ */
+static uint32_t get_player(gamma_t *g, pair coordinates) {
+    return player_at(g, coordinates.fst, coordinates.snd);
+}
+
 /** @brief Sprawdza czy z danej pozycji możemy pójść w górę.
  * Określa czy pole, które znajduje się w wierszu wyżej niż pole o współrzędnych
  * @p a mieści się na planszy, i czy należy do tego samego gracza.
@@ -110,7 +581,7 @@ static bool is_north_valid(gamma_t *g, uint32_t player, pair a) {
     uint32_t x = a.fst;
     uint32_t y = a.snd;
 
-    return (y < g->height - 1 && g->board[x][y + 1].player == player);
+    return (y < g->height - 1 && player_at(g, x, y + 1) == player);
 }
 
 /** @brief Sprawdza czy z danej pozycji możemy pójść w dół.
@@ -127,7 +598,7 @@ static bool is_south_valid(gamma_t *g, uint32_t player, pair a) {
     uint32_t x = a.fst;
     uint32_t y = a.snd;
 
-    return (y > 0 && g->board[x][y - 1].player == player);
+    return (y > 0 && player_at(g, x, y - 1) == player);
 }
 
 /** @brief Sprawdza czy z danej pozycji możemy pójść w prawo.
@@ -144,7 +615,7 @@ static bool is_east_valid(gamma_t *g, uint32_t player, pair a) {
     uint32_t x = a.fst;
     uint32_t y = a.snd;
 
-    return (x < g->width - 1 && g->board[x + 1][y].player == player);
+    return (x < g->width - 1 && player_at(g, x + 1, y) == player);
 }
 
 /** @brief Sprawdza czy z danej pozycji możemy pójść w lewo.
@@ -161,7 +632,7 @@ static bool is_west_valid(gamma_t *g, uint32_t player, pair a) {
     uint32_t x = a.fst;
     uint32_t y = a.snd;
 
-    return (x > 0 && g->board[x - 1][y].player == player);
+    return (x > 0 && player_at(g, x - 1, y) == player);
 }
 
 /** @brief Przesuwa współrzędne do wiersza wyżej.
@@ -217,35 +688,30 @@ static pair move_pair_west(pair a) {
     return make_pair(a.fst - 1, a.snd);
 }
 
-/** @brief Zwraca adres pola o danych współrzędnych.
- * Zwraca adres pola które znajduje się na parze współrzędnych
- * @p coordinates znajdujące się na planszy wskazywanej przez wskaźnik @p g.
- * Funkcja wywołujaca powinna uważać, czy wskaźnik na planszę nie jest pusty.
- * @param[in] g             - wskaźnik na planszę
- * @param[in] cooridnates   - para nieujemnych współrzędnych opisująca położenie pola
- * @return Adres pola wskazywane przez daną parę współrzędnych.
- */
-static square* get_field(gamma_t *g, pair cooridnates) {
-    return &(g->board[cooridnates.fst][cooridnates.snd]);
+uint32_t gamma_player(gamma_t *g, uint32_t x, uint32_t y) {
+    pair coordinates = make_pair(x, y);
+
+    if (g->ops != NULL)
+        return g->ops->player(g, x, y);
+
+    return get_player(g, coordinates);
 }
 
-/** @brief Zwraca numer gracza do którego należy pole.
- * Zwraca numer gracza do którego należy pole o współrzędnych @p coordinates
- * na planszy @p g. Funkcja wywołująca musi uważać na to, czy dane pole 
- * jest dobrze określone dla danej planszy, 
- * i czy wskaźnik na planszę nie jest pusty.
- * @param[in] g             - wskaźnik na planszę 
- * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
- * @return Numer gracza do którego należy dane pole.
+/** @brief Zwiększa licznik dzieci pola.
+ * @param[in,out] field     - pole, które zostało rodzicem kolejnego pola
  */
-static uint32_t get_player(gamma_t *g, pair coordinates) {
-    return get_field(g, coordinates)->player;
+static void add_child(square *field) {
+    if (field->children != CHILDREN_SATURATED)
+        field->children++;
 }
 
-uint32_t gamma_player(gamma_t *g, uint32_t x, uint32_t y) {
-    pair coordinates = make_pair(x, y);
-
-    return get_player(g, coordinates);
+/** @brief Zmniejsza licznik dzieci pola.
+ * Nasycony licznik zostaje bez zmian, bo nie wiemy już, ile dzieci ma pole.
+ * @param[in,out] field     - pole, które przestało być rodzicem jakiegoś pola
+ */
+static void remove_child(square *field) {
+    if (field->children != CHILDREN_SATURATED)
+        field->children--;
 }
 
 /** @brief Określa głównego rodzica danego pola.
@@ -267,7 +733,17 @@ static pair find_ancestor(gamma_t *g, pair coordinates) {
     actual = get_field(g, coordinates)->parent;
 
     if (compare_pairs(actual, coordinates) != 0) {
-        return get_field(g, coordinates)->parent = find_ancestor(g, actual);
+        pair root = find_ancestor(g, actual);
+
+        STAT_ADD(g, find_hops, 1);
+        STAT_ADD(g, path_writes, compare_pairs(root, actual) != 0);
+
+        if (compare_pairs(root, actual) != 0) {
+            remove_child(get_field(g, actual));
+            add_child(get_field(g, root));
+        }
+
+        return get_field(g, coordinates)->parent = root;
     }
     else {
         return actual;
@@ -303,21 +779,30 @@ static void union_fields(gamma_t *g, pair x, pair y, bool if_need_to_count) {
     uint32_t owner = get_field(g, x)->player;
     square *ancestor_x, *ancestor_y;
 
+    /* Pola już w jednym obszarze: nie zmieniamy rang, bo 16-bitowa ranga
+     * korzenia rosłaby przy każdym takim wywołaniu i w końcu się przekręciła. */
+    if (compare_pairs(a, b) == 0)
+        return;
+
     ancestor_x = get_field(g, a);
     ancestor_y = get_field(g, b);
 
-    if (compare_pairs(a, b) != 0 && if_need_to_count)
+    if (if_need_to_count)
         g->player_areas[owner - 1]--;
 
+    STAT_ADD(g, unions, 1);
+
     if (ancestor_x->rank > ancestor_y->rank) {
         ancestor_y->parent = a;
+        add_child(ancestor_x);
     }
     else {
         ancestor_x->parent = b;
-    }
+        add_child(ancestor_y);
 
-    if (ancestor_x->rank == ancestor_y->rank)
-        ancestor_x->rank++;
+        if (ancestor_x->rank == ancestor_y->rank)
+            ancestor_y->rank++;
+    }
 }
 /** @brief Łączy wszystkie pola sąsiadujące.
  * Podłącza wszystkie pola, które są zajęte przez gracza o numerze @p player,
@@ -374,316 +859,1318 @@ static bool check_neighbours(gamma_t *g, uint32_t player, pair center) {
     else
         return  false;
 }
-/** @brief Ustawia wszystkie wartości tablicy bool na false.
- * Funkcja dla danej tablicy bool @p arr, i jej rozmiaru jako
- * @p size. Ustawia jej wszystkie wartości na @p false. <br>
- * Należy zwracać uwagę na poprawność przekazywanych argumentów.
- * @param[in, out] arr    - wskaźnik na pierwszą wartość w tablicy
- * @param[in] size        - rozmiar tablicy, liczba dodatnia.
+/** @brief Wylicza indeks pola.
+ * Pola numerujemy kolumnami.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Indeks pola, liczba nieujemna mniejsza od liczby pól planszy.
  */
-static void clear_bool_arr(bool* arr, uint64_t size) {
-    memset(arr, false, size * sizeof(bool));
+static uint64_t field_index(gamma_t *g, pair coordinates) {
+    return (uint64_t)coordinates.fst * g->height + coordinates.snd;
 }
-/** @brief Sprawdza czy pamięć na planszę jest dobrze zaalokowana.
- * Funkcja sprawdza czy plansza na którą wskazuje wskaźńik @p g, jest poprawna.
- * Czyli czy udało się zaalokować wystarczającą ilosć pamięci.
- * @param[in] g                 - wskaźnik na strukturę planszy
- * @return Wartość logiczna @p true, gdy poprawnie zaalokowano pamięć.
- * @p false w przeciwnym wypadku.
+
+/** @brief Miesza bity liczby.
+ * Funkcja mieszająca z generatora splitmix64.
+ * @param[in] x             - liczba
+ * @return Wymieszana liczba.
  */
-static bool check_if_all_ok(gamma_t *g) {
-    if (g == NULL || g->board == NULL)
-        return false;
+static uint64_t zobrist_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    return x;
+}
 
-    for (uint32_t i = 0; i < g->width; i++) {
-        if (g->board[i] == NULL) {
-            return false;
-        }
-    }
+/** @brief Podaje klucz Zobrista pola o danym indeksie zajętego przez gracza.
+ * @param[in] index         - indeks pola, zob. @ref field_index
+ * @param[in] player        - numer gracza, liczba dodatnia
+ * @return Klucz pola należącego do gracza @p player.
+ */
+static uint64_t zobrist_key(uint64_t index, uint32_t player) {
+    return zobrist_mix(index * 0x9e3779b97f4a7c15ULL + player * 0xd1b54a32d192ed03ULL);
+}
 
-    if (g->player_fields == NULL ||
-        g->player_gold_move == NULL ||
-        g->player_areas == NULL ||
-        g->stk == NULL ||
-        g->visited == NULL)
-        return false;
+/** @brief Podaje klucz Zobrista pola zajętego przez gracza.
+ * Klucze wyliczamy zamiast trzymać ich tablicę, która dla dużych plansz
+ * zajmowałaby więcej pamięci niż sama plansza.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] field         - para nieujemnych współrzędnych opisująca pole
+ * @param[in] player        - numer gracza, liczba dodatnia
+ * @return Klucz pola @p field należącego do gracza @p player.
+ */
+static uint64_t zobrist_field(gamma_t *g, pair field, uint32_t player) {
+    return zobrist_key(field_index(g, field), player);
+}
 
-    return true;
+/** @brief Podaje klucz Zobrista wykonanego złotego ruchu.
+ * @param[in] player        - numer gracza, liczba dodatnia
+ * @return Klucz gracza @p player, który wykonał już złoty ruch.
+ */
+static uint64_t zobrist_gold(uint32_t player) {
+    return zobrist_mix(~(player * 0xd1b54a32d192ed03ULL));
 }
 
-gamma_t* gamma_new(uint32_t width, uint32_t height,
-                   uint32_t players, uint32_t areas) {
-    if (width < 1 || height < 1 || players < 1 || areas < 1)
-        return NULL;
+/** @brief Uzgadnia przynależność pola do pogranicza gracza.
+ * Pole należy do pogranicza gracza @p player, jeżeli jest wolne
+ * i sąsiaduje z jakimś polem tego gracza.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] player        - numer gracza, liczba dodatnia
+ * @param[in] field         - para nieujemnych współrzędnych opisująca pole
+ */
+static void sync_frontier(gamma_t *g, uint32_t player, pair field) {
+    index_set *frontier = &g->frontiers[player - 1];
+    uint64_t key = field_index(g, field);
 
-    gamma_t* new_object = (gamma_t *)malloc(sizeof(gamma_t));
+    /* Nieaktualne pogranicza i tak zostaną odbudowane od zera. */
+    if (!g->frontiers_ok)
+        return;
 
-    if (new_object == NULL)
-        return NULL;
+    if (get_player(g, field) == 0 && check_neighbours(g, player, field)) {
+        if (!index_set_insert(frontier, key, field))
+            g->frontiers_ok = false;
+    }
+    else {
+        index_set_remove(frontier, key);
+    }
+}
 
-    new_object->board = (struct square **)calloc(width, sizeof(struct square));
+/** @brief Uzgadnia pogranicze pola z sąsiadami.
+ * Sprawdza, czy dane pole nadal należy do pogranicza graczy,
+ * którzy zajmują sąsiednie pola.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] field         - para nieujemnych współrzędnych opisująca pole
+ * @param[in] neighbour     - para nieujemnych współrzędnych sąsiedniego pola
+ * @param[in] old_owner     - poprzedni właściciel pola @p field (0 dla wolnego)
+ * @param[in] new_owner     - nowy właściciel pola @p field (0 dla wolnego)
+ */
+static void sync_frontier_pair(gamma_t *g, pair field, pair neighbour,
+                               uint32_t old_owner, uint32_t new_owner) {
+    uint32_t owner = get_player(g, neighbour);
 
-    if (new_object->board != NULL) {
-        for (uint32_t i = 0; i < width; i++) {
-            new_object->board[i] = (struct square *) calloc(height, sizeof(struct square));
-        }
+    if (owner != 0) {
+        sync_frontier(g, owner, field);
+    }
+    else {
+        if (old_owner != 0)
+            sync_frontier(g, old_owner, neighbour);
+        if (new_owner != 0)
+            sync_frontier(g, new_owner, neighbour);
     }
+}
 
-    new_object->player_areas = calloc(players, sizeof(uint32_t));
-    new_object->player_fields = calloc(players, sizeof(uint64_t));
+/** @brief Aktualizuje pogranicza po zmianie właściciela pola.
+ * Zmiana właściciela pola @p center może zmienić przynależność do pograniczy
+ * tylko tego pola oraz jego wolnych sąsiadów, więc aktualizacja działa w czasie
+ * stałym.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] center        - para nieujemnych współrzędnych zmienionego pola
+ * @param[in] old_owner     - poprzedni właściciel pola (0 dla wolnego)
+ * @param[in] new_owner     - nowy właściciel pola (0 dla wolnego)
+ */
+static void update_frontiers(gamma_t *g, pair center,
+                             uint32_t old_owner, uint32_t new_owner) {
+    if (center.snd < g->height - 1)
+        sync_frontier_pair(g, center, move_pair_north(center), old_owner, new_owner);
+    if (center.snd > 0)
+        sync_frontier_pair(g, center, move_pair_south(center), old_owner, new_owner);
+    if (center.fst < g->width - 1)
+        sync_frontier_pair(g, center, move_pair_east(center), old_owner, new_owner);
+    if (center.fst > 0)
+        sync_frontier_pair(g, center, move_pair_west(center), old_owner, new_owner);
+}
 
-    new_object->player_gold_move = calloc(players, sizeof(bool));
-    clear_bool_arr(new_object->player_gold_move, players);
+/** @brief Podaje sąsiada pola w danym kierunku.
+ * Kierunki numerujemy: 0 - północ, 1 - południe, 2 - zachód, 3 - wschód.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] player        - numer gracza, do którego ma należeć sąsiad
+ * @param[in] a             - para nieujemnych współrzędnych pola
+ * @param[in] direction     - numer kierunku, liczba od 0 do 3
+ * @param[out] out          - współrzędne sąsiada
+ * @return Wartość @p true, jeżeli sąsiad leży na planszy i należy do gracza
+ * @p player, @p false w przeciwnym wypadku.
+ */
+static bool neighbour_in_direction(gamma_t *g, uint32_t player, pair a,
+                                   int direction, pair *out) {
+    switch (direction) {
+        case 0:
+            *out = move_pair_north(a);
+            return is_north_valid(g, player, a);
+        case 1:
+            *out = move_pair_south(a);
+            return is_south_valid(g, player, a);
+        case 2:
+            *out = move_pair_west(a);
+            return is_west_valid(g, player, a);
+        default:
+            *out = move_pair_east(a);
+            return is_east_valid(g, player, a);
+    }
+}
 
-    new_object->number_of_players = players;
+/** @brief Podaje pole kawałka o danym położeniu w jego tablicy pól.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] c             - kawałek planszy
+ * @param[in] offset        - indeks pola w tablicy pól kawałka
+ * @return Współrzędne pola; dla kawałków na brzegu planszy mogą leżeć
+ * poza planszą.
+ */
+static pair chunk_field(gamma_t *g, chunk *c, uint64_t offset) {
+    uint32_t x = (uint32_t)(c->id >> g->column_bits) << g->chunk_bits_x;
+    uint32_t y = (uint32_t)(c->id & (((uint64_t)1 << g->column_bits) - 1)) << g->chunk_bits_y;
+    pair inside = offset_field(g, offset, MORTON_LAYOUT);
 
-    new_object->areas = areas;
-    new_object->width = width;
-    new_object->height = height;
+    return make_pair(x + inside.fst, y + inside.snd);
+}
 
-    new_object->stk = new_stack(width * height);
-    new_object->visited = (bool *)malloc(width * height * sizeof(bool));
+/** @brief Odbudowuje od zera pogranicza wszystkich graczy.
+ * Przegląda tylko istniejące kawałki, więc działa w czasie liniowym względem
+ * liczby zajętych kawałków planszy.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci
+ * (pogranicza pozostają wtedy nieaktualne).
+ */
+static bool rebuild_frontiers(gamma_t *g) {
+    pair field, next;
 
-    if (!check_if_all_ok(new_object)){
-        gamma_delete(new_object);
-        return NULL;
-    }
+    for (uint32_t i = 0; i < g->number_of_players; i++)
+        index_set_clear(&g->frontiers[i]);
 
-    return new_object;
-}
+    for (uint64_t i = 0; i < g->chunks_count; i++) {
+        chunk *c = g->chunks[i];
 
-void gamma_delete(gamma_t *g) {
-    if (g != NULL) {
+        for (uint64_t offset = 0; offset < chunk_size(g); offset++) {
+            uint32_t owner = c->fields[offset].player;
 
-        if (g->board != NULL) {
-            for (uint32_t i = 0; i < g->width; i++)
-                free(g->board[i]);
+            if (owner == 0)
+                continue;
 
-        }
+            field = chunk_field(g, c, offset);
 
-        free(g->board);
-        free(g->player_areas);
-        free(g->player_gold_move);
-        free(g->player_fields);
-        free_stack(g->stk);
-        free(g->visited);
-        free(g);
+            for (int direction = 0; direction < 4; direction++) {
+                if (neighbour_in_direction(g, 0, field, direction, &next) &&
+                    !index_set_insert(&g->frontiers[owner - 1],
+                                      field_index(g, next), next))
+                    return false;
+            }
+        }
     }
-}
 
-/** @brief Sprawdza poprawność pary współrzędnych.
- * Funkcja sprawdza czy dana para współrzędnych @p coordinates,
- * jest dobrze określona na planszy wskazywanej przez wskaźnik
- * @p g. Należy dbać o to, żeby argumenty były poprawne
- * @param[in] g             - wskaźnik na strukturę planszy
- * @param[in] coordinates   - para liczb nieujemnych opisująca położenie pola
- * @return Wartość @p true, jeżeli współrzędne są poprawne, (tzn. mieszczą
- * się na planszy), lub @p false w przeciwnym wypadku.
- */
-static bool check_coordinates(gamma_t *g, pair coordinates) {
-    uint32_t x = coordinates.fst;
-    uint32_t y = coordinates.snd;
+    g->frontiers_ok = true;
 
-    return (x < g->width && y < g->height);
+    return true;
 }
 
-/** @brief Sprawdza poprawność numeru gracza.
- * Funkcja sprawdza czy @p id poprawnie określa indeks gracza,
- * na planszy wskazywanej przez wskaźnik @p g.
- * Należy dbać o to, żeby argumenty były poprawne
- * @param[in] g             - wskaźnik na strukturę planszy
- * @param[in] id            - indeks gracza, liczba dodatnia
- * @return Wartość @p true, jeżeli indeks jest poprawny,
- * lub @p false w przeciwnym wypadku.
+/** @brief Zapewnia miejsce na stosie, w razie potrzeby go tworząc.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] size          - wymagana liczba elementów stosu
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
  */
-static bool check_player(gamma_t *g, uint32_t id) {
-    return id > 0 && id <= g->number_of_players;
+static bool reserve_stack(gamma_t *g, uint64_t size) {
+    if (g->stk == NULL)
+        g->stk = new_stack(STACK_INITIAL);
+
+    return g->stk != NULL && stack_reserve(g->stk, size);
 }
 
-/** @brief Sprawdza czy ruch jest poprawnie określony.
- * Funkcja sprawdza, czy gracz o indeksie @p player,
- * może wykonać ruch na planszy wskazywanej przez wskaźnik @p g
- * na miejsce o współrzędnych @p center.
- * Należy dbać o poprawność argumentów.
- * @param[in] g             - wskaźnik na strukturę planszy
- * @param[in] player        - indeks gracza, liczba dodatnia
- * @param[in] center        - para nieujemnych wspołrzędnych określająca pole
- * @return Wartość @p true, jezeli gracz może wykonać ruch
- * @p false w przeciwnym wypadku.
+/** @brief Przygotowuje pomocnicze struktury przejścia po obszarze.
+ * Rezerwuje miejsce na stosie i tworzy mapy odwiedzin kawałkom, które
+ * ich jeszcze nie mają. Dzięki temu samo przejście nie alokuje pamięci
+ * i nie może się nie udać w połowie.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] size          - wymagana liczba elementów stosu
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
  */
-static bool is_move_valid (gamma_t *g, uint32_t player, pair center) {
+static bool prepare_traversal(gamma_t *g, uint64_t size) {
+    uint64_t words = (chunk_size(g) + 63) / 64;
 
-    if ((!check_player(g, player) ||
-        !check_coordinates(g, center) ||
-        get_player(g, center) != 0) ||
-        (g->player_areas[player - 1] >= g->areas &&
-        !check_neighbours(g, player, center)))
+    if (!reserve_stack(g, size))
         return false;
 
+    for (; g->visited_chunks < g->chunks_count; g->visited_chunks++) {
+        chunk *c = g->chunks[g->visited_chunks];
+
+        c->visited = calloc(words, sizeof(uint64_t));
+        if (c->visited == NULL)
+            return false;
+    }
+
     return true;
 }
-/** @brief Sprawdza wstępnie czy złoty ruch jest poprawnie określony.
-* Funkcja wstępnie sprawdza, czy gracz o indeksie @p player,
-* może wykonać złoty ruch na planszy wskazywanej przez wskaźnik @p g
-* na miejsce o współrzędnych @p center.
-* Należy dbać o poprawność argumentów.
-* @param[in] g             - wskaźnik na strukturę planszy
-* @param[in] player        - indeks gracza, liczba dodatnia
-* @param[in] center        - para nieujemnych wspołrzędnych określająca pole
-* @return Wartość @p true, jezeli gracz może wykonać ruch,
- * lub @p false w przeciwnym wypadku.
-* (UWAGA: Funkcja nie sprawdza czy ruch ten rozspójni obszary co doprowadzi
-* ostatecznie do tego, że ruch ten będzie niemożliwy)
-*/
-static bool is_golden_move_valid (gamma_t *g, uint32_t player, pair center) {
 
-    if ((!check_player(g, player) ||
-         !check_coordinates(g, center)||
-         get_player(g, center) == 0) ||
-         (g->player_areas[player - 1] == g->areas &&
-         !check_neighbours(g, player, center)))
-        return false;
+/** @brief Wpisuje nowe kawałki do tablicy ich położeń.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool number_chunks(gamma_t *g) {
+    for (; g->slotted_chunks < g->chunks_count; g->slotted_chunks++) {
+        if (!hash_map_put(&g->chunk_slots, g->chunks[g->slotted_chunks]->id,
+                          g->slotted_chunks))
+            return false;
+    }
 
     return true;
 }
 
-bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    if (g == NULL)
+/** @brief Wylicza indeks pola według położenia jego kawałka.
+ * Pola kawałka o indeksie @p i w tablicy @p chunks mają kolejne indeksy
+ * od @p i razy liczba pól kawałka, więc tablice indeksowane tą funkcją mają
+ * rozmiar zależny od liczby utworzonych kawałków, a nie od rozmiaru planszy.
+ * Kawałek pola musi już być wpisany funkcją @ref number_chunks.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Indeks pola, liczba mniejsza od @p slotted_chunks razy liczba pól kawałka.
+ */
+static uint64_t slot_index(gamma_t *g, pair coordinates) {
+    uint64_t slot = 0;
+
+    hash_map_get(&g->chunk_slots, chunk_id(g, coordinates), &slot);
+
+    return slot * chunk_size(g) + chunk_offset(g, coordinates);
+}
+
+/** @brief Usuwa pamięć podręczną punktów artykulacji.
+ * Wywołujemy, gdy przy jej aktualizacji zabrakło pamięci.
+ * Zostanie odtworzona przy następnym zapytaniu.
+ * @param[in,out] g         - wskaźnik na planszę
+ */
+static void drop_splits(gamma_t *g) {
+    if (g->splits != NULL) {
+        block_tree_free(g->splits);
+        free(g->splits);
+        g->splits = NULL;
+    }
+}
+
+/** @brief Zapewnia wierzchołki drzewa bloków polom wszystkich kawałków.
+ * Przy niepowodzeniu usuwa pamięć podręczną.
+ * @param[in,out] g         - wskaźnik na planszę z zaalokowanym drzewem bloków
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool reserve_splits(gamma_t *g) {
+    if (!number_chunks(g) ||
+        !block_tree_grow(g->splits, g->slotted_chunks * chunk_size(g))) {
+        drop_splits(g);
         return false;
+    }
 
-    pair this_field = make_pair(x, y);
+    return true;
+}
 
-    if (!is_move_valid(g, player, this_field))
+/** @brief Odtwarza drzewo bloków jednego obszaru.
+ * Pierwszym przejściem oznacza wszystkie pola obszaru jako czekające
+ * na przebudowę. Drugim wstawia je w kolejności zdejmowania ze stosu,
+ * w której każde pole poza pierwszym sąsiaduje z jakimś wstawionym już polem.
+ * Dlatego pierwsza krawędź nowego pola łączy dwa drzewa, a każda kolejna
+ * zamyka cykl w jednym drzewie.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] player        - numer gracza, do którego należy obszar
+ * @param[in] seed          - para nieujemnych współrzędnych pola obszaru
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool rebuild_split_area(gamma_t *g, uint32_t player, pair seed) {
+    block_tree *tree = g->splits;
+    uint8_t *flags = tree->blocks_count;
+    stack *stk;
+    pair curr, next;
+    uint64_t c, n;
+    bool first;
+
+    if (!reserve_stack(g, g->player_fields[player - 1] + 1))
         return false;
 
-    g->player_fields[player - 1]++;
-    g->player_areas[player - 1]++;
+    stk = g->stk;
 
-    get_field(g, this_field)->player = player;
-    get_field(g, this_field)->parent = this_field;
+    block_tree_reset_vertex(tree, slot_index(g, seed));
+    flags[slot_index(g, seed)] = BLOCK_TREE_PENDING;
+    push(stk, seed);
 
-    union_neighbours(g, player, this_field, true);
+    while (!is_stack_empty(stk)) {
+        curr = pop(stk);
+
+        for (int direction = 0; direction < 4; direction++) {
+            if (!neighbour_in_direction(g, player, curr, direction, &next))
+                continue;
+
+            n = slot_index(g, next);
+
+            if (!(flags[n] & BLOCK_TREE_PENDING)) {
+                block_tree_reset_vertex(tree, n);
+                flags[n] = BLOCK_TREE_PENDING;
+                push(stk, next);
+            }
+        }
+    }
+
+    flags[slot_index(g, seed)] |= BLOCK_TREE_QUEUED;
+    push(stk, seed);
+
+    while (!is_stack_empty(stk)) {
+        curr = pop(stk);
+        c = slot_index(g, curr);
+        flags[c] = 0;
+        first = true;
+
+        for (int direction = 0; direction < 4; direction++) {
+            if (!neighbour_in_direction(g, player, curr, direction, &next))
+                continue;
+
+            n = slot_index(g, next);
+
+            if (!(flags[n] & BLOCK_TREE_PENDING)) {
+                if (!block_tree_add_edge(tree, c, n, !first)) {
+                    stk->top = 0;
+                    return false;
+                }
+                first = false;
+            }
+            else if (!(flags[n] & BLOCK_TREE_QUEUED)) {
+                flags[n] |= BLOCK_TREE_QUEUED;
+                push(stk, next);
+            }
+        }
+    }
 
     return true;
 }
 
-/** @brief Sprawdza, czy dane pole zostało już odwiedzone i odwiezda je.
- * Funkcja sprawdza, czy pole określone przez parę współrzędnych @p a,
- * zostało już odwiedzone (Czy wartość na pozycji @p a w tablicy bool @p arr,
- * jest true, czy false). Dodatkowo aktualizuje ją i zaznacza odwiedzone wartości.
- * Należy dbać o poprawność argumentów
- * @param[in,out] arr       - wskaźnik na pierwszą wartość w tablicy 2d
- * @param[in] height        - liczba wierszy tablicy, liczba dodatnia
- * @param[in] a             - para nieujemnych współrzędnych określająca pole
- * @return Wartość @p true, jeżeli pole nie zostało jescze odwiedzone
- * i zmienia wartość w tablicy na danym indeksie na true
- * W przeciwnym wypadku zwraca @p false.
+/** @brief Odtwarza całe drzewo bloków.
+ * Usuwa wszystkie bloki i przebudowuje po kolei każdy obszar, przeglądając
+ * tylko istniejące kawałki planszy. Przy niepowodzeniu usuwa pamięć podręczną.
+ * @param[in,out] g         - wskaźnik na planszę z zaalokowanym drzewem bloków
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
  */
-static bool check_and_visit (bool* arr, uint32_t height, pair a) {
-    if (!*(arr + height * a.fst + a.snd)) {
-        *(arr + height * a.fst + a.snd) = true;
+static bool rebuild_splits(gamma_t *g) {
+    uint64_t size = chunk_size(g);
+    uint32_t owner;
+
+    if (!reserve_splits(g))
         return false;
+
+    TRACE_BEGIN("rebuild_splits", NULL, 0);
+    block_tree_clear(g->splits);
+
+    /* Kawałek o indeksie i ma wierzchołki od i * size, zob. slot_index. */
+    for (uint64_t i = 0; i < g->chunks_count; i++) {
+        chunk *c = g->chunks[i];
+
+        for (uint64_t offset = 0; offset < size; offset++) {
+            owner = c->fields[offset].player;
+
+            if (owner != 0 &&
+                (g->splits->blocks_count[i * size + offset] & BLOCK_TREE_UNBUILT) &&
+                !rebuild_split_area(g, owner, chunk_field(g, c, offset))) {
+
+                drop_splits(g);
+                TRACE_END("rebuild_splits");
+                return false;
+            }
+        }
     }
+
+    TRACE_END("rebuild_splits");
     return true;
 }
 
-/** @brief Określa czy dane pole jest reprezentantem obszaru.
- * Funkcja sprawdza czy pole na planszy wskazywanej przez wskaźnik @p g
- * opisane parą współrzędnych @p coordinates, jest reprezentantem obszaru
- * do którego należy.
- * Należy dbać o poprawność argumentów funkcji.
- * @param[in] g             - wskaźnik na planszę
- * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
- * @return Wartość @p true, jeżeli dane pole jest reprezentantem obszaru,
- * do którego należy (korzeniem), lub @p false w przeciwnym wypadku.
+/** @brief Dodaje nowo zajęte pole do drzewa bloków.
+ * Wywołujemy po zajęciu pola, a przed połączeniem go z sąsiadami w strukturze
+ * FIND & UNION, dzięki czemu reprezentanci sąsiadów mówią, czy krawędź łączy
+ * dwa różne obszary, czy zamyka cykl. Gdy porzuconych bloków jest za dużo,
+ * zamiast tego odtwarzamy całe drzewo.
+ * @param[in,out] g         - wskaźnik na planszę z zaalokowanym drzewem bloków
+ * @param[in] player        - numer gracza, który zajął pole
+ * @param[in] field         - para nieujemnych współrzędnych zajętego pola
  */
-static bool is_his_own_parent(gamma_t *g, pair coordinates) {
-    if (compare_pairs (coordinates, find_ancestor(g, coordinates)))
-        return true;
+static void insert_split_vertex(gamma_t *g, uint32_t player, pair field) {
+    block_tree *tree = g->splits;
+    pair roots[4], next, root;
+    int linked = 0;
+    uint64_t v;
+    bool same;
+
+    /* Ruch mógł utworzyć nowy kawałek. */
+    if (!reserve_splits(g))
+        return;
+
+    v = slot_index(g, field);
+
+    if (tree->blocks > 4 * tree->vertices + 64) {
+        rebuild_splits(g);
+        return;
+    }
 
-    return false;
+    block_tree_reset_vertex(tree, v);
+
+    for (int direction = 0; direction < 4; direction++) {
+        if (!neighbour_in_direction(g, player, field, direction, &next))
+            continue;
+
+        root = find_ancestor(g, next);
+        same = false;
+
+        for (int i = 0; i < linked; i++) {
+            if (compare_pairs(roots[i], root) == 0)
+                same = true;
+        }
+
+        if (!block_tree_add_edge(tree, v, slot_index(g, next), same)) {
+            drop_splits(g);
+            return;
+        }
+        roots[linked++] = root;
+    }
 }
 
-/** @brief Przywraca pole do wartości bazowych.
- * Funkcja aktualizuje pole, znajdujące się na planszy wskazywanej przez @p g,
- * o parze współrzędnych @p a. Przwyraca je do wartości bazowych,
- * czyli usuwa numer gracza który je posiada, resetuje rangę pola i ustawia
- * je na swojego reprezentanta.
- * Należy dbać o poprawność argumentów funkcji.
- * @param[in,out] g         - wskaźnik na planszę
- * @param[in] a             - para nieujemnych współrzędnych opisująca położenie pola
+/** @brief Odtwarza drzewa bloków obszarów po usunięciu pola.
+ * Po złotym ruchu obszar dawnego właściciela pola mógł się rozpaść,
+ * więc przebudowujemy każdą z jego części, i tylko je.
+ * Funkcja wywołująca musi najpierw naprawić strukturę FIND & UNION.
+ * @param[in,out] g         - wskaźnik na planszę z zaalokowanym drzewem bloków
+ * @param[in] owner         - numer dawnego właściciela pola
+ * @param[in] field         - para nieujemnych współrzędnych zwolnionego pola
  */
-static void reset_field(gamma_t *g, pair a) {
-    square* this_field = get_field(g, a);
+static void rebuild_splits_around(gamma_t *g, uint32_t owner, pair field) {
+    pair roots[4], next, root;
+    int rebuilt = 0;
+    bool done;
 
-    this_field->player = 0;
-    this_field->parent = a;
-    this_field->rank = 0;
+    block_tree_reset_vertex(g->splits, slot_index(g, field));
+
+    for (int direction = 0; direction < 4; direction++) {
+        if (!neighbour_in_direction(g, owner, field, direction, &next))
+            continue;
+
+        root = find_ancestor(g, next);
+        done = false;
+
+        for (int i = 0; i < rebuilt; i++) {
+            if (compare_pairs(roots[i], root) == 0)
+                done = true;
+        }
+
+        if (!done) {
+            if (!rebuild_split_area(g, owner, next)) {
+                drop_splits(g);
+                return;
+            }
+            roots[rebuilt++] = root;
+        }
+    }
 }
 
-/** @brief Przywraca reprezentanta pola do wartości bazowych.
- * Funkcja aktualizuje pole, znajdujące się na planszy wskazywanej przez @p g,
- * o parze współrzędnych @p a. Ustawia to pole na swojego reprezentanta i
- * resetuje jego rangę. Zostawiając przy tym właściciela pola.
- * Należy dbać o poprawność argumentów funkcji.
- * @param[in,out] g         - wskaźnik na planszę
- * @param[in] a             - para nieujemnych współrzędnych opisująca położenie pola
+/** @brief Ustawia wszystkie wartości tablicy bool na false.
+ * Funkcja dla danej tablicy bool @p arr, i jej rozmiaru jako
+ * @p size. Ustawia jej wszystkie wartości na @p false. <br>
+ * Należy zwracać uwagę na poprawność przekazywanych argumentów.
+ * @param[in, out] arr    - wskaźnik na pierwszą wartość w tablicy
+ * @param[in] size        - rozmiar tablicy, liczba dodatnia.
  */
-static void reset_parent(gamma_t *g, pair a){
-    square* this_field = get_field(g, a);
+static void clear_bool_arr(bool* arr, uint64_t size) {
+    memset(arr, false, size * sizeof(bool));
+}
+/** @brief Sprawdza czy pamięć na planszę jest dobrze zaalokowana.
+ * Funkcja sprawdza czy plansza na którą wskazuje wskaźńik @p g, jest poprawna.
+ * Czyli czy udało się zaalokować wystarczającą ilosć pamięci.
+ * @param[in] g                 - wskaźnik na strukturę planszy
+ * @return Wartość logiczna @p true, gdy poprawnie zaalokowano pamięć.
+ * @p false w przeciwnym wypadku.
+ */
+static bool check_if_all_ok(gamma_t *g) {
+    if (g == NULL)
+        return false;
 
-    this_field->parent = a;
-    this_field->rank = 0;
+    if (g->player_fields == NULL ||
+        g->player_gold_move == NULL ||
+        g->player_areas == NULL ||
+        g->frontiers == NULL)
+        return false;
+
+    return true;
 }
 
-/** @brief Ustawia wszystkie pola na spójnym obszarze na swoich reprezentantów.
- * Funkcja zmienia reprezentantów każdego pola, na planszy którą wskazuje @p g,
- * które należy do spójnego obszaru (czyli należy do tego samego gracza)
- * wraz z polem o współrzędnych @p center. Zachowuje się jak BFS, zbiera
- * wszystkie sąsiadujące pola na stos, i po kolei resetuje reprezentantów
- * każdego z nich.
- * (Zatem każde pole na obszarze jest teraz swoim własnym reprezentantem)
- * @param[in,out] g          - wskaźnik na planszę
- * @param[in] player         - indeks gracza do którego należą pola na obszarze,
- *                             liczba dodatnia
- * @param[in] center         - para nieujemnych współrzędnych pola od którego
- *                             zaczniemy wywołania,
+/** @brief Dobiera bok kawałka planszy.
+ * @param[in] size          - długość boku planszy, liczba dodatnia
+ * @return Najmniejszy wykładnik @p k, dla którego 2^k jest niemniejsze od
+ * @p size, ale nie większy niż CHUNK_BITS.
  */
-static void reset_parents_area(gamma_t *g, uint32_t player, pair center) {
-    uint32_t width = g->width;
-    uint32_t height = g->height;
-    bool* visited;
-    stack *stk = g->stk;
-    pair curr;
+static uint8_t chunk_bits(uint32_t size) {
+    uint8_t out = 0;
 
-    clear_bool_arr(g->visited, width * height);
-    visited = g->visited;
-    push(stk, center);
+    while (out < CHUNK_BITS && ((uint64_t)1 << out) < size)
+        out++;
 
-    while (!is_stack_empty(stk)) {
-        curr = pop(stk);
+    return out;
+}
 
-        reset_parent(g, curr);
+/** @brief Podaje indeks pola planszy mieszczącej się w jednym kawałku.
+ * @param[in] x             - numer kolumny pola
+ * @param[in] y             - numer wiersza pola
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ * @return Indeks pola w tablicy pól kawałka, jak w @ref chunk_offset.
+ */
+static inline uint32_t fixed_offset(uint32_t x, uint32_t y, uint8_t bits) {
+    return MORTON_LAYOUT ? spread_bits(x) << 1 | spread_bits(y) : x << bits | y;
+}
 
-        if (is_north_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_north(curr))) {
+/** @brief Podaje indeks rodzica pola w strukturze FIND & UNION.
+ * @param[in] fields        - pola jedynego kawałka planszy
+ * @param[in] offset        - indeks pola
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ * @return Indeks rodzica pola.
+ */
+static inline uint32_t fixed_parent(square *fields, uint32_t offset, uint8_t bits) {
+    return fixed_offset(fields[offset].parent.fst, fields[offset].parent.snd, bits);
+}
 
-            push(stk, move_pair_north(curr));
-        }
-        if (is_south_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_south(curr))) {
+/** @brief Określa głównego rodzica pola, jak @ref find_ancestor.
+ * Najpierw idzie do korzenia, a potem podpina pod niego wszystkie pola
+ * z przebytej ścieżki.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in,out] fields    - pola jedynego kawałka planszy
+ * @param[in] offset        - indeks zajętego pola
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ * @return Indeks korzenia.
+ */
+static inline uint32_t fixed_find(gamma_t *g, square *fields, uint32_t offset,
+                                  uint8_t bits) {
+    uint32_t root = offset, parent;
 
-            push(stk, move_pair_south(curr));
-        }
-        if (is_west_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_west(curr))) {
+    /* Bez GAMMA_STATS plansza nie jest potrzebna. */
+    (void)g;
 
-            push(stk, move_pair_west(curr));
-        }
-        if (is_east_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_east(curr))) {
+    while ((parent = fixed_parent(fields, root, bits)) != root) {
+        root = parent;
+        STAT_ADD(g, find_hops, 1);
+    }
 
-            push(stk, move_pair_east(curr));
+    for (; offset != root; offset = parent) {
+        parent = fixed_parent(fields, offset, bits);
+
+        if (parent != root) {
+            remove_child(&fields[parent]);
+            add_child(&fields[root]);
+            fields[offset].parent = fields[root].parent;
+            STAT_ADD(g, path_writes, 1);
+        }
+    }
+
+    return root;
+}
+
+/** @brief Łączy obszary dwóch pól gracza, jak @ref union_fields.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in,out] fields    - pola jedynego kawałka planszy
+ * @param[in] x             - indeks pierwszego pola
+ * @param[in] y             - indeks drugiego pola, tego samego gracza
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ */
+static inline void fixed_union(gamma_t *g, square *fields, uint32_t x, uint32_t y,
+                               uint8_t bits) {
+    uint32_t a = fixed_find(g, fields, x, bits);
+    uint32_t b = fixed_find(g, fields, y, bits);
+
+    if (a == b)
+        return;
+
+    g->player_areas[fields[a].player - 1]--;
+    STAT_ADD(g, unions, 1);
+
+    if (fields[a].rank > fields[b].rank) {
+        fields[b].parent = fields[a].parent;
+        add_child(&fields[a]);
+    }
+    else {
+        fields[a].parent = fields[b].parent;
+        add_child(&fields[b]);
+
+        if (fields[a].rank == fields[b].rank)
+            fields[b].rank++;
+    }
+}
+
+/** @brief Aktualizuje pogranicza po zajęciu pola, jak @ref update_frontiers.
+ * Zajęte pole znika z pograniczy właścicieli sąsiadów, a wolni sąsiedzi
+ * trafiają do pogranicza gracza, który je zajął.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] fields        - pola jedynego kawałka planszy
+ * @param[in] player        - numer gracza, który zajął pole
+ * @param[in] x             - numer kolumny zajętego pola
+ * @param[in] y             - numer wiersza zajętego pola
+ * @param[in] size          - bok planszy
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ */
+static inline void fixed_frontiers(gamma_t *g, square *fields, uint32_t player,
+                                   uint32_t x, uint32_t y, uint32_t size, uint8_t bits) {
+    static const int dx[4] = {0, 0, 1, -1};
+    static const int dy[4] = {1, -1, 0, 0};
+    uint32_t nx, ny, owner;
+
+    for (int i = 0; i < 4 && g->frontiers_ok; i++) {
+        nx = x + dx[i];
+        ny = y + dy[i];
+
+        if (nx >= size || ny >= size)
+            continue;
+
+        owner = fields[fixed_offset(nx, ny, bits)].player;
+
+        if (owner != 0)
+            index_set_remove(&g->frontiers[owner - 1], (uint64_t)x * size + y);
+        else if (!index_set_insert(&g->frontiers[player - 1], (uint64_t)nx * size + ny,
+                                   make_pair(nx, ny)))
+            g->frontiers_ok = false;
+    }
+}
+
+/** @brief Wykonuje ruch na kwadratowej planszy mieszczącej się w jednym kawałku.
+ * Robi to samo co @ref move, ale bok planszy i kawałka są stałymi w miejscu
+ * wywołania, więc sprawdzanie granic i indeksy sąsiadów liczą się bez
+ * dzielenia i bez szukania kawałka w katalogu. Wklejamy ją zawsze, bo bez
+ * tego kompilator tworzy jedną wspólną wersję ze zmiennymi rozmiarami.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] player        - numer gracza
+ * @param[in] x             - numer kolumny
+ * @param[in] y             - numer wiersza
+ * @param[in] size          - bok planszy
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ * @return Wynik jak w funkcji @ref gamma_move.
+ */
+static inline __attribute__((always_inline))
+bool fixed_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y,
+                uint32_t size, uint8_t bits) {
+    static const int dx[4] = {0, 0, 1, -1};
+    static const int dy[4] = {1, -1, 0, 0};
+    uint32_t offset = fixed_offset(x, y, bits), nx, ny, near[4];
+    int same = 0;
+    square *fields;
+    chunk *c;
+
+    if (player == 0 || player > g->number_of_players || x >= size || y >= size)
+        return false;
+
+    c = g->directory[0];
+    if (c == NULL && (c = claim_chunk(g, 0)) == NULL)
+        return false;
+
+    fields = c->fields;
+
+    if (fields[offset].player != 0)
+        return false;
+
+    for (int i = 0; i < 4; i++) {
+        nx = x + dx[i];
+        ny = y + dy[i];
+
+        if (nx < size && ny < size &&
+            fields[fixed_offset(nx, ny, bits)].player == player)
+            near[same++] = fixed_offset(nx, ny, bits);
+    }
+
+    if (g->player_areas[player - 1] >= g->areas && same == 0)
+        return false;
+
+    g->player_fields[player - 1]++;
+    g->player_areas[player - 1]++;
+
+    fields[offset].player = player;
+    fields[offset].parent = make_pair(x, y);
+    g->hash ^= zobrist_key((uint64_t)x * size + y, player);
+
+    if (g->splits != NULL)
+        insert_split_vertex(g, player, make_pair(x, y));
+
+    for (int i = 0; i < same; i++)
+        fixed_union(g, fields, offset, near[i], bits);
+
+    fixed_frontiers(g, fields, player, x, y, size, bits);
+
+    return true;
+}
+
+/** @brief Podaje właściciela pola planszy mieszczącej się w jednym kawałku.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] x             - numer kolumny
+ * @param[in] y             - numer wiersza
+ * @param[in] size          - bok planszy
+ * @param[in] bits          - logarytm dwójkowy boku kwadratowego kawałka
+ * @return Wynik jak w funkcji @ref gamma_player.
+ */
+static inline uint32_t fixed_player(gamma_t *g, uint32_t x, uint32_t y,
+                                    uint32_t size, uint8_t bits) {
+    chunk *c = g->directory[0];
+
+    if (c == NULL || x >= size || y >= size)
+        return 0;
+
+    return c->fields[fixed_offset(x, y, bits)].player;
+}
+
+/** @brief Tworzy operacje silnika dla kwadratowej planszy o boku @p size.
+ * Plansza mieści się w jednym kawałku o boku 2^@p bits.
+ */
+#define FIXED_ENGINE(size, bits)                                                \
+    static bool fixed_move_##size(gamma_t *g, uint32_t player,                  \
+                                  uint32_t x, uint32_t y) {                     \
+        return fixed_move(g, player, x, y, size, bits);                         \
+    }                                                                           \
+    static uint32_t fixed_player_##size(gamma_t *g, uint32_t x, uint32_t y) {   \
+        return fixed_player(g, x, y, size, bits);                               \
+    }                                                                           \
+    static const engine_ops fixed_ops_##size = {fixed_move_##size, fixed_player_##size};
+
+FIXED_ENGINE(8, 3)
+FIXED_ENGINE(19, 5)
+FIXED_ENGINE(64, 6)
+
+/** @brief Dobiera wyspecjalizowane operacje silnika do rozmiaru planszy.
+ * @param[in] width         - liczba kolumn planszy
+ * @param[in] height        - liczba wierszy planszy
+ * @return Operacje dla planszy tego rozmiaru albo NULL, gdy plansza
+ * używa ogólnego silnika.
+ */
+static const engine_ops* fixed_engine(uint32_t width, uint32_t height) {
+    if (!FIXED_ENGINES || width != height)
+        return NULL;
+
+    switch (width) {
+        case 8: return &fixed_ops_8;
+        case 19: return &fixed_ops_19;
+        case 64: return &fixed_ops_64;
+        default: return NULL;
+    }
+}
+
+gamma_t* gamma_new(uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas) {
+    if (width < 1 || height < 1 || players < 1 || areas < 1)
+        return NULL;
+
+    gamma_t* new_object = (gamma_t *)malloc(sizeof(gamma_t));
+    uint64_t chunks;
+
+    if (new_object == NULL)
+        return NULL;
+
+    new_object->ops = fixed_engine(width, height);
+    new_object->chunk_bits_x = chunk_bits(width);
+    new_object->chunk_bits_y = chunk_bits(height);
+    new_object->chunk_mask_x = (1u << new_object->chunk_bits_x) - 1;
+    new_object->chunk_mask_y = (1u << new_object->chunk_bits_y) - 1;
+    new_object->column_bits = 0;
+
+    while (((uint64_t)1 << new_object->column_bits) <
+           ((uint64_t)(height - 1) >> new_object->chunk_bits_y) + 1)
+        new_object->column_bits++;
+
+    chunks = (((uint64_t)(width - 1) >> new_object->chunk_bits_x) + 1) <<
+             new_object->column_bits;
+
+    new_object->directory = NULL;
+    new_object->chunks = NULL;
+    new_object->chunks_count = 0;
+    new_object->chunks_capacity = 0;
+    new_object->mapping = NULL;
+    new_object->mapping_size = 0;
+    new_object->epoch = 0;
+    atomic_init(&new_object->sequence, 0);
+    hash_map_init(&new_object->chunk_map);
+    hash_map_share(&new_object->chunk_map);
+    hash_map_init(&new_object->chunk_slots);
+    new_object->slotted_chunks = 0;
+
+    /* Katalog tablicowy jest szybszy, ale dla ogromnych plansz zająłby
+     * więcej pamięci niż same zajęte pola. */
+    if (chunks <= DENSE_DIRECTORY_MAX) {
+        new_object->directory = calloc(chunks, sizeof(chunk *));
+
+        if (new_object->directory == NULL) {
+            free(new_object);
+            return NULL;
+        }
+    }
+
+    new_object->player_areas = calloc(players, sizeof(uint32_t));
+    new_object->player_fields = calloc(players, sizeof(uint64_t));
+
+    new_object->player_gold_move = calloc(players, sizeof(bool));
+    clear_bool_arr(new_object->player_gold_move, players);
+
+    new_object->number_of_players = players;
+
+    new_object->areas = areas;
+    new_object->width = width;
+    new_object->height = height;
+
+    new_object->stk = NULL;
+    new_object->visited_chunks = 0;
+
+    new_object->frontiers = calloc(players, sizeof(index_set));
+    new_object->frontiers_ok = true;
+    new_object->splits = NULL;
+    new_object->hash = 0;
+    new_object->locks = NULL;
+#ifdef GAMMA_STATS
+    memset(&new_object->stats, 0, sizeof(gamma_counters));
+#endif
+
+    if (new_object->frontiers != NULL) {
+        /* Pogranicza plansz z wyspecjalizowanym silnikiem trzymają pozycje
+         * pól w tablicach rozmiaru planszy, mieszczących się w pamięci L1. */
+        for (uint32_t i = 0; i < players; i++) {
+            if (new_object->ops != NULL)
+                index_set_init_dense(&new_object->frontiers[i], (uint64_t)width * height);
+            else
+                index_set_init(&new_object->frontiers[i]);
+        }
+    }
+
+    if (!check_if_all_ok(new_object)){
+        gamma_delete(new_object);
+        return NULL;
+    }
+
+    return new_object;
+}
+
+void gamma_delete(gamma_t *g) {
+    if (g != NULL) {
+        gamma_concurrent_end(g);
+
+        for (uint64_t i = 0; i < g->chunks_count; i++) {
+            free(g->chunks[i]->visited);
+
+            if (!in_mapping(g, g->chunks[i]))
+                free(g->chunks[i]);
+        }
+
+        if (g->mapping != NULL)
+            munmap(g->mapping, g->mapping_size);
+
+        if (g->frontiers != NULL) {
+            for (uint32_t i = 0; i < g->number_of_players; i++)
+                index_set_free(&g->frontiers[i]);
+        }
+
+        drop_splits(g);
+        free(g->chunks);
+        free(g->directory);
+        hash_map_free(&g->chunk_map);
+        hash_map_free(&g->chunk_slots);
+        free(g->frontiers);
+        free(g->player_areas);
+        free(g->player_gold_move);
+        free(g->player_fields);
+        free_stack(g->stk);
+        free(g);
+    }
+}
+
+/** @brief Zaczyna zmianę stanu gry widocznego dla czytelników.
+ * Stan gry zmienia tylko jeden wątek, więc licznik zwiększamy bez operacji
+ * atomowej odczyt-zapis. Bariera sprawia, że czytelnik, który zobaczy
+ * którykolwiek z późniejszych zapisów, zobaczy też nieparzysty licznik.
+ * @param[in,out] g         - wskaźnik na planszę
+ */
+static void write_begin(gamma_t *g) {
+    uint64_t sequence = atomic_load_explicit(&g->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&g->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/** @brief Kończy zmianę stanu gry zaczętą funkcją @ref write_begin.
+ * @param[in,out] g         - wskaźnik na planszę
+ */
+static void write_end(gamma_t *g) {
+    uint64_t sequence = atomic_load_explicit(&g->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&g->sequence, sequence + 1, memory_order_release);
+}
+
+void gamma_reset(gamma_t *g) {
+    if (g == NULL)
+        return;
+
+    write_begin(g);
+
+    /* Utworzone kawałki zostawiamy, bo kolejna rozgrywka pewnie ich użyje. */
+    for (uint64_t i = 0; i < g->chunks_count; i++)
+        memset(g->chunks[i]->fields, 0, chunk_size(g) * sizeof(square));
+
+    memset(g->player_areas, 0, g->number_of_players * sizeof(uint32_t));
+    memset(g->player_fields, 0, g->number_of_players * sizeof(uint64_t));
+    clear_bool_arr(g->player_gold_move, g->number_of_players);
+
+    STAT_ADD(g, memset_bytes, g->chunks_count * chunk_size(g) * sizeof(square) +
+             g->number_of_players * (sizeof(uint32_t) + sizeof(uint64_t) + sizeof(bool)));
+
+    for (uint32_t i = 0; i < g->number_of_players; i++)
+        index_set_clear(&g->frontiers[i]);
+
+    g->frontiers_ok = true;
+    g->hash = 0;
+    drop_splits(g);
+    write_end(g);
+}
+
+gamma_t* gamma_reuse(gamma_t *g, uint32_t width, uint32_t height,
+                     uint32_t players, uint32_t areas) {
+    if (g != NULL && areas >= 1 && g->width == width && g->height == height &&
+        g->number_of_players == players) {
+        gamma_reset(g);
+        gamma_stats_reset(g);
+        g->areas = areas;
+
+        return g;
+    }
+
+    gamma_delete(g);
+
+    return gamma_new(width, height, players, areas);
+}
+
+bool gamma_copy_into(gamma_t *dst, gamma_t *src) {
+    if (dst == NULL || src == NULL || dst->width != src->width ||
+        dst->height != src->height ||
+        dst->number_of_players != src->number_of_players)
+        return false;
+
+    bool out = true;
+
+    write_begin(dst);
+
+    /* Kawałki, których nie ma w źródle, są w nim puste. */
+    for (uint64_t i = 0; i < dst->chunks_count; i++) {
+        if (find_chunk(src, dst->chunks[i]->id) == NULL)
+            memset(dst->chunks[i]->fields, 0, chunk_size(dst) * sizeof(square));
+    }
+
+    for (uint64_t i = 0; i < src->chunks_count && out; i++) {
+        chunk *from = src->chunks[i];
+        chunk *to = claim_chunk(dst, from->id);
+
+        if (to == NULL)
+            out = false;
+        else
+            memcpy(to->fields, from->fields, chunk_size(src) * sizeof(square));
+    }
+
+    if (!out) {
+        write_end(dst);
+        return false;
+    }
+
+    memcpy(dst->player_areas, src->player_areas,
+           src->number_of_players * sizeof(uint32_t));
+    memcpy(dst->player_fields, src->player_fields,
+           src->number_of_players * sizeof(uint64_t));
+    memcpy(dst->player_gold_move, src->player_gold_move,
+           src->number_of_players * sizeof(bool));
+
+    dst->areas = src->areas;
+    dst->hash = src->hash;
+    dst->frontiers_ok = src->frontiers_ok;
+
+    for (uint32_t i = 0; i < src->number_of_players && dst->frontiers_ok; i++) {
+        if (!index_set_copy(&dst->frontiers[i], &src->frontiers[i]))
+            dst->frontiers_ok = false;
+    }
+
+    drop_splits(dst);
+    write_end(dst);
+
+    return true;
+}
+
+gamma_t* gamma_copy(gamma_t *g) {
+    if (g == NULL)
+        return NULL;
+
+    gamma_t *out = gamma_new(g->width, g->height, g->number_of_players, g->areas);
+
+    if (out != NULL && !gamma_copy_into(out, g)) {
+        gamma_delete(out);
+        return NULL;
+    }
+
+    return out;
+}
+
+/** @brief Sprawdza poprawność pary współrzędnych.
+ * Funkcja sprawdza czy dana para współrzędnych @p coordinates,
+ * jest dobrze określona na planszy wskazywanej przez wskaźnik
+ * @p g. Należy dbać o to, żeby argumenty były poprawne
+ * @param[in] g             - wskaźnik na strukturę planszy
+ * @param[in] coordinates   - para liczb nieujemnych opisująca położenie pola
+ * @return Wartość @p true, jeżeli współrzędne są poprawne, (tzn. mieszczą
+ * się na planszy), lub @p false w przeciwnym wypadku.
+ */
+static bool check_coordinates(gamma_t *g, pair coordinates) {
+    uint32_t x = coordinates.fst;
+    uint32_t y = coordinates.snd;
+
+    return (x < g->width && y < g->height);
+}
+
+/** @brief Sprawdza poprawność numeru gracza.
+ * Funkcja sprawdza czy @p id poprawnie określa indeks gracza,
+ * na planszy wskazywanej przez wskaźnik @p g.
+ * Należy dbać o to, żeby argumenty były poprawne
+ * @param[in] g             - wskaźnik na strukturę planszy
+ * @param[in] id            - indeks gracza, liczba dodatnia
+ * @return Wartość @p true, jeżeli indeks jest poprawny,
+ * lub @p false w przeciwnym wypadku.
+ */
+static bool check_player(gamma_t *g, uint32_t id) {
+    return id > 0 && id <= g->number_of_players;
+}
+
+/** @brief Sprawdza czy ruch jest poprawnie określony.
+ * Funkcja sprawdza, czy gracz o indeksie @p player,
+ * może wykonać ruch na planszy wskazywanej przez wskaźnik @p g
+ * na miejsce o współrzędnych @p center.
+ * Należy dbać o poprawność argumentów.
+ * @param[in] g             - wskaźnik na strukturę planszy
+ * @param[in] player        - indeks gracza, liczba dodatnia
+ * @param[in] center        - para nieujemnych wspołrzędnych określająca pole
+ * @return Wartość @p true, jezeli gracz może wykonać ruch
+ * @p false w przeciwnym wypadku.
+ */
+static bool is_move_valid (gamma_t *g, uint32_t player, pair center) {
+
+    if ((!check_player(g, player) ||
+        !check_coordinates(g, center) ||
+        get_player(g, center) != 0) ||
+        (g->player_areas[player - 1] >= g->areas &&
+        !check_neighbours(g, player, center)))
+        return false;
+
+    return true;
+}
+/** @brief Sprawdza wstępnie czy złoty ruch jest poprawnie określony.
+* Funkcja wstępnie sprawdza, czy gracz o indeksie @p player,
+* może wykonać złoty ruch na planszy wskazywanej przez wskaźnik @p g
+* na miejsce o współrzędnych @p center.
+* Należy dbać o poprawność argumentów.
+* @param[in] g             - wskaźnik na strukturę planszy
+* @param[in] player        - indeks gracza, liczba dodatnia
+* @param[in] center        - para nieujemnych wspołrzędnych określająca pole
+* @return Wartość @p true, jezeli gracz może wykonać ruch,
+ * lub @p false w przeciwnym wypadku.
+* (UWAGA: Funkcja nie sprawdza czy ruch ten rozspójni obszary co doprowadzi
+* ostatecznie do tego, że ruch ten będzie niemożliwy)
+*/
+static bool is_golden_move_valid (gamma_t *g, uint32_t player, pair center) {
+
+    if ((!check_player(g, player) ||
+         !check_coordinates(g, center)||
+         get_player(g, center) == 0) ||
+         (g->player_areas[player - 1] == g->areas &&
+         !check_neighbours(g, player, center)))
+        return false;
+
+    return true;
+}
+
+/** @brief Wykonuje ruch, bez zapisywania zdarzeń śledzenia.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Wynik jak w funkcji @ref gamma_move.
+ */
+static bool move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (g == NULL)
+        return false;
+
+    pair this_field = make_pair(x, y);
+    square *field;
+    chunk *c;
+
+    if (!is_move_valid(g, player, this_field))
+        return false;
+
+    c = claim_chunk(g, chunk_id(g, this_field));
+    if (c == NULL)
+        return false;
+
+    g->player_fields[player - 1]++;
+    g->player_areas[player - 1]++;
+
+    field = &c->fields[chunk_offset(g, this_field)];
+    field->player = player;
+    field->parent = this_field;
+    g->hash ^= zobrist_field(g, this_field, player);
+
+    if (g->splits != NULL)
+        insert_split_vertex(g, player, this_field);
+
+    union_neighbours(g, player, this_field, true);
+    update_frontiers(g, this_field, 0, player);
+
+    return true;
+}
+
+/** @brief Wykonuje ruch silnikiem planszy, bez licznika zmian i śledzenia.
+ * Używana wewnątrz innych zmian stanu gry, żeby licznik zmian nie stał się
+ * parzysty w ich trakcie.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Wynik jak w funkcji @ref gamma_move.
+ */
+static bool engine_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    return g->ops != NULL ? g->ops->move(g, player, x, y) : move(g, player, x, y);
+}
+
+bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    bool out;
+
+    if (g == NULL)
+        return false;
+
+    TRACE_BEGIN("gamma_move", "player", player);
+    write_begin(g);
+    out = engine_move(g, player, x, y);
+    write_end(g);
+    TRACE_END("gamma_move");
+
+    return out;
+}
+
+/** @brief Sprawdza, czy dane pole zostało już odwiedzone i odwiezda je.
+ * Funkcja sprawdza, czy zajęte pole określone przez parę współrzędnych @p a,
+ * zostało już odwiedzone w bieżącym przejściu (numer @p epoch planszy).
+ * Dodatkowo zaznacza je jako odwiedzone. Znaczniki kawałka z wcześniejszego
+ * przejścia czyścimy przy pierwszym odwiedzeniu w nowym przejściu.
+ * Należy dbać o poprawność argumentów
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] a             - para nieujemnych współrzędnych określająca pole
+ * @return Wartość @p false, jeżeli pole nie zostało jescze odwiedzone,
+ * a @p true w przeciwnym wypadku.
+ */
+static bool check_and_visit(gamma_t *g, pair a) {
+    chunk *c = find_chunk(g, chunk_id(g, a));
+    uint64_t i = chunk_offset(g, a);
+    uint64_t bit = (uint64_t)1 << (i % 64);
+
+    if (c->epoch != g->epoch) {
+        memset(c->visited, 0, (chunk_size(g) + 63) / 64 * sizeof(uint64_t));
+        STAT_ADD(g, memset_bytes, (chunk_size(g) + 63) / 64 * sizeof(uint64_t));
+        c->epoch = g->epoch;
+    }
+
+    if (c->visited[i / 64] & bit)
+        return true;
+
+    c->visited[i / 64] |= bit;
+
+    return false;
+}
+
+/** @brief Określa czy dane pole jest reprezentantem obszaru.
+ * Funkcja sprawdza czy pole na planszy wskazywanej przez wskaźnik @p g
+ * opisane parą współrzędnych @p coordinates, jest reprezentantem obszaru
+ * do którego należy.
+ * Należy dbać o poprawność argumentów funkcji.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] coordinates   - para nieujemnych współrzędnych opisująca położenie pola
+ * @return Wartość @p true, jeżeli dane pole jest reprezentantem obszaru,
+ * do którego należy (korzeniem), lub @p false w przeciwnym wypadku.
+ */
+static bool is_his_own_parent(gamma_t *g, pair coordinates) {
+    if (compare_pairs (coordinates, find_ancestor(g, coordinates)))
+        return true;
+
+    return false;
+}
+
+/** @brief Przywraca pole do wartości bazowych.
+ * Funkcja aktualizuje pole, znajdujące się na planszy wskazywanej przez @p g,
+ * o parze współrzędnych @p a. Przwyraca je do wartości bazowych,
+ * czyli usuwa numer gracza który je posiada, resetuje rangę pola i ustawia
+ * je na swojego reprezentanta.
+ * Należy dbać o poprawność argumentów funkcji.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] a             - para nieujemnych współrzędnych opisująca położenie pola
+ */
+static void reset_field(gamma_t *g, pair a) {
+    square* this_field = get_field(g, a);
+
+    if (this_field->player != 0)
+        g->hash ^= zobrist_field(g, a, this_field->player);
+
+    this_field->player = 0;
+    this_field->parent = a;
+    this_field->rank = 0;
+    this_field->children = 0;
+}
+
+/** @brief Przywraca reprezentanta pola do wartości bazowych.
+ * Funkcja aktualizuje pole, znajdujące się na planszy wskazywanej przez @p g,
+ * o parze współrzędnych @p a. Ustawia to pole na swojego reprezentanta i
+ * resetuje jego rangę oraz licznik dzieci. Zostawiając przy tym właściciela pola.
+ * Resetujemy tak wszystkie pola obszaru, więc żadne z nich nie ma potem dzieci.
+ * Należy dbać o poprawność argumentów funkcji.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] a             - para nieujemnych współrzędnych opisująca położenie pola
+ */
+static void reset_parent(gamma_t *g, pair a){
+    square* this_field = get_field(g, a);
+
+    this_field->parent = a;
+    this_field->rank = 0;
+    this_field->children = 0;
+}
+
+/** @brief Ustawia wszystkie pola na spójnym obszarze na swoich reprezentantów.
+ * Funkcja zmienia reprezentantów każdego pola, na planszy którą wskazuje @p g,
+ * które należy do spójnego obszaru (czyli należy do tego samego gracza)
+ * wraz z polem o współrzędnych @p center. Zachowuje się jak BFS, zbiera
+ * wszystkie sąsiadujące pola na stos, i po kolei resetuje reprezentantów
+ * każdego z nich.
+ * (Zatem każde pole na obszarze jest teraz swoim własnym reprezentantem)
+ * @param[in,out] g          - wskaźnik na planszę
+ * @param[in] player         - indeks gracza do którego należą pola na obszarze,
+ *                             liczba dodatnia
+ * @param[in] center         - para nieujemnych współrzędnych pola od którego
+ *                             zaczniemy wywołania,
+ */
+static void reset_parents_area(gamma_t *g, uint32_t player, pair center) {
+    stack *stk = g->stk;
+    pair curr;
+
+    g->epoch++;
+    push(stk, center);
+
+    while (!is_stack_empty(stk)) {
+        curr = pop(stk);
+
+        reset_parent(g, curr);
+        STAT_ADD(g, reset_cells, 1);
+
+        if (is_north_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_north(curr))) {
+
+            push(stk, move_pair_north(curr));
+        }
+        if (is_south_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_south(curr))) {
+
+            push(stk, move_pair_south(curr));
+        }
+        if (is_west_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_west(curr))) {
+
+            push(stk, move_pair_west(curr));
+        }
+        if (is_east_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_east(curr))) {
+
+            push(stk, move_pair_east(curr));
         }
     }
 }
@@ -699,306 +2186,1763 @@ static void reset_parents_area(gamma_t *g, uint32_t player, pair center) {
  * @param[in] central        - para nieujemnych współrzędnych pola od którego
  *                             zaczniemy wywołania,
  */
-static void update_unions_on_area(gamma_t *g, uint32_t player, pair central) {
-    uint32_t height = g->height;
+static void update_unions_on_area(gamma_t *g, uint32_t player, pair central) {
+    stack *stk = g->stk;
+    pair curr;
+
+    g->epoch++;
+    push(stk, central);
+
+    while (!is_stack_empty(stk)) {
+        curr = pop(stk);
+
+        union_fields(g, central, curr, false);
+        STAT_ADD(g, union_cells, 1);
+
+        if (is_north_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_north(curr))) {
+
+            push(stk, move_pair_north(curr));
+        }
+        if (is_south_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_south(curr))) {
+
+            push(stk, move_pair_south(curr));
+        }
+        if (is_west_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_west(curr))) {
+
+            push(stk, move_pair_west(curr));
+        }
+        if (is_east_valid(g, player, curr) &&
+            !check_and_visit(g, move_pair_east(curr))) {
+
+            push(stk, move_pair_east(curr));
+        }
+    }
+}
+
+/** @brief Łączy kolejne spójne obszary sąsiadów i liczy ile było takich rozłącznych.
+ * Funkcja łączy na nowo, zresetowane już obszary sąsiadujące z polem @p central,
+ * które należą do gracza o indeksie @p player. Przy tym sprawdza ilu sąsiadów tego
+ * pola jest rozłącznych
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] player        - numer indeksu gracza do którego należy pole
+ *                            liczba dodatnia
+ * @param[in] central       - para nieujemnych współrzędnych określających
+ *                            położenie pola
+ * @return Liczbę rozłącznych obszarów które powstaną po usunięciu danego pola.
+ */
+static int update_neighbours_and_count_them(gamma_t *g, uint32_t player, pair central) {
+    int out = 0;
+
+    if (is_north_valid(g, player, central) &&
+        !is_his_own_parent(g, move_pair_north(central))) {
+
+        out++;
+        update_unions_on_area(g, player, move_pair_north(central));
+    }
+    if (is_south_valid(g, player, central) &&
+        !is_his_own_parent(g, move_pair_south(central))) {
+
+        out++;
+        update_unions_on_area(g, player, move_pair_south(central));
+    }
+    if (is_west_valid(g, player, central) &&
+        !is_his_own_parent(g, move_pair_west(central))) {
+
+        out++;
+        update_unions_on_area(g, player, move_pair_west(central));
+    }
+    if (is_east_valid(g, player, central) &&
+        !is_his_own_parent(g, move_pair_east(central))) {
+
+        out++;
+        update_unions_on_area(g, player, move_pair_east(central));
+    }
+
+    return out;
+}
+
+/** @brief Sprawdza, czy pole leży na planszy i należy do gracza.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] player        - numer gracza, liczba dodatnia
+ * @param[in] x             - numer kolumny pola, może wychodzić poza planszę
+ * @param[in] y             - numer wiersza pola, może wychodzić poza planszę
+ * @return Wartość @p true, jeżeli pole leży na planszy i należy do gracza.
+ */
+static bool owned_at(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    return x < g->width && y < g->height && player_at(g, x, y) == player;
+}
+
+/** @brief Sprawdza w stałym czasie, czy usunięcie pola na pewno nie rozspójni obszaru.
+ * Przegląda osiem pól otaczających pole @p center w kolejności obiegu,
+ * w której kolejne pola sąsiadują ze sobą bokiem. Obszar się nie rozpadnie,
+ * jeżeli wszyscy sąsiedzi pola należący do właściciela leżą w jednej serii
+ * jego pól na tym obiegu (jak w testach punktów prostych w topologii
+ * cyfrowej). Narożnik bez takiego sąsiada obok nie łączy niczego.
+ * Gdy obieg nie rozstrzyga, obszar może się rozpaść i trzeba go przebudować.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] owner         - numer właściciela pola, liczba dodatnia
+ * @param[in] center        - para nieujemnych współrzędnych pola
+ * @param[out] neighbours   - liczba sąsiadów pola należących do właściciela
+ * @return Wartość @p true, jeżeli po usunięciu pola jego sąsiedzi należący
+ * do właściciela nadal są w jednym obszarze.
+ */
+static bool removal_keeps_area(gamma_t *g, uint32_t owner, pair center,
+                               int *neighbours) {
+    static const int dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int dy[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    unsigned ring = 0, starts = 0;
+
+    *neighbours = 0;
+
+    for (int i = 0; i < 8; i++) {
+        if (owned_at(g, owner, center.fst + dx[i], center.snd + dy[i])) {
+            ring |= 1u << i;
+            /* Sąsiedzi bokiem mają parzyste pozycje na obiegu. */
+            *neighbours += i % 2 == 0;
+        }
+    }
+
+    if (*neighbours <= 1)
+        return true;
+
+    for (int i = 1; i < 8; i += 2) {
+        if (!(ring & (1u << (i - 1))) && !(ring & (1u << ((i + 1) % 8))))
+            ring &= ~(1u << i);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        if ((ring & (1u << i)) && !(ring & (1u << ((i + 7) % 8))))
+            starts++;
+    }
+
+    /* Pełny obieg nie ma początku serii. */
+    return starts <= 1;
+}
+
+/** @brief Usuwa pole bez przebudowy obszaru właściciela.
+ * Wymaga, żeby żadne pole nie miało usuwanego pola za rodzica, i żeby
+ * funkcja @ref removal_keeps_area potwierdziła, że obszar się nie rozpadnie.
+ * Wtedy pozostałe pola obszaru zachowują swoich reprezentantów, a liczba
+ * obszarów właściciela zmniejsza się tylko, gdy pole nie miało sąsiadów.
+ * @param[in,out] g         - wskaźnik na planszę
+ * @param[in] owner         - numer właściciela pola, liczba dodatnia
+ * @param[in] center        - para nieujemnych współrzędnych pola
+ * @param[in] neighbours    - liczba sąsiadów pola należących do właściciela
+ */
+static void remove_leaf(gamma_t *g, uint32_t owner, pair center, int neighbours) {
+    square *field = get_field(g, center);
+
+    if (compare_pairs(field->parent, center) != 0)
+        remove_child(get_field(g, field->parent));
+
+    reset_field(g, center);
+    update_frontiers(g, center, owner, 0);
+
+    if (neighbours == 0)
+        g->player_areas[owner - 1]--;
+
+    STAT_ADD(g, golden_local, 1);
+}
+
+/** @brief Wykonuje złoty ruch, bez zapisywania zdarzeń śledzenia.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Wynik jak w funkcji @ref gamma_golden_move.
+ */
+static bool golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    int field_owner, neighbours;
+    pair this_field = make_pair(x, y);
+    bool local;
+
+    if (g == NULL)
+        return false;
+
+    if (!is_golden_move_valid(g, player, this_field) ||
+        !gamma_golden_possible(g, player) ||
+        get_player(g, this_field) == player){
+
+        STAT_ADD(g, golden_rejected, 1);
+        return false;
+    }
+
+    field_owner = get_player(g, this_field);
+    local = get_field(g, this_field)->children == 0 &&
+            removal_keeps_area(g, field_owner, this_field, &neighbours);
+
+    /* Przejścia po obszarze właściciela wrzucają na stos każde jego pole
+     * co najwyżej raz, a pole startowe najwyżej dwa razy. */
+    if ((!local || g->splits != NULL) &&
+        !prepare_traversal(g, g->player_fields[field_owner - 1] + 2)) {
+        STAT_ADD(g, golden_rejected, 1);
+        return false;
+    }
+
+    /* Z pamięci podręcznej od razu wiemy, czy obszar właściciela
+     * nie rozpadnie się na zbyt wiele części. */
+    if (g->splits != NULL &&
+        (uint64_t)g->player_areas[field_owner - 1] - 1 +
+        block_tree_parts(g->splits, slot_index(g, this_field)) > g->areas) {
+
+        STAT_ADD(g, golden_rejected, 1);
+        return false;
+    }
+
+    if (local) {
+        remove_leaf(g, field_owner, this_field, neighbours);
+    }
+    else {
+        reset_parents_area(g, field_owner, this_field);
+        reset_field(g, this_field);
+        update_frontiers(g, this_field, field_owner, 0);
+
+        g->player_areas[field_owner - 1] +=
+                update_neighbours_and_count_them(g, field_owner, this_field) - 1;
+    }
+
+    if (g->splits != NULL)
+        rebuild_splits_around(g, field_owner, this_field);
+
+    g->player_fields[field_owner - 1]--;
+
+    if (g->player_areas[field_owner - 1] > g->areas ||
+        !engine_move(g, player, x, y)) {
+
+        engine_move(g, field_owner, x, y);
+        STAT_ADD(g, golden_rejected, 1);
+        STAT_ADD(g, golden_rollbacks, 1);
+        return false;
+    }
+
+    g->player_gold_move[player - 1] = true;
+    g->hash ^= zobrist_gold(player);
+
+    return true;
+}
+
+bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    bool out;
+
+    if (g == NULL)
+        return false;
+
+    TRACE_BEGIN("gamma_golden_move", "player", player);
+    write_begin(g);
+    out = golden_move(g, player, x, y);
+    write_end(g);
+    TRACE_END("gamma_golden_move");
+
+    return out;
+}
+
+/** @brief Liczy, na ile części rozpadnie się obszar po usunięciu każdego pola.
+ * Przechodzi DFS-em (iteracyjnie, w stylu algorytmu Tarjana) obszary wszystkich
+ * graczy poza @p skip i wyznacza punkty artykulacji. Dla pola @p v zapisuje
+ * w @p parts liczbę obszarów, na które rozpadnie się jego obszar po usunięciu
+ * @p v. Dla korzenia DFS-a to liczba jego dzieci, dla pozostałych pól jeden
+ * plus liczba dzieci @p u, dla których low[u] >= disc[v]. <br>
+ * Korzeni szuka tylko w istniejących kawałkach, a tablice pomocnicze indeksuje
+ * funkcją @ref slot_index, więc czas i pamięć zależą od liczby utworzonych
+ * kawałków, a nie od rozmiaru planszy.
+ * @param[in] g             - wskaźnik na planszę z kawałkami wpisanymi
+ *                            funkcją @ref number_chunks
+ * @param[in] skip          - numer gracza, którego pól nie przeglądamy
+ * @param[out] parts        - tablica o rozmiarze @p slotted_chunks razy liczba
+ *                            pól kawałka, indeksowana funkcją @ref slot_index
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool count_parts_after_removal(gamma_t *g, uint32_t skip, uint8_t *parts) {
+    uint64_t size = chunk_size(g), vertices = g->slotted_chunks * size;
+    uint64_t occupied = 0, time = 0, top;
+    uint64_t *disc, *low;
+    uint8_t *next_direction;
+    pair *dfs;
+    pair curr, next;
+    uint32_t owner;
+
+    for (uint32_t i = 0; i < g->number_of_players; i++) {
+        if (i != skip - 1)
+            occupied += g->player_fields[i];
+    }
+
+    disc = calloc(vertices, sizeof(uint64_t));
+    low = malloc_array(vertices, sizeof(uint64_t));
+    next_direction = calloc(vertices, sizeof(uint8_t));
+    dfs = malloc_array(occupied + 1, sizeof(pair));
+
+    if (disc == NULL || low == NULL || next_direction == NULL || dfs == NULL) {
+        free(disc);
+        free(low);
+        free(next_direction);
+        free(dfs);
+        return false;
+    }
+
+    /* Kawałek o indeksie i ma pola od i * size, zob. slot_index. */
+    for (uint64_t i = 0; i < g->slotted_chunks; i++) {
+        for (uint64_t offset = 0; offset < size; offset++) {
+            uint64_t r = i * size + offset;
+
+            owner = g->chunks[i]->fields[offset].player;
+
+            if (owner == 0 || owner == skip || disc[r] != 0)
+                continue;
+
+            top = 0;
+            dfs[top++] = chunk_field(g, g->chunks[i], offset);
+            disc[r] = low[r] = ++time;
+            parts[r] = 0;
+
+            while (top > 0) {
+                curr = dfs[top - 1];
+                uint64_t c = slot_index(g, curr);
+
+                if (next_direction[c] < 4) {
+                    if (!neighbour_in_direction(g, owner, curr,
+                                                next_direction[c]++, &next))
+                        continue;
+
+                    uint64_t n = slot_index(g, next);
+
+                    if (disc[n] == 0) {
+                        disc[n] = low[n] = ++time;
+                        parts[n] = 1;
+                        dfs[top++] = next;
+                    }
+                    else if (disc[n] < low[c]) {
+                        low[c] = disc[n];
+                    }
+                }
+                else if (--top > 0) {
+                    uint64_t p = slot_index(g, dfs[top - 1]);
+
+                    if (low[c] < low[p])
+                        low[p] = low[c];
+                    if (low[c] >= disc[p])
+                        parts[p]++;
+                }
+            }
+        }
+    }
+
+    free(disc);
+    free(low);
+    free(next_direction);
+    free(dfs);
+
+    return true;
+}
+
+pair* gamma_golden_targets(gamma_t *g, uint32_t player, uint64_t *count) {
+    if (g == NULL || count == NULL || !check_player(g, player))
+        return NULL;
+
+    uint64_t size, opponents = 0;
+    uint8_t *parts = NULL;
+    pair *out, field;
+    uint32_t owner;
+    uint8_t split;
+    bool can_join;
+
+    *count = 0;
+
+    if (!gamma_golden_possible(g, player))
+        return calloc(1, sizeof(pair));
+
+    for (uint32_t i = 0; i < g->number_of_players; i++) {
+        if (i != player - 1)
+            opponents += g->player_fields[i];
+    }
+
+    /* Celami mogą być tylko pola przeciwników, a wszystkie leżą
+     * w istniejących kawałkach. Gdy drzewu bloków zabraknie pamięci na
+     * nowe kawałki, zostanie usunięte i policzymy części bez niego. */
+    if (g->splits != NULL)
+        reserve_splits(g);
+
+    if (!number_chunks(g))
+        return NULL;
+
+    size = chunk_size(g);
+    if (g->splits == NULL)
+        parts = malloc_array(g->slotted_chunks * size, sizeof(uint8_t));
+    out = malloc_array(opponents, sizeof(pair));
+
+    if (out == NULL || (g->splits == NULL &&
+        (parts == NULL || !count_parts_after_removal(g, player, parts)))) {
+        free(parts);
+        free(out);
+        return NULL;
+    }
+
+    can_join = g->player_areas[player - 1] < g->areas;
+
+    for (uint64_t i = 0; i < g->slotted_chunks; i++) {
+        for (uint64_t offset = 0; offset < size; offset++) {
+            owner = g->chunks[i]->fields[offset].player;
+
+            if (owner == 0 || owner == player)
+                continue;
+
+            field = chunk_field(g, g->chunks[i], offset);
+            split = g->splits != NULL ?
+                    block_tree_parts(g->splits, i * size + offset) :
+                    parts[i * size + offset];
+
+            if ((uint64_t)g->player_areas[owner - 1] - 1 + split > g->areas)
+                continue;
+
+            if (can_join || check_neighbours(g, player, field))
+                out[(*count)++] = field;
+        }
+    }
+
+    free(parts);
+
+    return out;
+}
+
+uint32_t gamma_split_count(gamma_t *g, uint32_t x, uint32_t y) {
+    pair field = make_pair(x, y);
+
+    if (g == NULL || !check_coordinates(g, field) || get_player(g, field) == 0)
+        return 0;
+
+    /* Drzewo ma wierzchołki tylko dla pól utworzonych kawałków. */
+    if (g->splits == NULL) {
+        g->splits = malloc(sizeof(block_tree));
+
+        if (g->splits == NULL)
+            return GAMMA_SPLIT_NOMEM;
+
+        if (!number_chunks(g) ||
+            !block_tree_init(g->splits, g->slotted_chunks * chunk_size(g))) {
+            free(g->splits);
+            g->splits = NULL;
+            return GAMMA_SPLIT_NOMEM;
+        }
+
+        if (!rebuild_splits(g))
+            return GAMMA_SPLIT_NOMEM;
+    }
+
+    return block_tree_parts(g->splits, slot_index(g, field));
+}
+
+/** @brief Liczy pola dostępne dla gracza, bez zapisywania zdarzeń śledzenia.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Wynik jak w funkcji @ref gamma_free_fields.
+ */
+static uint64_t free_fields(gamma_t *g, uint32_t player) {
+    if (g == NULL || !check_player(g, player))
+        return 0;
+
+    uint64_t out = 0;
+
+    if (g->player_areas[player - 1] < g->areas) {
+        out = (uint64_t)g->width * g->height;
+
+        for (uint32_t i = 0; i < g->number_of_players; i++) {
+            out -= g->player_fields[i];
+        }
+    }
+    else if (g->frontiers_ok || rebuild_frontiers(g)) {
+        out = g->frontiers[player - 1].size;
+    }
+    else {
+        STAT_ADD(g, free_scans, 1);
+
+        for (uint32_t row = 0; row < g->height; row++) {
+            for (uint32_t column = 0; column < g->width; column++) {
+                if (get_player(g, make_pair(column, row)) == 0)
+                    if (check_neighbours(g, player, make_pair(column, row)))
+                        out++;
+            }
+        }
+    }
+
+    return out;
+}
+
+uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
+    uint64_t out;
+
+    TRACE_BEGIN("gamma_free_fields", "player", player);
+    out = free_fields(g, player);
+    TRACE_END("gamma_free_fields");
+
+    return out;
+}
+
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player, pair *buf, uint64_t cap) {
+    if (g == NULL || buf == NULL || !check_player(g, player))
+        return 0;
+
+    uint64_t out = 0;
+
+    if (g->player_areas[player - 1] >= g->areas &&
+        (g->frontiers_ok || rebuild_frontiers(g))) {
+        index_set *frontier = &g->frontiers[player - 1];
+
+        for (out = 0; out < frontier->size && out < cap; out++)
+            buf[out] = frontier->items[out];
+    }
+    else if (g->player_areas[player - 1] < g->areas) {
+        /* Każde wolne pole jest dobre, więc kolumnę przeglądamy odcinkami
+         * leżącymi w jednym kawałku, a odcinki bez kawałka są całe wolne. */
+        for (uint32_t column = 0; column < g->width && out < cap; column++) {
+            for (uint32_t row = 0; row < g->height && out < cap;) {
+                pair first = make_pair(column, row);
+                chunk *c = find_chunk(g, chunk_id(g, first));
+                uint32_t end = (row | g->chunk_mask_y) + 1;
+
+                if (end > g->height || end == 0)
+                    end = g->height;
+
+                for (; row < end && out < cap; row++) {
+                    if (c == NULL ||
+                        c->fields[chunk_offset(g, make_pair(column, row))].player == 0)
+                        buf[out++] = make_pair(column, row);
+                }
+            }
+        }
+    }
+    else {
+        for (uint32_t column = 0; column < g->width && out < cap; column++) {
+            for (uint32_t row = 0; row < g->height && out < cap; row++) {
+                if (is_move_valid(g, player, make_pair(column, row)))
+                    buf[out++] = make_pair(column, row);
+            }
+        }
+    }
+
+    return out;
+}
+
+uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
+    if (g == NULL || !check_player(g, player))
+        return 0;
+
+    return g->player_fields[player - 1];
+}
+
+bool gamma_golden_possible(gamma_t *g, uint32_t player) {
+    if (g == NULL || !check_player(g, player))
+        return false;
+
+    if (g->player_gold_move[player - 1]) return false;
+
+    for (uint32_t i = 0; i < g->number_of_players; i++) {
+        if (g->player_fields[i] > 0 && i != player - 1)
+            return true;
+    }
+
+    return false;
+}
+
+/** @brief Sprowadza do pamięci podręcznej pole, na które pójdzie ruch.
+ * Plansze z wyspecjalizowanymi operacjami mieszczą się w jednym małym
+ * kawałku, który i tak jest w pamięci podręcznej, więc je pomijamy. Pomijamy
+ * też pola kawałków, których jeszcze nie ma.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] m             - ruch o poprawnych współrzędnych
+ */
+static void prefetch_move(gamma_t *g, const move_t *m) {
+    pair field = make_pair(m->x, m->y);
+    chunk *c;
+
+    if (g->ops != NULL)
+        return;
+
+    c = find_chunk(g, chunk_id(g, field));
+    if (c != NULL)
+        __builtin_prefetch(&c->fields[chunk_offset(g, field)], 1);
+}
+
+size_t gamma_apply_moves(gamma_t *g, const move_t *moves, size_t n,
+                         uint8_t *results) {
+    const move_t *m;
+    size_t out = 0;
+
+    if (results == NULL)
+        return 0;
+
+    for (size_t i = 0; i < n; i++) {
+        results[i] = g != NULL && moves != NULL &&
+                     check_player(g, moves[i].player) &&
+                     check_coordinates(g, make_pair(moves[i].x, moves[i].y));
+    }
+
+    if (g == NULL || moves == NULL)
+        return 0;
+
+    TRACE_BEGIN("gamma_apply_moves", "moves", n);
+
+    for (size_t i = 0; i < n; i++) {
+        if (i + PREFETCH_AHEAD < n && results[i + PREFETCH_AHEAD])
+            prefetch_move(g, &moves[i + PREFETCH_AHEAD]);
+
+        if (!results[i])
+            continue;
+
+        m = &moves[i];
+
+        /* Te same zdarzenia co pojedyncze wywołania, żeby ślad serii
+         * nie różnił się od śladu kolejnych ruchów. */
+        if (m->golden) {
+            TRACE_BEGIN("gamma_golden_move", "player", m->player);
+            write_begin(g);
+            results[i] = golden_move(g, m->player, m->x, m->y);
+            write_end(g);
+            TRACE_END("gamma_golden_move");
+        } else {
+            TRACE_BEGIN("gamma_move", "player", m->player);
+            write_begin(g);
+            results[i] = engine_move(g, m->player, m->x, m->y);
+            write_end(g);
+            TRACE_END("gamma_move");
+        }
+
+        out += results[i];
+    }
+
+    TRACE_END("gamma_apply_moves");
+
+    return out;
+}
+
+bool gamma_concurrent_begin(gamma_t *g) {
+    if (g == NULL || g->locks != NULL)
+        return false;
+
+    g->locks = malloc(sizeof(concurrent_locks) +
+                      g->number_of_players * sizeof(pthread_mutex_t));
+    if (g->locks == NULL)
+        return false;
+
+    pthread_mutex_init(&g->locks->chunks, NULL);
+    for (uint32_t i = 0; i < g->number_of_players; i++)
+        pthread_mutex_init(&g->locks->players[i], NULL);
+
+    /* Pogranicza i punkty artykulacji łączą pola różnych graczy, więc ich
+     * nie aktualizujemy, tylko odbudujemy przy następnym użyciu. */
+    write_begin(g);
+    drop_splits(g);
+    g->frontiers_ok = false;
+
+    return true;
+}
+
+/** @brief Podaje kawałek o danym numerze, tworząc go pod blokadą katalogu.
+ * @param[in,out] g         - wskaźnik na planszę w trybie współbieżnych ruchów
+ * @param[in] id            - numer kawałka
+ * @return Adres kawałka lub NULL, gdy zabrakło pamięci.
+ */
+static chunk* claim_chunk_locked(gamma_t *g, uint64_t id) {
+    chunk *out = find_chunk(g, id);
+
+    if (out != NULL)
+        return out;
+
+    pthread_mutex_lock(&g->locks->chunks);
+    out = claim_chunk(g, id);
+    pthread_mutex_unlock(&g->locks->chunks);
+
+    return out;
+}
+
+bool gamma_move_concurrent(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
+    pair this_field = make_pair(x, y);
+    pthread_mutex_t *lock;
+    uint32_t free_field = 0;
+    square *field;
+    chunk *c;
+    bool out = false;
+
+    if (g == NULL || g->locks == NULL || !check_player(g, player) ||
+        !check_coordinates(g, this_field))
+        return false;
+
+    lock = &g->locks->players[player - 1];
+    pthread_mutex_lock(lock);
+
+    /* Pola gracza zmienia tylko ten wątek, więc sprawdzenie sąsiadów i limitu
+     * obszarów jest aktualne. O wolne pole może walczyć inny gracz. */
+    if (get_player(g, this_field) == 0 &&
+        (g->player_areas[player - 1] < g->areas || check_neighbours(g, player, this_field)) &&
+        (c = claim_chunk_locked(g, chunk_id(g, this_field))) != NULL) {
+        field = &c->fields[chunk_offset(g, this_field)];
+
+        if (__atomic_compare_exchange_n(&field->player, &free_field, player, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            field->parent = this_field;
+            g->player_fields[player - 1]++;
+            g->player_areas[player - 1]++;
+            __atomic_fetch_xor(&g->hash, zobrist_field(g, this_field, player),
+                               __ATOMIC_RELAXED);
+
+            union_neighbours(g, player, this_field, true);
+            out = true;
+        }
+    }
+
+    pthread_mutex_unlock(lock);
+
+    return out;
+}
+
+void gamma_concurrent_end(gamma_t *g) {
+    if (g == NULL || g->locks == NULL)
+        return;
+
+    pthread_mutex_destroy(&g->locks->chunks);
+    for (uint32_t i = 0; i < g->number_of_players; i++)
+        pthread_mutex_destroy(&g->locks->players[i]);
+
+    free(g->locks);
+    g->locks = NULL;
+    write_end(g);
+}
+
+#ifdef GAMMA_TRACE
+/** @brief Podaje nazwę zapytania do zdarzeń śledzenia.
+ * @param[in] kind      - rodzaj zapytania
+ * @return Napis statyczny z nazwą odpowiadającej funkcji.
+ */
+static const char* query_name(query_kind kind) {
+    switch (kind) {
+        case QUERY_BUSY: return "gamma_busy_fields";
+        case QUERY_FREE: return "gamma_free_fields";
+        case QUERY_GOLDEN: return "gamma_golden_possible";
+        default: return "gamma_query";
+    }
+}
+#endif
+
+void gamma_query(gamma_t *g, const query_t *queries, size_t n, uint64_t *results) {
+    uint64_t free_total = 0;
+    uint32_t owners = 0, player;
+
+    if (results == NULL)
+        return;
+
+    if (g != NULL) {
+        free_total = (uint64_t)g->width * g->height;
+
+        for (uint32_t i = 0; i < g->number_of_players; i++) {
+            free_total -= g->player_fields[i];
+            owners += g->player_fields[i] > 0;
+        }
+    }
+
+    TRACE_BEGIN("gamma_query", "queries", n);
+
+    for (size_t i = 0; i < n; i++) {
+        results[i] = 0;
+        player = queries == NULL ? 0 : queries[i].player;
+
+        if (g == NULL || !check_player(g, player))
+            continue;
+
+        TRACE_BEGIN(query_name(queries[i].kind), "player", player);
+
+        switch (queries[i].kind) {
+            case QUERY_BUSY:
+                results[i] = g->player_fields[player - 1];
+                break;
+
+            case QUERY_FREE:
+                results[i] = g->player_areas[player - 1] < g->areas
+                             ? free_total : free_fields(g, player);
+                break;
+
+            case QUERY_GOLDEN:
+                results[i] = !g->player_gold_move[player - 1] &&
+                             owners > (g->player_fields[player - 1] > 0);
+                break;
+        }
+
+        TRACE_END(query_name(queries[i].kind));
+    }
+
+    TRACE_END("gamma_query");
+}
+
+/** @brief Liczy ilość cyfr danej liczby.
+ * Dla danej liczby @p x, liczy z ilu cyfr sie składa.
+ * @param[in] x         - liczba którą sprawdzamy, nieujemna
+ * @return Liczba określająca ilość cyfr w liczbie.
+ */
+uint16_t how_many_digits(uint32_t x) {
+    uint16_t out = 0;
+
+    if (x == 0)
+        return 1;
+
+    while (x != 0) {
+        out++;
+        x = x / 10;
+    }
+
+    return out;
+}
+/** @brief Określa szerokość każdego pola w napisie.
+ * Funkcja sprawdza ilość cyfr w największym indeksie gracza który,
+ * występuje na planszy wskazywanej przez @p g. Dla liczb więcej niż dwucyfrowych
+ * rezerwuje szerokość o jeden większą, dla zwiększonej czytelności.
+ * @param[in] g         - wskaźnik na planszę
+ * @return Szerokość każdego miejsca opisującego numer gracza na planszy.
+ */
+static uint16_t size_needed(gamma_t *g) {
+    uint32_t out = 0;
+
+    for (uint32_t i = 0; i < g->number_of_players; i++) {
+        if (g->player_fields[i] > 0)
+            out = i + 1;
+    }
+
+    out = how_many_digits(out);
+
+    if (out > 1) out++;
+
+    return out;
+}
+
+/** @brief Sprawdza, czy prostokąt leży na planszy.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] x0        - numer pierwszej kolumny
+ * @param[in] y0        - numer pierwszego wiersza
+ * @param[in] x1        - numer ostatniej kolumny
+ * @param[in] y1        - numer ostatniego wiersza
+ * @return Wartość @p true, jeżeli prostokąt jest niepusty i leży na planszy.
+ */
+static bool check_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                         uint32_t x1, uint32_t y1) {
+    return g != NULL && x0 <= x1 && y0 <= y1 && x1 < g->width && y1 < g->height;
+}
+
+/** @brief Podaje kawałek zawierający pole i koniec jego fragmentu w wierszu.
+ * Pozwala przeglądać wiersz całymi fragmentami kawałków i nie szukać kawałka
+ * osobno dla każdego pola.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] x         - numer kolumny pola
+ * @param[in] y         - numer wiersza pola
+ * @param[in] x1        - numer ostatniej przeglądanej kolumny
+ * @param[out] end      - numer ostatniej kolumny wiersza w tym kawałku,
+ *                        nie większy niż @p x1
+ * @return Adres kawałka lub NULL, gdy wszystkie te pola są wolne.
+ */
+static chunk* row_segment(gamma_t *g, uint32_t x, uint32_t y, uint32_t x1,
+                          uint32_t *end) {
+    *end = (x | g->chunk_mask_x) < x1 ? (x | g->chunk_mask_x) : x1;
+
+    return find_chunk(g, chunk_id(g, make_pair(x, y)));
+}
+
+/** @brief Tworzy napis opisujący prostokąt planszy, bez zapisywania zdarzeń
+ * śledzenia. Szerokość pola jest taka jak dla całej planszy, więc wiersze
+ * napisu są fragmentami wierszy napisu całej planszy.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] x0        - numer pierwszej kolumny
+ * @param[in] y0        - numer pierwszego wiersza
+ * @param[in] x1        - numer ostatniej kolumny
+ * @param[in] y1        - numer ostatniego wiersza
+ * @return Wynik jak w funkcji @ref gamma_board_region.
+ */
+static char* board_string(gamma_t *g, uint32_t x0, uint32_t y0,
+                          uint32_t x1, uint32_t y1) {
+    if (!check_region(g, x0, y0, x1, y1))
+        return NULL;
+
+    char *board;
+    uint32_t width = x1 - x0 + 1;
+    uint32_t height = y1 - y0 + 1;
+    uint32_t end;
+    chunk *c;
+    uint64_t start_index, end_index = 0;
+    uint64_t size_of_board, player_id;
+    int elem_width = size_needed(g);
+
+    /* Planszy, której napis nie zmieściłby się w pamięci, nie wypisujemy. */
+    if (!checked_mul((uint64_t)elem_width * width + 1, height, &size_of_board) ||
+        size_of_board == SIZE_MAX)
+        return NULL;
+
+    board = (char *) malloc(size_of_board + 1);
+
+    if (board == NULL)
+        return NULL;
+
+    for (uint32_t row = y1 + 1; row-- > y0;) {
+        for (uint32_t column = x0; column <= x1; column = end + 1) {
+            c = row_segment(g, column, row, x1, &end);
+
+            if (c == NULL) {
+                memset(board + end_index, ' ', (uint64_t)elem_width * (end - column + 1));
+                for (uint32_t x = column; x <= end; x++) {
+                    end_index += elem_width;
+                    board[end_index - 1] = '.';
+                }
+                continue;
+            }
+
+            for (uint32_t x = column; x <= end; x++) {
+                start_index = end_index;
+                end_index += elem_width - 1;
+                player_id = c->fields[chunk_offset(g, make_pair(x, row))].player;
+
+                if (player_id == 0) {
+                    board[end_index] = '.';
+                    end_index--;
+                }
+
+                while (player_id > 0) {
+                    board[end_index] = (char) (player_id % 10 + '0');
+                    end_index--;
+                    player_id /= 10;
+                }
+
+                end_index++;
+
+                while (end_index > start_index) {
+                    end_index--;
+                    board[end_index] = ' ';
+                }
+                end_index += elem_width;
+            }
+        }
+        board[end_index++] = '\n';
+    }
+    board[end_index] = '\0';
+
+    return board;
+}
+
+char* gamma_board(gamma_t *g) {
+    char *out;
+
+    if (g == NULL)
+        return NULL;
+
+    TRACE_BEGIN("gamma_board", NULL, 0);
+    out = board_string(g, 0, 0, g->width - 1, g->height - 1);
+    TRACE_END("gamma_board");
+
+    return out;
+}
+
+char* gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                         uint32_t x1, uint32_t y1) {
+    char *out;
+
+    TRACE_BEGIN("gamma_board_region", NULL, 0);
+    out = board_string(g, x0, y0, x1, y1);
+    TRACE_END("gamma_board_region");
+
+    return out;
+}
+
+/** @brief Bufor napisu o rosnącym rozmiarze. */
+typedef struct text {
+    char *data;                 ///< Napis, nie zakończony zerem.
+    uint64_t length;            ///< Długość napisu.
+    uint64_t capacity;          ///< Rozmiar bufora.
+} text;
+
+/** @brief Zapewnia miejsce na kolejne znaki napisu.
+ * @param[in,out] t     - bufor napisu
+ * @param[in] more      - liczba dopisywanych znaków
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool text_reserve(text *t, uint64_t more) {
+    uint64_t capacity = t->capacity;
+    char *grown;
+
+    if (t->length + more <= capacity)
+        return true;
+
+    while (capacity < t->length + more) {
+        if (capacity > SIZE_MAX / 2)
+            return false;
+        capacity *= 2;
+    }
+
+    grown = realloc(t->data, capacity);
+    if (grown == NULL)
+        return false;
+
+    t->data = grown;
+    t->capacity = capacity;
+
+    return true;
+}
+
+/** @brief Dopisuje do napisu jeden odcinek pól tego samego gracza.
+ * @param[in,out] t     - bufor napisu
+ * @param[in] count     - długość odcinka, liczba dodatnia
+ * @param[in] player    - numer gracza albo zero dla wolnych pól
+ * @param[in] first     - czy to pierwszy odcinek wiersza
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool text_run(text *t, uint32_t count, uint32_t player, bool first) {
+    /* Spacja, dwie liczby 32-bitowe, gwiazdka i zero kończące snprintf. */
+    if (!text_reserve(t, 24))
+        return false;
+
+    if (player == 0)
+        t->length += sprintf(t->data + t->length, first ? "%u." : " %u.", count);
+    else
+        t->length += sprintf(t->data + t->length, first ? "%u*%u" : " %u*%u",
+                             count, player);
+
+    return true;
+}
+
+char* gamma_board_rle(gamma_t *g, uint32_t x0, uint32_t y0,
+                      uint32_t x1, uint32_t y1) {
+    text t = {NULL, 0, 64};
+    uint32_t end, owner, count;
+    bool first, ok = true;
+    chunk *c;
+
+    if (!check_region(g, x0, y0, x1, y1) || (t.data = malloc(t.capacity)) == NULL)
+        return NULL;
+
+    TRACE_BEGIN("gamma_board_rle", NULL, 0);
+
+    for (uint32_t row = y1 + 1; ok && row-- > y0;) {
+        owner = count = 0;
+        first = true;
+
+        for (uint32_t column = x0; column <= x1; column = end + 1) {
+            c = row_segment(g, column, row, x1, &end);
+
+            for (uint32_t x = column; ok && x <= end; x++) {
+                uint32_t player = c == NULL ? 0 :
+                                  c->fields[chunk_offset(g, make_pair(x, row))].player;
+
+                if (player != owner && count > 0) {
+                    ok = text_run(&t, count, owner, first);
+                    first = false;
+                    count = 0;
+                }
+
+                /* Wolne pola nieistniejącego kawałka dopisujemy naraz. */
+                if (c == NULL) {
+                    count += end - x + 1;
+                    owner = 0;
+                    break;
+                }
+
+                owner = player;
+                count++;
+            }
+        }
+
+        ok = ok && text_run(&t, count, owner, first) && text_reserve(&t, 1);
+
+        if (ok)
+            t.data[t.length++] = '\n';
+    }
+
+    ok = ok && text_reserve(&t, 1);
+    TRACE_END("gamma_board_rle");
+
+    if (!ok) {
+        free(t.data);
+        return NULL;
+    }
+
+    t.data[t.length] = '\0';
+
+    return t.data;
+}
+
+/** @brief Zaczyna odczyt stanu gry z innego wątku niż zmieniający go.
+ * Czeka, aż skończy się trwająca zmiana stanu gry. Gdy trwa ona długo,
+ * oddaje procesor, bo wątek piszący mógł zostać wywłaszczony.
+ * @param[in] g             - wskaźnik na planszę
+ * @return Parzysta wartość licznika zmian, do przekazania funkcji
+ * @ref read_valid.
+ */
+static uint64_t read_begin(gamma_t *g) {
+    uint64_t sequence;
+
+    for (int spins = 1;
+         (sequence = atomic_load_explicit(&g->sequence, memory_order_acquire)) % 2 != 0;
+         spins++) {
+        if (spins % READ_SPINS == 0)
+            sched_yield();
+    }
+
+    return sequence;
+}
+
+/** @brief Sprawdza, czy odczyt zaczęty funkcją @ref read_begin jest spójny.
+ * @param[in] g             - wskaźnik na planszę
+ * @param[in] sequence      - wynik funkcji @ref read_begin
+ * @return Wartość @p true, jeżeli w trakcie odczytu stan gry się nie zmienił,
+ * a @p false, gdy trzeba go powtórzyć.
+ */
+static bool read_valid(gamma_t *g, uint64_t sequence) {
+    atomic_thread_fence(memory_order_acquire);
+
+    return atomic_load_explicit(&g->sequence, memory_order_relaxed) == sequence;
+}
+
+uint32_t gamma_read_player(gamma_t *g, uint32_t x, uint32_t y) {
+    uint64_t sequence;
+    uint32_t out;
+
+    if (g == NULL || x >= g->width || y >= g->height)
+        return 0;
+
+    do {
+        sequence = read_begin(g);
+        out = gamma_player(g, x, y);
+    } while (!read_valid(g, sequence));
+
+    return out;
+}
+
+uint64_t gamma_read_busy_fields(gamma_t *g, uint32_t player) {
+    uint64_t sequence, out;
+
+    if (g == NULL || !check_player(g, player))
+        return 0;
+
+    do {
+        sequence = read_begin(g);
+        out = g->player_fields[player - 1];
+    } while (!read_valid(g, sequence));
+
+    return out;
+}
+
+char* gamma_read_board(gamma_t *g) {
+    uint64_t sequence;
+    char *out;
+
+    if (g == NULL)
+        return NULL;
+
+    TRACE_BEGIN("gamma_read_board", NULL, 0);
+
+    while (true) {
+        sequence = read_begin(g);
+        out = board_string(g, 0, 0, g->width - 1, g->height - 1);
+
+        if (read_valid(g, sequence))
+            break;
+
+        free(out);
+    }
+
+    TRACE_END("gamma_read_board");
+
+    return out;
+}
+
+char* gamma_board_max(gamma_t *g) {
+    if (g == NULL)
+        return NULL;
+
+    char *board;
     uint32_t width = g->width;
-    bool* visited;
-    stack *stk = g->stk;
-    pair curr;
+    uint32_t height = g->height;
+    pair i;
+    uint64_t start_index, end_index = 0;
+    uint64_t size_of_board, player_id;
+    int elem_width = how_many_digits(g->number_of_players) + 1;
 
-    clear_bool_arr(g->visited, width * height);
-    visited = g->visited;
-    push(stk, central);
+    /* Planszy, której napis nie zmieściłby się w pamięci, nie wypisujemy. */
+    if (!checked_mul((uint64_t)elem_width * width + 1, height, &size_of_board) ||
+        size_of_board == SIZE_MAX)
+        return NULL;
+
+    board = (char *) malloc(size_of_board + 1);
+
+    if (board == NULL)
+        return NULL;
+
+    for (uint32_t row = 0; row < height; row++) {
+        for (uint32_t column = 0; column < width; column++) {
+            i = make_pair(column, height - row - 1);
+            start_index = end_index;
+            end_index += elem_width - 1;
+            player_id = get_player(g, i);
+
+            if (player_id == 0) {
+                board[end_index] = '.';
+                end_index--;
+            }
+
+            while (player_id > 0) {
+                board[end_index] = (char) (player_id % 10 + '0');
+                end_index--;
+                player_id /= 10;
+            }
+
+            end_index++;
+
+            while (end_index > start_index) {
+                end_index--;
+                board[end_index] = ' ';
+            }
+            end_index += elem_width;
+        }
+        board[end_index++] = '\n';
+    }
+    board[end_index] = '\0';
+
+    return board;
+}
+
+bool gamma_stats(gamma_t *g, gamma_counters *out) {
+#ifdef GAMMA_STATS
+    if (g == NULL || out == NULL)
+        return false;
+
+    *out = g->stats;
+
+    return true;
+#else
+    (void)g;
+    (void)out;
+
+    return false;
+#endif
+}
+
+void gamma_stats_reset(gamma_t *g) {
+#ifdef GAMMA_STATS
+    if (g != NULL)
+        memset(&g->stats, 0, sizeof(gamma_counters));
+#else
+    (void)g;
+#endif
+}
+
+void gamma_shrink(gamma_t *g) {
+    if (g == NULL)
+        return;
+
+    free_stack(g->stk);
+    g->stk = NULL;
+
+    for (uint64_t i = 0; i < g->chunks_count; i++) {
+        free(g->chunks[i]->visited);
+        g->chunks[i]->visited = NULL;
+    }
+
+    g->visited_chunks = 0;
+    drop_splits(g);
+}
+
+/** @brief Zapisuje liczbę w kolejności little-endian.
+ * @param[out] out      - miejsce na 4 bajty
+ * @param[in] value     - liczba
+ */
+static void put_u32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        out[i] = (uint8_t)(value >> (8 * i));
+}
+
+/** @brief Zapisuje liczbę w kolejności little-endian.
+ * @param[out] out      - miejsce na 8 bajtów
+ * @param[in] value     - liczba
+ */
+static void put_u64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++)
+        out[i] = (uint8_t)(value >> (8 * i));
+}
+
+/** @brief Odczytuje liczbę zapisaną w kolejności little-endian.
+ * @param[in] in        - 4 bajty liczby
+ * @return Odczytana liczba.
+ */
+static uint32_t get_u32(const uint8_t *in) {
+    uint32_t out = 0;
+
+    for (int i = 3; i >= 0; i--)
+        out = (out << 8) | in[i];
+
+    return out;
+}
+
+/** @brief Odczytuje liczbę zapisaną w kolejności little-endian.
+ * @param[in] in        - 8 bajtów liczby
+ * @return Odczytana liczba.
+ */
+static uint64_t get_u64(const uint8_t *in) {
+    uint64_t out = 0;
+
+    for (int i = 7; i >= 0; i--)
+        out = (out << 8) | in[i];
+
+    return out;
+}
+
+/** @brief Zapisuje cały bufor do pliku.
+ * @param[in] fd        - deskryptor pliku
+ * @param[in] buf       - bufor
+ * @param[in] length    - długość bufora
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool write_all(int fd, const uint8_t *buf, uint64_t length) {
+    while (length > 0) {
+        ssize_t done = write(fd, buf, length);
+
+        if (done < 0 && errno == EINTR)
+            continue;
 
-    while (!is_stack_empty(stk)) {
-        curr = pop(stk);
+        if (done <= 0)
+            return false;
 
-        union_fields(g, central, curr, false);
+        buf += done;
+        length -= done;
+    }
 
-        if (is_north_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_north(curr))) {
+    return true;
+}
 
-            push(stk, move_pair_north(curr));
-        }
-        if (is_south_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_south(curr))) {
+/** @brief Podaje rozmiar części zapisu z licznikami graczy.
+ * Zawiera liczby obszarów (po 4 bajty), liczby pól (po 8 bajtów) i znaczniki
+ * złotych ruchów (po bajcie), wyrównane do 8 bajtów, żeby kawałki w pliku
+ * były wyrównane jak w pamięci.
+ * @param[in] players   - liczba graczy
+ * @return Rozmiar w bajtach.
+ */
+static uint64_t snapshot_players_size(uint32_t players) {
+    return ((uint64_t)players * 13 + 7) & ~(uint64_t)7;
+}
 
-            push(stk, move_pair_south(curr));
-        }
-        if (is_west_valid(g, player, curr) &&
-            !check_and_visit(visited, height, move_pair_west(curr))) {
+/** @brief Sprawdza, czy nieskompresowane kawałki z pliku można użyć wprost.
+ * @return Wartość @p true, jeżeli komputer zapisuje liczby w kolejności
+ * little-endian, a struktury @ref chunk i @ref square mają w pamięci
+ * taki układ jak w pliku.
+ */
+static bool snapshot_native(void) {
+    uint32_t probe = 1;
+    uint8_t low;
 
-            push(stk, move_pair_west(curr));
-        }
-        if (is_east_valid(g, player, curr) &&
-            !check_and_visit(visited, height,move_pair_east(curr))) {
+    memcpy(&low, &probe, 1);
 
-            push(stk, move_pair_east(curr));
-        }
-    }
+    return low == 1 && offsetof(chunk, fields) == SNAPSHOT_CHUNK_HEADER &&
+           sizeof(square) == SNAPSHOT_SQUARE && offsetof(square, parent) == 4 &&
+           offsetof(square, rank) == 12 && offsetof(square, children) == 14 &&
+           sizeof(pair) == 8 &&
+           offsetof(pair, snd) == 4;
 }
 
-/** @brief Łączy kolejne spójne obszary sąsiadów i liczy ile było takich rozłącznych.
- * Funkcja łączy na nowo, zresetowane już obszary sąsiadujące z polem @p central,
- * które należą do gracza o indeksie @p player. Przy tym sprawdza ilu sąsiadów tego
- * pola jest rozłącznych
- * @param[in,out] g         - wskaźnik na planszę
- * @param[in] player        - numer indeksu gracza do którego należy pole
- *                            liczba dodatnia
- * @param[in] central       - para nieujemnych współrzędnych określających
- *                            położenie pola
- * @return Liczbę rozłącznych obszarów które powstaną po usunięciu danego pola.
+/** @brief Koduje kawałek planszy do zapisu gry.
+ * Nieskompresowany kawałek ma układ struktury @ref chunk: numer, dwa zera
+ * w miejscu @p epoch i @p visited oraz pola, każde jako właściciel,
+ * współrzędne rodzica oraz ranga i liczba dzieci (po dwa bajty). W wersji
+ * SNAPSHOT_VERSION_NO_CHILDREN zamiast nich była czterobajtowa ranga. Skompresowany kawałek to numer, liczba serii
+ * i serie jako pary właściciel, długość.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] c         - kawałek
+ * @param[in] compress  - czy zapisać właścicieli seriami
+ * @param[out] out      - bufor na co najwyżej
+ *                        SNAPSHOT_CHUNK_HEADER + SNAPSHOT_SQUARE * liczba pól
+ *                        kawałka bajtów
+ * @return Liczba zapisanych bajtów.
  */
-static int update_neighbours_and_count_them(gamma_t *g, uint32_t player, pair central) {
-    int out = 0;
+static uint64_t encode_chunk(gamma_t *g, chunk *c, bool compress, uint8_t *out) {
+    uint64_t size = chunk_size(g), runs = 0, length;
 
-    if (is_north_valid(g, player, central) &&
-        !is_his_own_parent(g, move_pair_north(central))) {
+    put_u64(out, c->id);
 
-        out++;
-        update_unions_on_area(g, player, move_pair_north(central));
-    }
-    if (is_south_valid(g, player, central) &&
-        !is_his_own_parent(g, move_pair_south(central))) {
+    if (!compress) {
+        put_u64(out + 8, 0);
+        put_u64(out + 16, 0);
 
-        out++;
-        update_unions_on_area(g, player, move_pair_south(central));
+        for (uint64_t i = 0; i < size; i++) {
+            uint8_t *field = out + SNAPSHOT_CHUNK_HEADER + i * SNAPSHOT_SQUARE;
+
+            put_u32(field, c->fields[i].player);
+            put_u32(field + 4, c->fields[i].parent.fst);
+            put_u32(field + 8, c->fields[i].parent.snd);
+            put_u32(field + 12, c->fields[i].rank |
+                                (uint32_t)c->fields[i].children << 16);
+        }
+
+        return SNAPSHOT_CHUNK_HEADER + size * SNAPSHOT_SQUARE;
     }
-    if (is_west_valid(g, player, central) &&
-        !is_his_own_parent(g, move_pair_west(central))) {
 
-        out++;
-        update_unions_on_area(g, player, move_pair_west(central));
+    for (uint64_t i = 0; i < size; i += length) {
+        for (length = 1; i + length < size &&
+             c->fields[i + length].player == c->fields[i].player; length++);
+
+        put_u32(out + 16 + runs * 8, c->fields[i].player);
+        put_u32(out + 20 + runs * 8, (uint32_t)length);
+        runs++;
     }
-    if (is_east_valid(g, player, central) &&
-        !is_his_own_parent(g, move_pair_east(central))) {
 
-        out++;
-        update_unions_on_area(g, player, move_pair_east(central));
+    put_u64(out + 8, runs);
+
+    return 16 + runs * 8;
+}
+
+bool gamma_save(gamma_t *g, int fd, bool compress) {
+    if (g == NULL)
+        return false;
+
+    uint8_t header[SNAPSHOT_HEADER] = {0};
+    uint32_t players = g->number_of_players;
+    uint64_t players_size = snapshot_players_size(players);
+    uint8_t *counters = calloc(players_size, 1);
+    uint8_t *buf = malloc(SNAPSHOT_CHUNK_HEADER + chunk_size(g) * SNAPSHOT_SQUARE);
+    bool ok = counters != NULL && buf != NULL;
+
+    memcpy(header, SNAPSHOT_MAGIC, 8);
+    put_u32(header + 8, SNAPSHOT_VERSION);
+    put_u32(header + 12, (compress ? SNAPSHOT_RLE : 0) | SNAPSHOT_LAYOUT);
+    put_u32(header + 16, g->width);
+    put_u32(header + 20, g->height);
+    put_u32(header + 24, players);
+    put_u32(header + 28, g->areas);
+    header[32] = g->chunk_bits_x;
+    header[33] = g->chunk_bits_y;
+    header[34] = g->column_bits;
+    put_u64(header + 40, g->chunks_count);
+    put_u64(header + 48, g->hash);
+
+    for (uint32_t i = 0; ok && i < players; i++) {
+        put_u32(counters + 4 * (uint64_t)i, g->player_areas[i]);
+        put_u64(counters + 4 * (uint64_t)players + 8 * (uint64_t)i, g->player_fields[i]);
+        counters[12 * (uint64_t)players + i] = g->player_gold_move[i];
     }
 
-    return out;
+    ok = ok && write_all(fd, header, SNAPSHOT_HEADER) &&
+         write_all(fd, counters, players_size);
+
+    for (uint64_t i = 0; ok && i < g->chunks_count; i++)
+        ok = write_all(fd, buf, encode_chunk(g, g->chunks[i], compress, buf));
+
+    free(counters);
+    free(buf);
+
+    return ok;
 }
 
-bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
-    int field_owner;
-    pair this_field = make_pair(x, y);
+/** @brief Sprawdza numer kawałka odczytany z zapisu gry.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] id        - numer kawałka
+ * @return Wartość @p true, jeżeli kawałek leży na planszy i nie został
+ * jeszcze wczytany.
+ */
+static bool snapshot_chunk_id_ok(gamma_t *g, uint64_t id) {
+    uint64_t column = id >> g->column_bits;
+    uint64_t row = id & (((uint64_t)1 << g->column_bits) - 1);
 
-    if (g == NULL || !is_golden_move_valid(g, player, this_field) ||
-        !gamma_golden_possible(g, player) ||
-        get_player(g, this_field) == player){
+    return column <= (uint64_t)(g->width - 1) >> g->chunk_bits_x &&
+           row <= (uint64_t)(g->height - 1) >> g->chunk_bits_y &&
+           find_chunk(g, id) == NULL;
+}
 
-        return false;
-    }
+/** @brief Sprawdza pole wczytane z zapisu gry do nowego kawałka.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] c         - kawałek
+ * @param[in] offset    - indeks pola w kawałku
+ * @return Wartość @p true, jeżeli pole jest wolne albo leży na planszy
+ * i należy do istniejącego gracza.
+ */
+static bool snapshot_field_ok(gamma_t *g, chunk *c, uint64_t offset) {
+    uint32_t owner = c->fields[offset].player;
 
-    field_owner = get_player(g, this_field);
+    return owner == 0 || (owner <= g->number_of_players &&
+                          check_coordinates(g, chunk_field(g, c, offset)));
+}
 
-    reset_parents_area(g, field_owner, this_field);
-    reset_field(g, this_field);
+/** @brief Sprawdza pole wczytane z nieskompresowanego zapisu.
+ * Oprócz warunków @ref snapshot_field_ok rodzic zajętego pola musi leżeć na
+ * planszy, bo inaczej find wyszedłby poza kawałki.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] c         - kawałek z wczytanym polem
+ * @param[in] offset    - indeks pola w kawałku
+ * @return Wartość @p true, jeżeli pole jest poprawne.
+ */
+static bool snapshot_square_ok(gamma_t *g, chunk *c, uint64_t offset) {
+    return snapshot_field_ok(g, c, offset) &&
+           (c->fields[offset].player == 0 ||
+            check_coordinates(g, c->fields[offset].parent));
+}
 
-    g->player_areas[field_owner - 1] +=
-            update_neighbours_and_count_them(g, field_owner, this_field) - 1;
+/** @brief Podaje indeks pola kawałka w tej kompilacji silnika.
+ * @param[in] g         - wskaźnik na planszę
+ * @param[in] offset    - indeks pola w zapisie gry
+ * @param[in] morton    - czy pola zapisu leżą w porządku Mortona
+ * @return Indeks pola w tablicy pól kawałka.
+ */
+static uint64_t snapshot_offset(gamma_t *g, uint64_t offset, bool morton) {
+    if (morton == MORTON_LAYOUT)
+        return offset;
 
-    g->player_fields[field_owner - 1]--;
+    return chunk_offset(g, offset_field(g, offset, morton));
+}
 
-    if (g->player_areas[field_owner - 1] > g->areas ||
-        !gamma_move(g, player, x, y)) {
+/** @brief Wczytuje kawałek nieskompresowanego zapisu, kopiując go.
+ * @param[in,out] g     - wskaźnik na planszę
+ * @param[in] in        - zapis kawałka
+ * @param[in] morton    - czy pola zapisu leżą w porządku Mortona
+ * @return Wartość @p true, jeżeli się udało, @p false gdy kawałek jest
+ * niepoprawny lub zabrakło pamięci.
+ */
+static bool decode_raw_chunk(gamma_t *g, const uint8_t *in, bool morton) {
+    chunk *c = claim_chunk(g, get_u64(in));
 
-        gamma_move(g, field_owner, x, y);
+    if (c == NULL)
         return false;
-    }
 
-    g->player_gold_move[player - 1] = true;
+    for (uint64_t i = 0; i < chunk_size(g); i++) {
+        const uint8_t *field = in + SNAPSHOT_CHUNK_HEADER + i * SNAPSHOT_SQUARE;
+        uint64_t j = snapshot_offset(g, i, morton);
+
+        c->fields[j].player = get_u32(field);
+        c->fields[j].parent = make_pair(get_u32(field + 4), get_u32(field + 8));
+        c->fields[j].rank = (uint16_t)get_u32(field + 12);
+        c->fields[j].children = (uint16_t)(get_u32(field + 12) >> 16);
+
+        if (!snapshot_square_ok(g, c, j))
+            return false;
+    }
 
     return true;
 }
 
-uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
-    if (g == NULL || !check_player(g, player))
-        return 0;
+/** @brief Wczytuje kawałek skompresowanego zapisu.
+ * Zajęte pola stają się korzeniami własnych drzew find & union, które trzeba
+ * potem połączyć funkcją @ref union_neighbours.
+ * @param[in,out] g     - wskaźnik na planszę
+ * @param[in] in        - zapis kawałka
+ * @param[in] runs      - liczba serii
+ * @param[in] morton    - czy pola zapisu leżą w porządku Mortona
+ * @return Wartość @p true, jeżeli się udało, @p false gdy kawałek jest
+ * niepoprawny lub zabrakło pamięci.
+ */
+static bool decode_rle_chunk(gamma_t *g, const uint8_t *in, uint64_t runs,
+                             bool morton) {
+    chunk *c = claim_chunk(g, get_u64(in));
+    uint64_t offset = 0;
 
-    uint64_t out = 0;
-    struct square** board = g->board;
+    if (c == NULL)
+        return false;
 
-    if (g->player_areas[player - 1] < g->areas) {
-        out = g->width * g->height;
+    for (uint64_t i = 0; i < runs; i++) {
+        uint32_t owner = get_u32(in + 16 + i * 8);
+        uint32_t length = get_u32(in + 20 + i * 8);
 
-        for (uint32_t i = 0; i < g->number_of_players; i++) {
-            out -= g->player_fields[i];
+        if (length > chunk_size(g) - offset)
+            return false;
+
+        /* Nowy kawałek jest wyzerowany, więc wolne pola wystarczy pominąć. */
+        if (owner == 0) {
+            offset += length;
+            continue;
         }
-    }
-    else {
-        for (uint32_t row = 0; row < g->height; row++) {
-            for (uint32_t column = 0; column < g->width; column++) {
-                if (board[column][row].player == 0)
-                    if (check_neighbours(g, player, make_pair(column, row)))
-                        out++;
-            }
+
+        for (; length > 0; length--, offset++) {
+            uint64_t j = snapshot_offset(g, offset, morton);
+
+            c->fields[j].player = owner;
+            c->fields[j].parent = chunk_field(g, c, j);
+
+            if (!snapshot_field_ok(g, c, j))
+                return false;
         }
     }
 
-    return out;
+    return offset == chunk_size(g);
 }
 
-uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
-    if (g == NULL || !check_player(g, player))
-        return 0;
+/** @brief Wczytuje kawałki planszy z zapisu gry.
+ * @param[in,out] g     - wskaźnik na planszę
+ * @param[in] map       - odwzorowany w pamięci plik
+ * @param[in] size      - rozmiar pliku
+ * @param[in] offset    - położenie pierwszego kawałka w pliku
+ * @param[in] count     - liczba kawałków
+ * @param[in] flags     - flagi zapisu
+ * @param[in] in_place  - czy nieskompresowane kawałki użyć wprost z pliku
+ *                        (tylko gdy układ pól jest taki jak w tej kompilacji)
+ * @return Wartość @p true, jeżeli się udało, @p false gdy plik jest
+ * niepoprawny lub zabrakło pamięci.
+ */
+static bool load_chunks(gamma_t *g, uint8_t *map, uint64_t size, uint64_t offset,
+                        uint64_t count, uint32_t flags, bool in_place) {
+    uint64_t record = SNAPSHOT_CHUNK_HEADER + chunk_size(g) * SNAPSHOT_SQUARE;
+    bool morton = (flags & SNAPSHOT_MORTON) != 0;
 
-    return g->player_fields[player - 1];
-}
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t runs = 0;
 
-bool gamma_golden_possible(gamma_t *g, uint32_t player) {
-    if (g == NULL || !check_player(g, player))
-        return false;
+        if (size - offset < 16 || !snapshot_chunk_id_ok(g, get_u64(map + offset)))
+            return false;
 
-    if (g->player_gold_move[player - 1]) return false;
+        if (flags & SNAPSHOT_RLE) {
+            runs = get_u64(map + offset + 8);
 
-    for (uint32_t i = 0; i < g->number_of_players; i++) {
-        if (g->player_fields[i] > 0 && i != player - 1)
-            return true;
-    }
+            if (runs > chunk_size(g) || (size - offset - 16) / 8 < runs ||
+                !decode_rle_chunk(g, map + offset, runs, morton))
+                return false;
 
-    return false;
-}
+            offset += 16 + runs * 8;
+        }
+        else if (size - offset < record) {
+            return false;
+        }
+        else if (in_place) {
+            chunk *c = (chunk *)(map + offset);
 
-/** @brief Liczy ilość cyfr danej liczby.
- * Dla danej liczby @p x, liczy z ilu cyfr sie składa.
- * @param[in] x         - liczba którą sprawdzamy, nieujemna
- * @return Liczba określająca ilość cyfr w liczbie.
- */
-uint16_t how_many_digits(uint32_t x) {
-    uint16_t out = 0;
+            if (c->epoch != 0 || c->visited != NULL)
+                return false;
 
-    if (x == 0)
-        return 1;
+            /* Pola sprawdzamy tak samo jak przy kopiowaniu, bo plik mógł
+             * zostać uszkodzony. */
+            for (uint64_t j = 0; j < chunk_size(g); j++) {
+                if (!snapshot_square_ok(g, c, j))
+                    return false;
+            }
 
-    while (x != 0) {
-        out++;
-        x = x / 10;
+            if (!add_chunk(g, c))
+                return false;
+
+            offset += record;
+        }
+        else {
+            if (!decode_raw_chunk(g, map + offset, morton))
+                return false;
+
+            offset += record;
+        }
     }
 
-    return out;
+    return offset == size;
 }
-/** @brief Określa szerokość każdego pola w napisie.
- * Funkcja sprawdza ilość cyfr w największym indeksie gracza który,
- * występuje na planszy wskazywanej przez @p g. Dla liczb więcej niż dwucyfrowych
- * rezerwuje szerokość o jeden większą, dla zwiększonej czytelności.
- * @param[in] g         - wskaźnik na planszę
- * @return Szerokość każdego miejsca opisującego numer gracza na planszy.
- */
-static uint16_t size_needed(gamma_t *g) {
-    uint32_t out = 0;
 
-    for (uint32_t i = 0; i < g->number_of_players; i++) {
-        if (g->player_fields[i] > 0)
-            out = i;
+/** @brief Liczy na nowo liczniki dzieci wszystkich pól.
+ * Potrzebne po wczytaniu nieskompresowanego zapisu w wersji
+ * SNAPSHOT_VERSION_NO_CHILDREN, w której liczników nie było.
+ * @param[in,out] g     - wskaźnik na planszę
+ */
+static void count_children(gamma_t *g) {
+    for (uint64_t i = 0; i < g->chunks_count; i++) {
+        for (uint64_t offset = 0; offset < chunk_size(g); offset++)
+            g->chunks[i]->fields[offset].children = 0;
     }
 
-    out = how_many_digits(out);
+    for (uint64_t i = 0; i < g->chunks_count; i++) {
+        for (uint64_t offset = 0; offset < chunk_size(g); offset++) {
+            square *field = &g->chunks[i]->fields[offset];
+            chunk *c;
 
-    if (out > 1) out++;
+            if (field->player == 0 ||
+                compare_pairs(field->parent, chunk_field(g, g->chunks[i], offset)) == 0)
+                continue;
 
-    return out;
+            c = find_chunk(g, chunk_id(g, field->parent));
+            if (c != NULL)
+                add_child(&c->fields[chunk_offset(g, field->parent)]);
+        }
+    }
 }
 
-char* gamma_board(gamma_t *g) {
-    if (g == NULL)
-        return NULL;
-
-    char *board;
-    uint32_t width = g->width;
-    uint32_t height = g->height;
-    pair i;
-    uint64_t start_index, end_index = 0;
-    uint64_t size_of_board, player_id;
-    int elem_width = size_needed(g);
+gamma_t* gamma_load(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    uint8_t *map;
+    uint64_t size, players_size, count;
+    uint32_t flags, players, version;
+    gamma_t *g;
+    bool in_place;
 
-    size_of_board = elem_width * width * height + height + 1;
-    board = (char *) malloc(size_of_board * sizeof(char));
+    if (fd < 0)
+        return NULL;
 
-    if (board == NULL)
+    if (fstat(fd, &info) != 0 || info.st_size < SNAPSHOT_HEADER) {
+        close(fd);
         return NULL;
+    }
 
-    for (uint32_t row = 0; row < height; row++) {
-        for (uint32_t column = 0; column < width; column++) {
-            i = make_pair(column, height - row - 1);
-            start_index = end_index;
-            end_index += elem_width - 1;
-            player_id = get_player(g, i);
+    size = info.st_size;
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
 
-            if (player_id == 0) {
-                board[end_index] = '.';
-                end_index--;
-            }
+    if (map == MAP_FAILED)
+        return NULL;
 
-            while (player_id > 0) {
-                board[end_index] = (char) (player_id % 10 + '0');
-                end_index--;
-                player_id /= 10;
-            }
+    version = get_u32(map + 8);
+    flags = get_u32(map + 12);
+    players = get_u32(map + 24);
+    players_size = snapshot_players_size(players);
+    count = get_u64(map + 40);
+
+    if (memcmp(map, SNAPSHOT_MAGIC, 8) != 0 || (version != SNAPSHOT_VERSION && version != SNAPSHOT_VERSION_NO_CHILDREN) ||
+        (flags & ~(SNAPSHOT_RLE | SNAPSHOT_MORTON)) != 0 || players_size > size - SNAPSHOT_HEADER ||
+        (g = gamma_new(get_u32(map + 16), get_u32(map + 20), players,
+                       get_u32(map + 28))) == NULL) {
+        munmap(map, size);
+        return NULL;
+    }
 
-            end_index++;
+    if (map[32] != g->chunk_bits_x || map[33] != g->chunk_bits_y ||
+        map[34] != g->column_bits) {
+        gamma_delete(g);
+        munmap(map, size);
+        return NULL;
+    }
 
-            while (end_index > start_index) {
-                end_index--;
-                board[end_index] = ' ';
-            }
-            end_index += elem_width;
-        }
-        board[end_index++] = '\n';
+    for (uint32_t i = 0; i < players; i++) {
+        g->player_areas[i] = get_u32(map + SNAPSHOT_HEADER + 4 * (uint64_t)i);
+        g->player_fields[i] = get_u64(map + SNAPSHOT_HEADER + 4 * (uint64_t)players +
+                                      8 * (uint64_t)i);
+        g->player_gold_move[i] = map[SNAPSHOT_HEADER + 12 * (uint64_t)players + i] != 0;
     }
-    board[end_index] = '\0';
 
-    return board;
-}
+    g->hash = get_u64(map + 48);
+    g->frontiers_ok = false;
 
-char* gamma_board_max(gamma_t *g) {
-    if (g == NULL)
-        return NULL;
+    /* Kawałki użyte wprost zwalnia razem z plikiem funkcja gamma_delete. */
+    in_place = (flags & SNAPSHOT_RLE) == 0 &&
+               (flags & SNAPSHOT_MORTON) == SNAPSHOT_LAYOUT && snapshot_native();
 
-    char *board;
-    uint32_t width = g->width;
-    uint32_t height = g->height;
-    pair i;
-    uint64_t start_index, end_index = 0;
-    uint64_t size_of_board, player_id;
-    int elem_width = how_many_digits(g->number_of_players) + 1;
+    if (in_place) {
+        g->mapping = map;
+        g->mapping_size = size;
+    }
 
-    size_of_board = elem_width * width * height + height + 1;
-    board = (char *) malloc(size_of_board * sizeof(char));
+    if (!load_chunks(g, map, size, SNAPSHOT_HEADER + players_size, count,
+                     flags, in_place)) {
+        gamma_delete(g);
 
-    if (board == NULL)
-        return NULL;
+        if (!in_place)
+            munmap(map, size);
 
-    for (uint32_t row = 0; row < height; row++) {
-        for (uint32_t column = 0; column < width; column++) {
-            i = make_pair(column, height - row - 1);
-            start_index = end_index;
-            end_index += elem_width - 1;
-            player_id = get_player(g, i);
+        return NULL;
+    }
 
-            if (player_id == 0) {
-                board[end_index] = '.';
-                end_index--;
-            }
+    if (!in_place)
+        munmap(map, size);
 
-            while (player_id > 0) {
-                board[end_index] = (char) (player_id % 10 + '0');
-                end_index--;
-                player_id /= 10;
-            }
+    if ((flags & SNAPSHOT_RLE) == 0 && version == SNAPSHOT_VERSION_NO_CHILDREN)
+        count_children(g);
 
-            end_index++;
+    if (flags & SNAPSHOT_RLE) {
+        for (uint64_t i = 0; i < g->chunks_count; i++) {
+            for (uint64_t offset = 0; offset < chunk_size(g); offset++) {
+                uint32_t owner = g->chunks[i]->fields[offset].player;
 
-            while (end_index > start_index) {
-                end_index--;
-                board[end_index] = ' ';
+                if (owner != 0)
+                    union_neighbours(g, owner, chunk_field(g, g->chunks[i], offset), false);
             }
-            end_index += elem_width;
         }
-        board[end_index++] = '\n';
     }
-    board[end_index] = '\0';
 
-    return board;
-}
\ No newline at end of file
+    return g;
+}
@@ -10,7 +10,9 @@
 #define GAMMA_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "pairs.h"
 
 /**
  * Struktura przechowująca stan gry.
@@ -25,9 +27,22 @@ uint32_t gamma_height(gamma_t *g);
 
 uint32_t gamma_player(gamma_t *g, uint32_t x, uint32_t y);
 
+/** @brief Podaje skrót Zobrista stanu gry.
+ * Skrót zależy od właścicieli wszystkich pól i od tego, którzy gracze
+ * wykonali już złoty ruch. Te same stany gry mają ten sam skrót niezależnie
+ * od kolejności ruchów, które do nich doprowadziły. Skrót jest aktualizowany
+ * w czasie stałym przy każdym ruchu.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Skrót stanu gry lub zero, gdy wskaźnik @p g ma wartość NULL.
+ */
+uint64_t gamma_hash(gamma_t *g);
+
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
+ * Pola planszy są przechowywane w kawałkach tworzonych przy pierwszym ruchu
+ * na nich, więc pamięć zależy od zajętej części planszy, a nie od jej
+ * rozmiaru, i można tworzyć nawet plansze 10^6 na 10^6.
  * @param[in] width   – szerokość planszy, liczba dodatnia,
  * @param[in] height  – wysokość planszy, liczba dodatnia,
  * @param[in] players – liczba graczy, liczba dodatnia,
@@ -46,6 +61,61 @@ gamma_t* gamma_new(uint32_t width, uint32_t height,
  */
 void gamma_delete(gamma_t *g);
 
+/** @brief Przywraca początkowy stan gry.
+ * Czyści planszę i liczniki graczy, zachowując zaalokowaną pamięć, dzięki
+ * czemu jedną strukturę można wykorzystać do wielu kolejnych rozgrywek.
+ * Nic nie robi, jeśli wskaźnik @p g ma wartość NULL.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_reset(gamma_t *g);
+
+/** @brief Tworzy nową grę, w miarę możliwości w pamięci starej.
+ * Jeżeli gra @p g ma te same wymiary planszy i liczbę graczy, czyści ją
+ * funkcją @ref gamma_reset, zeruje jej liczniki pracy i ustawia nowy limit
+ * obszarów. W przeciwnym razie usuwa ją i tworzy nową funkcją @ref gamma_new.
+ * @param[in] g       – wskaźnik na grę do ponownego użycia lub NULL,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wskaźnik na grę w stanie początkowym lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny (gra @p g
+ * jest wtedy usunięta).
+ */
+gamma_t* gamma_reuse(gamma_t *g, uint32_t width, uint32_t height,
+                     uint32_t players, uint32_t areas);
+
+/** @brief Zwalnia pamięć pomocniczą gry.
+ * Usuwa stos i znaczniki odwiedzin używane przy złotych ruchach oraz pamięć
+ * podręczną z funkcji @ref gamma_split_count. Stan gry się nie zmienia,
+ * a struktury zostaną odtworzone, gdy znów będą potrzebne, w rozmiarze
+ * wystarczającym dla przeglądanych obszarów. Nic nie robi, jeśli wskaźnik
+ * @p g ma wartość NULL.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_shrink(gamma_t *g);
+
+/** @brief Tworzy kopię stanu gry.
+ * Funkcja wywołująca musi usunąć kopię funkcją @ref gamma_delete.
+ * Pamięć podręczna z funkcji @ref gamma_split_count nie jest kopiowana.
+ * @param[in] g       – wskaźnik na kopiowaną strukturę.
+ * @return Wskaźnik na nową strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub wskaźnik @p g ma wartość NULL.
+ */
+gamma_t* gamma_copy(gamma_t *g);
+
+/** @brief Kopiuje stan gry do istniejącej struktury.
+ * Obie struktury muszą mieć te same wymiary planszy i liczbę graczy.
+ * Nie alokuje pamięci dla planszy, dlatego nadaje się do wielokrotnego
+ * odtwarzania stanu gry, np. w przeszukiwaniu drzewa gry.
+ * @param[in,out] dst – wskaźnik na strukturę docelową,
+ * @param[in] src     – wskaźnik na kopiowaną strukturę.
+ * @return Wartość @p true, jeśli stan został skopiowany, a @p false, gdy
+ * struktury mają różne rozmiary lub któryś wskaźnik ma wartość NULL.
+ */
+bool gamma_copy_into(gamma_t *dst, gamma_t *src);
+
 /** @brief Wykonuje ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
@@ -76,6 +146,44 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/** @brief Wyznacza pola, na których gracz może wykonać złoty ruch.
+ * Jednym przejściem wyznacza punkty artykulacji obszarów wszystkich pozostałych
+ * graczy i dla każdego zajętego pola sprawdza, czy złoty ruch gracza @p player
+ * na to pole nie przekroczy limitu obszarów żadnego gracza. Przegląda tylko
+ * kawałki planszy, na których zajęto jakieś pole, więc działa w czasie
+ * liniowym względem zajętej części planszy, zamiast wykonywać próbny złoty
+ * ruch na każdym polu. Funkcja wywołująca musi zwolnić zwróconą tablicę.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[out] count  – liczba wyznaczonych pól.
+ * @return Wskaźnik na zaalokowaną tablicę współrzędnych pól, na których
+ * @ref gamma_golden_move gracza @p player się powiedzie, lub NULL, gdy
+ * któryś z parametrów jest niepoprawny lub nie udało się zaalokować pamięci.
+ */
+pair* gamma_golden_targets(gamma_t *g, uint32_t player, uint64_t *count);
+
+/** Wynik funkcji @ref gamma_split_count, gdy zabrakło pamięci. */
+#define GAMMA_SPLIT_NOMEM UINT32_MAX
+
+/** @brief Podaje, na ile części rozpadnie się obszar po usunięciu pola.
+ * Przy pierwszym wywołaniu buduje pamięć podręczną punktów artykulacji
+ * (drzewo bloków każdego obszaru), którą potem zwykłe ruchy aktualizują
+ * przyrostowo, a złoty ruch przebudowuje tylko w obszarze, którego dotknął.
+ * Kolejne zapytania działają w czasie stałym. Pamięć podręczną wykorzystują
+ * też funkcje @ref gamma_golden_move i @ref gamma_golden_targets.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
+ *                      @p width z funkcji @ref gamma_new,
+ * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
+ *                      @p height z funkcji @ref gamma_new.
+ * @return Liczba części, na które rozpadnie się obszar zawierający pole
+ * (@p x, @p y) po usunięciu z niego tego pola, zero, gdy pole jest wolne lub
+ * któryś z parametrów jest niepoprawny, albo @ref GAMMA_SPLIT_NOMEM, gdy nie
+ * udało się zaalokować pamięci.
+ */
+uint32_t gamma_split_count(gamma_t *g, uint32_t x, uint32_t y);
+
 /** @brief Podaje liczbę pól zajętych przez gracza.
  * Podaje liczbę pól zajętych przez gracza @p player.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -97,6 +205,23 @@ uint64_t gamma_busy_fields(gamma_t *g, uint32_t player);
  */
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
 
+/** @brief Wypisuje pola, na których gracz może wykonać ruch.
+ * Zapisuje do bufora @p buf co najwyżej @p cap pól, na których w danym stanie
+ * gry gracz @p player może postawić pionek funkcją @ref gamma_move.
+ * Gdy gracz ma już maksymalną liczbę obszarów, pola bierzemy wprost z jego
+ * pogranicza, więc czas działania jest proporcjonalny do liczby wypisanych pól.
+ * W przeciwnym razie przeglądamy planszę. Wszystkie pola otrzymamy, podając
+ * @p cap równe wynikowi funkcji @ref gamma_free_fields.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[out] buf    – bufor na współrzędne pól,
+ * @param[in] cap     – rozmiar bufora.
+ * @return Liczba zapisanych pól lub zero, jeśli któryś z parametrów jest
+ * niepoprawny.
+ */
+uint64_t gamma_legal_moves(gamma_t *g, uint32_t player, pair *buf, uint64_t cap);
+
 /** @brief Sprawdza, czy gracz może wykonać złoty ruch.
  * Sprawdza, czy gracz @p player jeszcze nie wykonał w tej rozgrywce złotego
  * ruchu i jest przynajmniej jedno pole zajęte przez innego gracza.
@@ -109,17 +234,249 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/** @brief Ruch do wykonania funkcją @ref gamma_apply_moves. */
+typedef struct move_t {
+    uint32_t player;    ///< Numer gracza.
+    uint32_t x;         ///< Numer kolumny.
+    uint32_t y;         ///< Numer wiersza.
+    bool golden;        ///< Czy ruch jest złoty.
+} move_t;
+
+/** @brief Wykonuje ciąg ruchów.
+ * Daje te same wyniki co kolejne wywołania @ref gamma_move albo
+ * @ref gamma_golden_move, ale najpierw sprawdza numery graczy i współrzędne
+ * całego ciągu, a w trakcie wykonywania ruchu sprowadza do pamięci podręcznej
+ * pole jednego z następnych ruchów. Ruchy na dużej planszy nie czekają wtedy
+ * na pamięć, a koszt wywołania rozkłada się na cały ciąg.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] moves   – tablica ruchów,
+ * @param[in] n       – liczba ruchów,
+ * @param[out] results – tablica @p n wyników: jeden, jeśli ruch został
+ *                      wykonany, a zero w przeciwnym przypadku.
+ * @return Liczba wykonanych ruchów lub zero, jeśli któryś wskaźnik ma
+ * wartość NULL (wyniki są wtedy zerami, o ile @p results nie jest NULL).
+ */
+size_t gamma_apply_moves(gamma_t *g, const move_t *moves, size_t n,
+                         uint8_t *results);
+
+/** @brief Rozpoczyna tryb współbieżnych ruchów.
+ * W tym trybie wiele wątków naraz może wykonywać ruchy funkcją
+ * @ref gamma_move_concurrent. Ruchy różnych graczy wykonują się równolegle,
+ * także gdy łączą obszary, bo obszar składa się z pól jednego gracza. Ruchy
+ * jednego gracza wykonują się po kolei. Do wywołania @ref gamma_concurrent_end
+ * nie wolno wywoływać innych funkcji zmieniających grę ani pytać o jej stan,
+ * a funkcje takie jak @ref gamma_read_player czekają na koniec trybu.
+ * Pogranicza graczy i pamięć podręczna punktów artykulacji zostaną
+ * odbudowane przy pierwszym użyciu po zakończeniu trybu.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli tryb się rozpoczął, a @p false, gdy
+ * wskaźnik @p g ma wartość NULL, tryb już trwa lub zabrakło pamięci.
+ */
+bool gamma_concurrent_begin(gamma_t *g);
+
+/** @brief Wykonuje ruch w trybie współbieżnych ruchów.
+ * Działa jak @ref gamma_move i można ją wywoływać z wielu wątków naraz po
+ * wywołaniu @ref gamma_concurrent_begin. Gdy dwa wątki stawiają pionek na
+ * tym samym polu, udaje się dokładnie jeden z tych ruchów.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
+ * gdy ruch jest nielegalny, któryś z parametrów jest niepoprawny lub tryb
+ * współbieżnych ruchów nie trwa.
+ */
+bool gamma_move_concurrent(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Kończy tryb współbieżnych ruchów.
+ * Wszystkie wątki muszą już zakończyć wywołania @ref gamma_move_concurrent.
+ * Nic nie robi, jeśli wskaźnik @p g ma wartość NULL lub tryb nie trwa.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_concurrent_end(gamma_t *g);
+
+/** @brief Rodzaj zapytania funkcji @ref gamma_query. */
+typedef enum query_kind {
+    QUERY_BUSY,         ///< Jak @ref gamma_busy_fields.
+    QUERY_FREE,         ///< Jak @ref gamma_free_fields.
+    QUERY_GOLDEN        ///< Jak @ref gamma_golden_possible.
+} query_kind;
+
+/** @brief Zapytanie o stan gracza dla funkcji @ref gamma_query. */
+typedef struct query_t {
+    query_kind kind;    ///< Rodzaj zapytania.
+    uint32_t player;    ///< Numer gracza.
+} query_t;
+
+/** @brief Odpowiada na ciąg zapytań o stan graczy.
+ * Daje te same wyniki co kolejne wywołania @ref gamma_busy_fields,
+ * @ref gamma_free_fields i @ref gamma_golden_possible. Liczbę wolnych pól
+ * planszy i liczbę graczy, którzy zajęli jakieś pole, liczy raz dla całego
+ * ciągu.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] queries – tablica zapytań,
+ * @param[in] n       – liczba zapytań,
+ * @param[out] results – tablica @p n wyników.
+ */
+void gamma_query(gamma_t *g, const query_t *queries, size_t n, uint64_t *results);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy. Przykład znajduje się w pliku gamma_test.c.
  * Funkcja wywołująca musi zwolnić ten bufor.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
  * @return Wskaźnik na zaalokowany bufor zawierający napis opisujący stan
- * planszy lub NULL, jeśli nie udało się zaalokować pamięci.
+ * planszy lub NULL, jeśli nie udało się zaalokować pamięci (także gdy
+ * rozmiar napisu nie mieści się w typie @p size_t).
  */
 char* gamma_board(gamma_t *g);
 
+/** @brief Daje napis opisujący prostokąt planszy.
+ * Napis wygląda jak w funkcji @ref gamma_board, ale zawiera tylko pola
+ * o numerach kolumn od @p x0 do @p x1 i numerach wierszy od @p y0 do @p y1
+ * (włącznie). Szerokość pola jest taka jak dla całej planszy, więc każdy
+ * wiersz napisu jest fragmentem wiersza napisu całej planszy. Napis powstaje
+ * wprost z pól planszy, a jego rozmiar zależy tylko od rozmiaru prostokąta.
+ * Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x0      – numer pierwszej kolumny,
+ * @param[in] y0      – numer pierwszego wiersza,
+ * @param[in] x1      – numer ostatniej kolumny, mniejszy od szerokości planszy,
+ * @param[in] y1      – numer ostatniego wiersza, mniejszy od wysokości planszy.
+ * @return Wskaźnik na zaalokowany bufor z napisem lub NULL, jeśli prostokąt
+ * jest pusty lub wychodzi poza planszę albo nie udało się zaalokować pamięci.
+ */
+char* gamma_board_region(gamma_t *g, uint32_t x0, uint32_t y0,
+                         uint32_t x1, uint32_t y1);
+
+/** @brief Daje napis opisujący prostokąt planszy kodowaniem długości serii.
+ * Każdy wiersz prostokąta, od najwyższego, to jedna linia z odcinkami
+ * kolejnych pól tego samego właściciela, oddzielonymi spacjami: @p N. to
+ * N wolnych pól, a @p N*P to N pól gracza P. Na przykład wiersz
+ * <tt>..11.2</tt> to <tt>2. 2*1 1. 1*2</tt>. Pola kawałków planszy, które
+ * nie zostały jeszcze utworzone, są pomijane naraz, więc napis dla dużej
+ * i prawie pustej planszy powstaje szybko i jest krótki.
+ * Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x0      – numer pierwszej kolumny,
+ * @param[in] y0      – numer pierwszego wiersza,
+ * @param[in] x1      – numer ostatniej kolumny, mniejszy od szerokości planszy,
+ * @param[in] y1      – numer ostatniego wiersza, mniejszy od wysokości planszy.
+ * @return Wskaźnik na zaalokowany bufor z napisem lub NULL, jeśli prostokąt
+ * jest pusty lub wychodzi poza planszę albo nie udało się zaalokować pamięci.
+ */
+char* gamma_board_rle(gamma_t *g, uint32_t x0, uint32_t y0,
+                      uint32_t x1, uint32_t y1);
+
 char* gamma_board_max(gamma_t *g);
 
+/** @brief Podaje właściciela pola, także w trakcie ruchów innego wątku.
+ * Jak @ref gamma_player, ale można ją wywoływać z wielu wątków naraz, gdy
+ * jeden wątek zmienia stan gry funkcjami @ref gamma_move,
+ * @ref gamma_golden_move, @ref gamma_apply_moves, @ref gamma_reset lub
+ * @ref gamma_copy_into. Odczyt nie zmienia struktury gry, a jego spójność
+ * potwierdza licznik zmian stanu gry (seqlock): jeżeli w trakcie odczytu
+ * wykonano ruch, odczyt jest powtarzany. Zmieniający wątek na czytelników
+ * nie czeka. Grę można usunąć dopiero po zakończeniu wszystkich odczytów.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ * @return Numer gracza zajmującego pole lub zero, gdy pole jest wolne lub
+ * któryś z parametrów jest niepoprawny.
+ */
+uint32_t gamma_read_player(gamma_t *g, uint32_t x, uint32_t y);
+
+/** @brief Podaje liczbę pól gracza, także w trakcie ruchów innego wątku.
+ * Jak @ref gamma_busy_fields, z tymi samymi gwarancjami co
+ * @ref gamma_read_player.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza.
+ * @return Liczba pól zajętych przez gracza lub zero, jeśli któryś
+ * z parametrów jest niepoprawny.
+ */
+uint64_t gamma_read_busy_fields(gamma_t *g, uint32_t player);
+
+/** @brief Daje napis opisujący planszę, także w trakcie ruchów innego wątku.
+ * Jak @ref gamma_board, z tymi samymi gwarancjami co @ref gamma_read_player.
+ * Napis opisuje stan planszy między dwoma ruchami. Jeżeli w trakcie jego
+ * tworzenia wykonano ruch, napis jest tworzony od nowa, więc przy bardzo
+ * dużej planszy i ciągłych ruchach odczyt może długo czekać.
+ * Funkcja wywołująca musi zwolnić ten bufor.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wskaźnik na zaalokowany bufor z napisem lub NULL, jeśli nie udało
+ * się zaalokować pamięci.
+ */
+char* gamma_read_board(gamma_t *g);
+
+/** @brief Liczniki pracy wykonanej przez silnik.
+ * Liczniki są zbierane tylko wtedy, gdy silnik skompilowano z makrem
+ * @p GAMMA_STATS (opcja CMake o tej samej nazwie). W przeciwnym razie
+ * nie zajmują pamięci ani czasu.
+ */
+typedef struct gamma_counters {
+    uint64_t find_hops;         ///< Krawędzie przebyte przez find.
+    uint64_t path_writes;       ///< Zmiany rodzica przy kompresji ścieżek.
+    uint64_t unions;            ///< Połączenia dwóch różnych obszarów.
+    uint64_t reset_cells;       ///< Pola odwiedzone przy resetowaniu obszaru.
+    uint64_t union_cells;       ///< Pola odwiedzone przy ponownym łączeniu obszaru.
+    uint64_t memset_bytes;      ///< Bajty wyczyszczone funkcją memset.
+    uint64_t free_scans;        ///< Przeglądy całej planszy w gamma_free_fields.
+    uint64_t golden_local;      /**< @brief Złote ruchy bez przebudowy obszaru.
+                                 * Usunięte pole nie było rodzicem żadnego
+                                 * pola, a jego otoczenie pokazało, że obszar
+                                 * właściciela się nie rozpadnie.
+                                 */
+    uint64_t golden_rejected;   ///< Odrzucone złote ruchy.
+    uint64_t golden_rollbacks;  /**< @brief Złote ruchy wycofane po przebudowie.
+                                 * Część odrzuconych złotych ruchów, dla
+                                 * których odrzucenie wyszło dopiero po
+                                 * przebudowaniu obszaru właściciela.
+                                 */
+} gamma_counters;
+
+/** @brief Podaje liczniki pracy silnika.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – miejsce na liczniki.
+ * @return Wartość @p true, jeżeli liczniki zostały zapisane, lub @p false,
+ * gdy wskaźnik @p g ma wartość NULL albo silnik skompilowano bez liczników.
+ */
+bool gamma_stats(gamma_t *g, gamma_counters *out);
+
+/** @brief Zeruje liczniki pracy silnika.
+ * Nic nie robi, jeśli wskaźnik @p g ma wartość NULL lub silnik skompilowano
+ * bez liczników.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ */
+void gamma_stats_reset(gamma_t *g);
+
+/** @brief Zapisuje stan gry do pliku.
+ * Zapisuje planszę (właścicieli pól i drzewa find & union), liczniki graczy
+ * i skrót stanu gry w wersjonowanym formacie binarnym z liczbami w kolejności
+ * little-endian. Zapisywane są tylko kawałki planszy, na których zajęto
+ * jakieś pole. W zapisie skompresowanym właściciele pól są zapisani seriami,
+ * a drzewa find & union są odtwarzane przy wczytywaniu.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fd       – deskryptor pliku otwartego do zapisu,
+ * @param[in] compress – czy zapisać właścicieli pól seriami.
+ * @return Wartość @p true, jeśli stan został zapisany, a @p false, gdy
+ * wskaźnik @p g ma wartość NULL, zabrakło pamięci lub zapis się nie udał.
+ */
+bool gamma_save(gamma_t *g, int fd, bool compress);
+
+/** @brief Wczytuje stan gry zapisany funkcją @ref gamma_save.
+ * Odwzorowuje plik w pamięci. Nieskompresowany zapis na komputerze
+ * little-endian jest używany wprost: kawałki planszy zostają w odwzorowanym
+ * pliku (zmiany trafiają do prywatnych kopii stron, plik się nie zmienia),
+ * więc czas wczytania zależy od liczby kawałków, a nie od długości gry.
+ * W tym przypadku sprawdzany jest tylko nagłówek i numery kawałków, dlatego
+ * plik musi pochodzić z funkcji @ref gamma_save. Zapis z innym układem pól
+ * kawałka (opcja GAMMA_MORTON) jest wczytywany przez kopiowanie pól.
+ * Pogranicza graczy są odbudowywane przy pierwszym użyciu.
+ * @param[in] path     – ścieżka do pliku.
+ * @return Wskaźnik na wczytaną strukturę lub NULL, gdy nie udało się otworzyć
+ * pliku, plik jest niepoprawny lub zabrakło pamięci.
+ */
+gamma_t* gamma_load(const char *path);
+
 uint16_t how_many_digits(uint32_t x);
 #endif /* GAMMA_H */
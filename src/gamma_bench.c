@@ -0,0 +1,1123 @@
+/** @file
+ * Testy wydajności silnika gry gamma
+ *
+ * Uruchamia powtarzalne (zależne tylko od ziarna) scenariusze obciążenia
+ * i mierzy osobno czas każdego wywołania @ref gamma_move,
+ * @ref gamma_golden_move, @ref gamma_free_fields, @ref gamma_board oraz
+ * linii parsera trybu wsadowego. Wyniki wypisuje w formacie JSON: liczbę
+ * operacji na sekundę oraz medianę i 99. percentyl czasu operacji, a dla
+ * ogromnej planszy także zajętą pamięć.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gamma.h"
+#include "new_parser.h"
+#include "rng.h"
+
+/** Największa liczba zapamiętywanych pomiarów jednej operacji. */
+#define MAX_SAMPLES (1u << 22)
+/** Liczba wywołań @ref gamma_board w jednym scenariuszu. */
+#define BOARD_REPEATS 5
+/** Co ile ruchów mierzymy @ref gamma_free_fields. */
+#define FREE_FIELDS_EVERY 16
+/** Największa liczba pól planszy huge_sparse, dla której mierzymy @ref gamma_board. */
+#define HUGE_BOARD_MAX_CELLS (1ull << 26)
+/** Liczba złotych ruchów w scenariuszu flood_fill. */
+#define FLOOD_MOVES 8
+/** Największa liczba wątków czytających w scenariuszu spectators. */
+#define MAX_SPECTATORS 4
+/** Największa liczba wątków wykonujących ruchy w scenariuszu free_for_all. */
+#define MAX_MOVERS 4
+
+#ifdef GAMMA_GENERIC
+/** Czy mierzony silnik ma wyspecjalizowane operacje dla plansz turniejowych. */
+#define ENGINES "generic"
+#else
+/** Czy mierzony silnik ma wyspecjalizowane operacje dla plansz turniejowych. */
+#define ENGINES "fixed"
+#endif
+
+#ifdef GAMMA_MORTON
+/** Układ pól kawałka planszy w mierzonym silniku. */
+#define LAYOUT "morton"
+#else
+/** Układ pól kawałka planszy w mierzonym silniku. */
+#define LAYOUT "column"
+#endif
+
+/** @brief Parametry testów. */
+typedef struct bench_config {
+    uint64_t seed;          ///< Ziarno generatora.
+    uint64_t ops;           ///< Liczba operacji w scenariuszu.
+    uint32_t size;          ///< Bok planszy w zwykłych scenariuszach.
+    uint32_t huge;          ///< Bok planszy w scenariuszu huge_sparse.
+    uint32_t large;         ///< Bok planszy w scenariuszach flood_fill i find_heavy.
+    const char* only;       ///< Nazwa jedynego uruchamianego scenariusza, albo NULL.
+} bench_config;
+
+/** @brief Pomiary jednej operacji w jednym scenariuszu. */
+typedef struct samples {
+    uint64_t* ns;           ///< Czasy operacji w nanosekundach.
+    uint64_t count;         ///< Liczba zapamiętanych pomiarów.
+    uint64_t ops;           ///< Liczba wszystkich operacji.
+    uint64_t total_ns;      ///< Łączny czas operacji.
+    rng r;                  ///< Generator do losowania próbki pomiarów.
+} samples;
+
+/** @brief Czy wypisano już jakiś wynik (do stawiania przecinków). */
+static bool printed_any = false;
+
+/** @brief Podaje czas zegara monotonicznego.
+ * @return Czas w nanosekundach.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/** @brief Przygotowuje pustą serię pomiarów.
+ * @param[out] s        - seria pomiarów
+ * @param[in] seed      - ziarno generatora próbki
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool samples_init(samples *s, uint64_t seed) {
+    memset(s, 0, sizeof(samples));
+    rng_seed(&s->r, seed);
+    s->ns = malloc(MAX_SAMPLES * sizeof(uint64_t));
+
+    return s->ns != NULL;
+}
+
+/** @brief Dopisuje pomiar.
+ * Gdy pomiarów jest więcej niż @ref MAX_SAMPLES, zachowujemy ich
+ * jednostajnie wylosowaną próbkę.
+ * @param[in,out] s     - seria pomiarów
+ * @param[in] ns        - czas operacji w nanosekundach
+ */
+static void samples_add(samples *s, uint64_t ns) {
+    s->ops++;
+    s->total_ns += ns;
+
+    if (s->count < MAX_SAMPLES) {
+        s->ns[s->count++] = ns;
+    }
+    else {
+        uint64_t i = rng_below(&s->r, s->ops);
+
+        if (i < MAX_SAMPLES)
+            s->ns[i] = ns;
+    }
+}
+
+/** @brief Porównuje liczby dla funkcji qsort.
+ * @param[in] a         - wskaźnik na pierwszą liczbę
+ * @param[in] b         - wskaźnik na drugą liczbę
+ * @return Liczba ujemna, zero lub dodatnia, gdy pierwsza liczba jest
+ * odpowiednio mniejsza, równa lub większa.
+ */
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/** @brief Wypisuje wynik serii jako obiekt JSON i zwalnia jej pamięć.
+ * @param[in,out] s         - seria pomiarów
+ * @param[in] workload      - nazwa scenariusza
+ * @param[in] operation     - nazwa operacji
+ */
+static void samples_report(samples *s, const char *workload, const char *operation) {
+    uint64_t p50 = 0, p99 = 0, max = 0;
+    double seconds = s->total_ns * 1e-9;
+
+    if (s->count > 0) {
+        qsort(s->ns, s->count, sizeof(uint64_t), compare_u64);
+        p50 = s->ns[s->count / 2];
+        p99 = s->ns[(s->count * 99) / 100];
+        max = s->ns[s->count - 1];
+    }
+
+    printf("%s\n    {\"workload\": \"%s\", \"operation\": \"%s\", \"ops\": %lu, "
+           "\"seconds\": %.6f, \"ops_per_sec\": %.1f, \"p50_ns\": %lu, "
+           "\"p99_ns\": %lu, \"max_ns\": %lu}",
+           printed_any ? "," : "", workload, operation, s->ops, seconds,
+           seconds > 0 ? s->ops / seconds : 0, p50, p99, max);
+    printed_any = true;
+
+    free(s->ns);
+    s->ns = NULL;
+}
+
+/** @brief Mierzy czas wyrażenia i dopisuje go do serii.
+ * @param[in,out] s     - seria pomiarów
+ * @param[in] expr      - mierzone wyrażenie
+ */
+#define TIMED(s, expr)                          \
+    do {                                        \
+        uint64_t timed_start_ = now_ns();       \
+        expr;                                   \
+        samples_add((s), now_ns() - timed_start_); \
+    } while (0)
+
+/** @brief Serie pomiarów operacji silnika w jednym scenariuszu. */
+typedef struct engine_samples {
+    samples move;           ///< Pomiary @ref gamma_move.
+    samples golden;         ///< Pomiary @ref gamma_golden_move.
+    samples free_fields;    ///< Pomiary @ref gamma_free_fields.
+    samples board;          ///< Pomiary @ref gamma_board.
+} engine_samples;
+
+/** @brief Przygotowuje serie pomiarów scenariusza.
+ * @param[out] e        - serie pomiarów
+ * @param[in] seed      - ziarno generatora próbek
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool engine_samples_init(engine_samples *e, uint64_t seed) {
+    bool ok = samples_init(&e->move, seed) & samples_init(&e->golden, seed + 1) &
+              samples_init(&e->free_fields, seed + 2) & samples_init(&e->board, seed + 3);
+
+    if (!ok) {
+        free(e->move.ns);
+        free(e->golden.ns);
+        free(e->free_fields.ns);
+        free(e->board.ns);
+    }
+
+    return ok;
+}
+
+/** @brief Wypisuje niepuste serie pomiarów scenariusza.
+ * @param[in,out] e         - serie pomiarów
+ * @param[in] workload      - nazwa scenariusza
+ */
+static void engine_samples_report(engine_samples *e, const char *workload) {
+    samples *all[] = {&e->move, &e->golden, &e->free_fields, &e->board};
+    const char *names[] = {"gamma_move", "gamma_golden_move",
+                           "gamma_free_fields", "gamma_board"};
+
+    for (int i = 0; i < 4; i++) {
+        if (all[i]->ops > 0)
+            samples_report(all[i], workload, names[i]);
+        else
+            free(all[i]->ns);
+    }
+}
+
+/** @brief Mierzy @ref gamma_free_fields losowego gracza.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ */
+static void time_free_fields(gamma_t *g, rng *r, engine_samples *e) {
+    uint32_t player = 1 + rng_below(r, gamma_how_many_players(g));
+    volatile uint64_t sink;
+
+    TIMED(&e->free_fields, sink = gamma_free_fields(g, player));
+    (void)sink;
+}
+
+/** @brief Mierzy kilka wywołań @ref gamma_board.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in,out] e     - serie pomiarów
+ */
+static void time_board(gamma_t *g, engine_samples *e) {
+    char *board;
+
+    for (int i = 0; i < BOARD_REPEATS; i++) {
+        TIMED(&e->board, board = gamma_board(g));
+        free(board);
+    }
+}
+
+/** @brief Wykonuje losowe ruchy losowych graczy.
+ * Próby ruchu na zajęte pola lub ponad limit obszarów też są mierzone,
+ * bo w prawdziwych rozgrywkach zdarzają się równie często.
+ * @param[in,out] g     - wskaźnik na grę
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in] ops       - liczba prób ruchu
+ * @param[in,out] e     - serie pomiarów
+ */
+static void random_moves(gamma_t *g, rng *r, uint64_t ops, engine_samples *e) {
+    uint32_t width = gamma_width(g), height = gamma_height(g);
+    uint32_t players = gamma_how_many_players(g);
+
+    for (uint64_t i = 0; i < ops; i++) {
+        uint32_t player = 1 + rng_below(r, players);
+        uint32_t x = rng_below(r, width), y = rng_below(r, height);
+
+        TIMED(&e->move, gamma_move(g, player, x, y));
+
+        if (i % FREE_FIELDS_EVERY == 0)
+            time_free_fields(g, r, e);
+    }
+}
+
+/** @brief Scenariusz losowego zapełniania planszy.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool random_fill(const bench_config *config, rng *r, engine_samples *e) {
+    gamma_t *g = gamma_new(config->size, config->size, 8, config->size);
+
+    if (g == NULL)
+        return false;
+
+    random_moves(g, r, config->ops, e);
+    time_board(g, e);
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Scenariusz jednego obszaru rosnącego wężykiem lub spiralą.
+ * Gracz 1 ma limit jednego obszaru i zajmuje kolejne pola ścieżki, więc
+ * każdy ruch łączy się z całym dotychczasowym obszarem. Gracz 2 nie ma
+ * żadnych pól, więc @ref gamma_free_fields dla niego przegląda planszę.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @param[in] spiral    - czy ścieżka jest spiralą (w przeciwnym razie wężykiem)
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool path_fill(const bench_config *config, rng *r, engine_samples *e, bool spiral) {
+    uint32_t n = config->size;
+    gamma_t *g = gamma_new(n, n, 2, 1);
+    int64_t x = 0, y = 0, dx = 1, dy = 0;
+    int64_t left = 0, right = n - 1, top = 0, bottom = n - 1;
+    uint64_t steps = (uint64_t)n * n < config->ops ? (uint64_t)n * n : config->ops;
+
+    if (g == NULL)
+        return false;
+
+    for (uint64_t i = 0; i < steps; i++) {
+        TIMED(&e->move, gamma_move(g, 1, x, y));
+
+        if (i % FREE_FIELDS_EVERY == 0)
+            time_free_fields(g, r, e);
+
+        if (!spiral) {
+            /* Wężyk: kolejne wiersze na przemian w prawo i w lewo. */
+            if ((dx > 0 && x == right) || (dx < 0 && x == left)) {
+                y++;
+                dx = -dx;
+            }
+            else {
+                x += dx;
+            }
+        }
+        else {
+            /* Spirala: obchodzimy brzeg i zwężamy prostokąt. */
+            if (dx > 0 && x == right) {
+                top++;
+                dx = 0;
+                dy = 1;
+            }
+            else if (dy > 0 && y == bottom) {
+                right--;
+                dx = -1;
+                dy = 0;
+            }
+            else if (dx < 0 && x == left) {
+                bottom--;
+                dx = 0;
+                dy = -1;
+            }
+            else if (dy < 0 && y == top) {
+                left++;
+                dx = 1;
+                dy = 0;
+            }
+            x += dx;
+            y += dy;
+        }
+    }
+
+    time_board(g, e);
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Zapełnia planszę kwadratami graczy.
+ * Plansza jest podzielona na 16 x 16 kwadratów, a każdy gracz dostaje
+ * jeden, losowo wybrany kwadrat, który zajmuje w całości.
+ * @param[in,out] g     - wskaźnik na grę z 256 graczami
+ * @param[in,out] r     - generator liczb losowych
+ */
+static void tile_fill(gamma_t *g, rng *r) {
+    uint32_t n = gamma_width(g), tile = n / 16, owner[256];
+
+    for (uint32_t i = 0; i < 256; i++)
+        owner[i] = i + 1;
+
+    for (uint32_t i = 255; i > 0; i--) {
+        uint32_t j = rng_below(r, i + 1), tmp = owner[i];
+
+        owner[i] = owner[j];
+        owner[j] = tmp;
+    }
+
+    for (uint32_t x = 0; x < 16 * tile; x++) {
+        for (uint32_t y = 0; y < 16 * tile; y++)
+            gamma_move(g, owner[(x / tile) * 16 + y / tile], x, y);
+    }
+}
+
+/** @brief Scenariusz serii złotych ruchów.
+ * Plansza jest zapełniona kwadratami 256 graczy o limicie czterech
+ * obszarów, a gracze próbują złotych ruchów na losowe zajęte pola. Część
+ * prób jest odrzucana, bo rozspójniłaby obszar właściciela lub gracza
+ * ponad limit. Gdy wszyscy gracze wykonają złoty ruch, zaczynamy od nowej
+ * planszy (poza pomiarem).
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool golden_storm(const bench_config *config, rng *r, engine_samples *e) {
+    uint32_t n = config->size < 16 ? 16 : config->size;
+    uint32_t players = 256, remaining = 0;
+    gamma_t *g = gamma_new(n, n, players, 4);
+    bool done;
+
+    if (g == NULL)
+        return false;
+
+    for (uint64_t i = 0; i < config->ops; i++) {
+        uint32_t player = 1 + rng_below(r, players);
+        uint32_t x = rng_below(r, n), y = rng_below(r, n);
+
+        if (remaining == 0) {
+            gamma_reset(g);
+            tile_fill(g, r);
+            remaining = players;
+        }
+
+        if (!gamma_golden_possible(g, player) || gamma_player(g, x, y) == 0)
+            continue;
+
+        TIMED(&e->golden, done = gamma_golden_move(g, player, x, y));
+
+        if (done)
+            remaining--;
+    }
+
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Scenariusz planszy z bardzo wieloma graczami.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool many_players(const bench_config *config, rng *r, engine_samples *e) {
+    gamma_t *g = gamma_new(config->size, config->size, 100000, 2);
+
+    if (g == NULL)
+        return false;
+
+    random_moves(g, r, config->ops, e);
+    time_board(g, e);
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Podaje rozmiar pamięci rezydentnej procesu.
+ * @return Liczba bajtów lub zero, gdy nie udało się jej odczytać.
+ */
+static uint64_t resident_bytes(void) {
+    FILE *statm = fopen("/proc/self/statm", "r");
+    unsigned long size, resident = 0;
+
+    if (statm == NULL)
+        return 0;
+
+    if (fscanf(statm, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+
+    fclose(statm);
+
+    return (uint64_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+/** @brief Wypisuje jako obiekt JSON pamięć zajętą przez grę.
+ * @param[in] workload      - nazwa scenariusza
+ * @param[in] g             - wskaźnik na grę
+ * @param[in] before        - pamięć rezydentna przed utworzeniem gry
+ */
+static void memory_report(const char *workload, gamma_t *g, uint64_t before) {
+    uint64_t after = resident_bytes();
+
+    printf("%s\n    {\"workload\": \"%s\", \"operation\": \"memory\", "
+           "\"cells\": %lu, \"busy_fields\": %lu, \"rss_bytes\": %lu}",
+           printed_any ? "," : "", workload,
+           (uint64_t)gamma_width(g) * gamma_height(g),
+           gamma_busy_fields(g, 1) + gamma_busy_fields(g, 2) +
+           gamma_busy_fields(g, 3) + gamma_busy_fields(g, 4),
+           after > before ? after - before : 0);
+    printed_any = true;
+}
+
+/** @brief Scenariusz ogromnej, prawie pustej planszy.
+ * Plansza może mieć więcej niż 2^32 pól. Napis z planszą mierzymy tylko
+ * wtedy, gdy zmieści się w rozsądnej ilości pamięci.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool huge_sparse(const bench_config *config, rng *r, engine_samples *e) {
+    uint64_t before = resident_bytes();
+    gamma_t *g = gamma_new(config->huge, config->huge, 4, UINT32_MAX);
+    char *board;
+
+    if (g == NULL)
+        return false;
+
+    random_moves(g, r, config->ops, e);
+    memory_report("huge_sparse", g, before);
+
+    if ((uint64_t)config->huge * config->huge <= HUGE_BOARD_MAX_CELLS) {
+        TIMED(&e->board, board = gamma_board(g));
+        free(board);
+    }
+
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Scenariusz złotych ruchów w jednym ogromnym obszarze.
+ * Gracz 1 zajmuje całą planszę poza polami o obu współrzędnych nieparzystych
+ * (poza pomiarem), a kolejni gracze wykonują złote ruchy na losowe jego pola
+ * w parzystych kolumnach. Dzięki wolnym polom otoczenie żadnego pola nie
+ * rozstrzyga, czy obszar się rozpadnie, więc każdy ruch dwa razy przechodzi cały
+ * obszar gracza 1 (@p reset_parents_area i @p update_unions_on_area), a przy
+ * domyślnym boku plansza nie mieści się w pamięci podręcznej ostatniego
+ * poziomu, więc wynik zależy głównie od układu pól w pamięci.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool flood_fill(const bench_config *config, rng *r, engine_samples *e) {
+    uint32_t n = config->large;
+    gamma_t *g = gamma_new(n, n, FLOOD_MOVES + 1, UINT32_MAX);
+
+    if (g == NULL)
+        return false;
+
+    for (uint32_t x = 0; x < n; x++) {
+        for (uint32_t y = 0; y < n; y += 1 + x % 2)
+            gamma_move(g, 1, x, y);
+    }
+
+    for (uint32_t player = 2; player <= FLOOD_MOVES + 1; player++)
+        TIMED(&e->golden, gamma_golden_move(g, player, 2 * rng_below(r, (n + 1) / 2),
+                                            rng_below(r, n)));
+
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Podaje największy wspólny dzielnik liczb.
+ * @param[in] a         - pierwsza liczba
+ * @param[in] b         - druga liczba
+ * @return Największy wspólny dzielnik.
+ */
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t t = a % b;
+
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/** @brief Scenariusz łączenia obszarów w losowej kolejności.
+ * Dwaj gracze zajmują wszystkie pola planszy w kolejności permutacji
+ * i -> i * step mod liczba pól, więc ruchy łączą coraz większe obszary,
+ * a find idzie po polach odległych w pamięci. Mierzymy każdy ruch.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool find_heavy(const bench_config *config, rng *r, engine_samples *e) {
+    uint32_t n = config->large;
+    uint64_t cells = (uint64_t)n * n, step, field = 0;
+    gamma_t *g = gamma_new(n, n, 2, UINT32_MAX);
+
+    if (g == NULL)
+        return false;
+
+    do {
+        step = cells / 2 + rng_below(r, cells / 2 + 1);
+    } while (gcd(step, cells) != 1);
+
+    for (uint64_t i = 0; i < cells; i++) {
+        uint32_t player = 1 + rng_below(r, 2);
+
+        TIMED(&e->move, gamma_move(g, player, field / n, field % n));
+        field = (field + step) % cells;
+    }
+
+    gamma_delete(g);
+
+    return true;
+}
+
+/** @brief Tworzy losowy skrypt trybu wsadowego.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[out] length   - długość skryptu
+ * @return Skrypt, zaalokowany napis, lub NULL, gdy zabrakło pamięci.
+ */
+static char* make_script(const bench_config *config, rng *r, size_t *length) {
+    char *script = NULL;
+    FILE *out = open_memstream(&script, length);
+    uint32_t n = config->size, players = 8;
+
+    if (out == NULL)
+        return NULL;
+
+    fprintf(out, "B %u %u %u %u\n", n, n, players, n);
+
+    for (uint64_t i = 0; i < config->ops; i++) {
+        uint32_t p = 1 + rng_below(r, players);
+        uint64_t kind = rng_below(r, 100000);
+
+        if (kind < 60000)
+            fprintf(out, "m %u %u %u\n", p, (uint32_t)rng_below(r, n), (uint32_t)rng_below(r, n));
+        else if (kind < 70000)
+            fprintf(out, "g %u %u %u\n", p, (uint32_t)rng_below(r, n), (uint32_t)rng_below(r, n));
+        else if (kind < 80000)
+            fprintf(out, "b %u\n", p);
+        else if (kind < 90000)
+            fprintf(out, "f %u\n", p);
+        else if (kind < 99990)
+            fprintf(out, "q %u\n", p);
+        else
+            fprintf(out, "p\n");
+    }
+
+    if (fclose(out) != 0) {
+        free(script);
+        return NULL;
+    }
+
+    return script;
+}
+
+/** @brief Scenariusz parsera trybu wsadowego.
+ * Mierzy czas przetworzenia każdej linii razem z wykonaniem polecenia
+ * i sformatowaniem wyniku. Wyniki trafiają do /dev/null.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool batch_parser(const bench_config *config, rng *r) {
+    size_t length, line_length;
+    char *script = make_script(config, r, &length), *line = NULL, *begin, *end;
+    FILE *sink = fopen("/dev/null", "w");
+    batch_state state;
+    samples s;
+    size_t capacity = 0;
+
+    if (script == NULL || sink == NULL || !samples_init(&s, config->seed)) {
+        free(script);
+        if (sink != NULL)
+            fclose(sink);
+        return false;
+    }
+
+    batch_init(&state, sink, sink);
+
+    for (begin = script; begin < script + length; begin = end + 1) {
+        end = memchr(begin, '\n', script + length - begin);
+        line_length = end - begin + 1;
+
+        /* Parser zmienia linię, więc pracuje na kopii. */
+        if (line_length + 1 > capacity) {
+            capacity = 2 * (line_length + 1);
+            free(line);
+            line = malloc(capacity);
+            if (line == NULL)
+                break;
+        }
+        memcpy(line, begin, line_length);
+        line[line_length] = '\0';
+
+        TIMED(&s, batch_line(&state, line, line_length));
+    }
+
+    samples_report(&s, "batch_parser", "batch_line");
+
+    batch_free(&state);
+    fclose(sink);
+    free(line);
+    free(script);
+
+    return true;
+}
+
+/** @brief Scenariusz rozgrywek na planszach turniejowych.
+ * Na planszach 8x8, 19x19 i 64x64, dla których silnik ma wyspecjalizowane
+ * operacje, czterech graczy zajmuje po kolei wszystkie pola w losowej
+ * kolejności, aż wykonają łącznie około @p ops ruchów na każdym rozmiarze.
+ * Ruch na takiej planszy trwa krócej niż pomiar czasu, więc mierzymy całe
+ * rozgrywki, a operacją w wynikach jest jedna gra.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool tournament(const bench_config *config, rng *r) {
+    static const uint32_t sizes[] = {8, 19, 64};
+    static const char *names[] = {"game_8x8", "game_19x19", "game_64x64"};
+    uint32_t order[64 * 64], n, t, j;
+    gamma_t *g;
+    samples s;
+
+    for (int i = 0; i < 3; i++) {
+        n = sizes[i];
+        g = gamma_new(n, n, 4, n);
+
+        if (g == NULL || !samples_init(&s, config->seed)) {
+            gamma_delete(g);
+            return false;
+        }
+
+        for (uint32_t k = 0; k < n * n; k++)
+            order[k] = k;
+
+        for (uint64_t games = (config->ops + n * n - 1) / (n * n); games > 0; games--) {
+            for (uint32_t k = n * n - 1; k > 0; k--) {
+                j = rng_below(r, k + 1);
+                t = order[k];
+                order[k] = order[j];
+                order[j] = t;
+            }
+
+            gamma_reset(g);
+
+            TIMED(&s, for (uint32_t k = 0; k < n * n; k++)
+                          gamma_move(g, 1 + k % 4, order[k] / n, order[k] % n));
+        }
+
+        samples_report(&s, "tournament", names[i]);
+        gamma_delete(g);
+    }
+
+    return true;
+}
+
+/** @brief Wspólny stan wątków scenariusza spectators. */
+typedef struct spectators_state {
+    gamma_t* g;             ///< Gra zmieniana przez wątek piszący.
+    uint64_t ops;           ///< Liczba odczytów jednego czytelnika.
+    uint64_t seed;          ///< Ziarno generatorów czytelników.
+    atomic_bool stop;       ///< Czy wątek piszący ma skończyć.
+    uint64_t moves;         ///< Liczba ruchów wątku piszącego.
+} spectators_state;
+
+/** @brief Argument wątku czytającego scenariusza spectators. */
+typedef struct spectator {
+    spectators_state* state; ///< Wspólny stan scenariusza.
+    uint64_t id;            ///< Numer czytelnika.
+    uint64_t sum;           ///< Suma odczytów, żeby ich nie pominąć.
+} spectator;
+
+/** @brief Wątek piszący: zapełnia planszę losowymi ruchami, aż do zatrzymania.
+ * @param[in,out] arg   - wskaźnik na @ref spectators_state
+ * @return NULL.
+ */
+static void* spectators_writer(void *arg) {
+    spectators_state *state = arg;
+    uint32_t n = gamma_width(state->g);
+    rng r;
+
+    rng_seed(&r, state->seed);
+
+    while (!atomic_load_explicit(&state->stop, memory_order_relaxed)) {
+        if (gamma_busy_fields(state->g, 1) + gamma_busy_fields(state->g, 2) +
+            gamma_busy_fields(state->g, 3) + gamma_busy_fields(state->g, 4) >
+            (uint64_t)n * n / 2)
+            gamma_reset(state->g);
+
+        gamma_move(state->g, 1 + rng_below(&r, 4), rng_below(&r, n), rng_below(&r, n));
+        state->moves++;
+    }
+
+    return NULL;
+}
+
+/** @brief Wątek czytający: odczytuje właścicieli losowych pól.
+ * @param[in,out] arg   - wskaźnik na @ref spectator
+ * @return NULL.
+ */
+static void* spectators_reader(void *arg) {
+    spectator *me = arg;
+    uint32_t n = gamma_width(me->state->g);
+    rng r;
+
+    rng_seed(&r, me->state->seed + 1 + me->id);
+
+    for (uint64_t i = 0; i < me->state->ops; i++)
+        me->sum += gamma_read_player(me->state->g, rng_below(&r, n), rng_below(&r, n));
+
+    return NULL;
+}
+
+/** @brief Scenariusz odczytów w trakcie ruchów innego wątku.
+ * Jeden wątek wykonuje losowe ruchy, a 1, 2 i 4 wątki czytające wykonują
+ * po @p ops wywołań @ref gamma_read_player. Odczyt trwa krócej niż pomiar
+ * czasu, więc mierzymy łączny czas czytelników i wypisujemy liczbę odczytów
+ * na sekundę oraz liczbę ruchów wykonanych w tym czasie.
+ * @param[in] config    - parametry testów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci
+ * lub nie udało się utworzyć wątku.
+ */
+static bool spectators(const bench_config *config) {
+    spectators_state state;
+    spectator readers[MAX_SPECTATORS];
+    pthread_t writer, threads[MAX_SPECTATORS];
+    uint64_t start, ns;
+    bool ok = true;
+
+    for (int count = 1; ok && count <= MAX_SPECTATORS; count *= 2) {
+        int started = 0;
+
+        state.g = gamma_new(config->size, config->size, 4, config->size);
+        state.ops = config->ops;
+        state.seed = config->seed;
+        state.moves = 0;
+        atomic_init(&state.stop, false);
+
+        if (state.g == NULL || pthread_create(&writer, NULL, spectators_writer, &state) != 0) {
+            gamma_delete(state.g);
+            return false;
+        }
+
+        start = now_ns();
+
+        for (; started < count; started++) {
+            readers[started] = (spectator){&state, started, 0};
+
+            if (pthread_create(&threads[started], NULL, spectators_reader,
+                               &readers[started]) != 0) {
+                ok = false;
+                break;
+            }
+        }
+
+        for (int i = 0; i < started; i++)
+            pthread_join(threads[i], NULL);
+
+        ns = now_ns() - start;
+        atomic_store(&state.stop, true);
+        pthread_join(writer, NULL);
+
+        printf("%s\n    {\"workload\": \"spectators\", \"operation\": "
+               "\"gamma_read_player\", \"readers\": %d, \"ops\": %lu, "
+               "\"seconds\": %.6f, \"ops_per_sec\": %.1f, \"writer_moves\": %lu}",
+               printed_any ? "," : "", count, count * config->ops, ns * 1e-9,
+               ns > 0 ? count * config->ops / (ns * 1e-9) : 0, state.moves);
+        printed_any = true;
+
+        gamma_delete(state.g);
+    }
+
+    return ok;
+}
+
+/** @brief Argument wątku scenariusza free_for_all. */
+typedef struct mover {
+    gamma_t* g;             ///< Wspólna gra.
+    uint32_t first;         ///< Pierwszy gracz wątku.
+    uint32_t step;          ///< Odstęp między kolejnymi graczami wątku.
+    uint64_t ops;           ///< Liczba ruchów wątku.
+    uint64_t seed;          ///< Ziarno generatora wątku.
+    uint64_t taken;         ///< Liczba udanych ruchów.
+} mover;
+
+/** @brief Wątek wykonujący losowe ruchy swoimi graczami.
+ * @param[in,out] arg   - wskaźnik na @ref mover
+ * @return NULL.
+ */
+static void* free_for_all_mover(void *arg) {
+    mover *me = arg;
+    uint32_t n = gamma_width(me->g);
+    uint32_t players = MAX_MOVERS / me->step;
+    rng r;
+
+    rng_seed(&r, me->seed);
+
+    for (uint64_t i = 0; i < me->ops; i++) {
+        uint32_t player = me->first + me->step * rng_below(&r, players);
+
+        me->taken += gamma_move_concurrent(me->g, player, rng_below(&r, n),
+                                           rng_below(&r, n));
+    }
+
+    return NULL;
+}
+
+/** @brief Scenariusz równoległych ruchów różnych graczy.
+ * Czterech graczy wykonuje łącznie @p ops losowych ruchów
+ * @ref gamma_move_concurrent w 1, 2 i 4 wątkach; wątek @p i gra graczami
+ * przystającymi do @p i modulo liczba wątków. Wypisujemy liczbę ruchów
+ * na sekundę.
+ * @param[in] config    - parametry testów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci
+ * lub nie udało się utworzyć wątku.
+ */
+static bool free_for_all(const bench_config *config) {
+    mover movers[MAX_MOVERS];
+    pthread_t threads[MAX_MOVERS];
+    uint64_t start, ns, taken;
+    bool ok = true;
+
+    for (uint32_t count = 1; ok && count <= MAX_MOVERS; count *= 2) {
+        gamma_t *g = gamma_new(config->size, config->size, MAX_MOVERS, UINT32_MAX);
+        uint32_t started = 0;
+
+        if (g == NULL || !gamma_concurrent_begin(g)) {
+            gamma_delete(g);
+            return false;
+        }
+
+        start = now_ns();
+
+        for (; started < count; started++) {
+            movers[started] = (mover){g, started + 1, count, config->ops / count,
+                                      config->seed + started, 0};
+
+            if (pthread_create(&threads[started], NULL, free_for_all_mover,
+                               &movers[started]) != 0) {
+                ok = false;
+                break;
+            }
+        }
+
+        taken = 0;
+        for (uint32_t i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+            taken += movers[i].taken;
+        }
+
+        ns = now_ns() - start;
+        gamma_concurrent_end(g);
+
+        printf("%s\n    {\"workload\": \"free_for_all\", \"operation\": "
+               "\"gamma_move_concurrent\", \"threads\": %u, \"ops\": %lu, "
+               "\"seconds\": %.6f, \"ops_per_sec\": %.1f, \"taken\": %lu}",
+               printed_any ? "," : "", count, config->ops / count * count, ns * 1e-9,
+               ns > 0 ? config->ops / count * count / (ns * 1e-9) : 0, taken);
+        printed_any = true;
+
+        gamma_delete(g);
+    }
+
+    return ok;
+}
+
+/** @brief Scenariusz operacji silnika. */
+typedef bool (*engine_workload)(const bench_config *, rng *, engine_samples *);
+
+/** @brief Uruchamia scenariusz operacji silnika i wypisuje jego wyniki.
+ * @param[in] config    - parametry testów
+ * @param[in] name      - nazwa scenariusza
+ * @param[in] run       - funkcja scenariusza
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool run_engine_workload(const bench_config *config, const char *name,
+                                engine_workload run) {
+    engine_samples e;
+    rng r;
+    bool ok;
+
+    if (config->only != NULL && strcmp(config->only, name) != 0)
+        return true;
+
+    rng_seed(&r, config->seed);
+
+    if (!engine_samples_init(&e, config->seed))
+        return false;
+
+    ok = run(config, &r, &e);
+    engine_samples_report(&e, name);
+
+    return ok;
+}
+
+/** @brief Scenariusz ścieżki wężykiem.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool snake(const bench_config *config, rng *r, engine_samples *e) {
+    return path_fill(config, r, e, false);
+}
+
+/** @brief Scenariusz ścieżki spiralą.
+ * @param[in] config    - parametry testów
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in,out] e     - serie pomiarów
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool spiral(const bench_config *config, rng *r, engine_samples *e) {
+    return path_fill(config, r, e, true);
+}
+
+/** @brief Szacuje narzut pojedynczego pomiaru czasu.
+ * @return Mediana czasu pustego pomiaru w nanosekundach.
+ */
+static uint64_t timer_overhead(void) {
+    uint64_t ns[1001];
+
+    for (int i = 0; i < 1001; i++) {
+        uint64_t start = now_ns();
+        ns[i] = now_ns() - start;
+    }
+
+    qsort(ns, 1001, sizeof(uint64_t), compare_u64);
+
+    return ns[500];
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-s seed] [-n ops] [-S size] [-H huge_size] [-L large_size]\n"
+            "          [-w workload]\n"
+            "workloads: random_fill snake spiral golden_storm many_players\n"
+            "           huge_sparse flood_fill find_heavy tournament batch_parser\n"
+            "           spectators free_for_all\n", name);
+}
+
+/** @brief Odczytuje parametry testów.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @param[out] config   - parametry testów
+ * @return Wartość @p true, jeżeli argumenty są poprawne.
+ */
+static bool parse_config(int argc, char *argv[], bench_config *config) {
+    char *end;
+    uint64_t value;
+    int option;
+
+    config->seed = 1;
+    config->ops = 200000;
+    config->size = 512;
+    config->huge = 4096;
+    config->large = 4096;
+    config->only = NULL;
+
+    while ((option = getopt(argc, argv, "s:n:S:H:L:w:")) != -1) {
+        if (option == 'w') {
+            config->only = optarg;
+            continue;
+        }
+
+        if (option == '?' || *optarg < '0' || *optarg > '9')
+            return false;
+
+        value = strtoull(optarg, &end, 10);
+        if (*end != '\0')
+            return false;
+
+        if (option != 's' && (value == 0 || (option != 'n' && value > UINT32_MAX)))
+            return false;
+
+        switch (option) {
+            case 's': config->seed = value; break;
+            case 'n': config->ops = value; break;
+            case 'S': config->size = value; break;
+            case 'H': config->huge = value; break;
+            case 'L': config->large = value; break;
+            default: return false;
+        }
+    }
+
+    return optind == argc;
+}
+
+/** @brief Uruchamia testy wydajności.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @return Zero, gdy testy się powiodły, jeden w przeciwnym wypadku.
+ */
+int main(int argc, char *argv[]) {
+    bench_config config;
+    bool ok = true;
+    rng r;
+
+    if (!parse_config(argc, argv, &config)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("{\n  \"seed\": %lu, \"ops\": %lu, \"size\": %u, \"huge_size\": %u, "
+           "\"large_size\": %u, \"layout\": \"%s\", \"engines\": \"%s\",\n"
+           "  \"timer_overhead_ns\": %lu,\n"
+           "  \"results\": [",
+           config.seed, config.ops, config.size, config.huge, config.large, LAYOUT,
+           ENGINES, timer_overhead());
+
+    ok = ok && run_engine_workload(&config, "random_fill", random_fill);
+    ok = ok && run_engine_workload(&config, "snake", snake);
+    ok = ok && run_engine_workload(&config, "spiral", spiral);
+    ok = ok && run_engine_workload(&config, "golden_storm", golden_storm);
+    ok = ok && run_engine_workload(&config, "many_players", many_players);
+    ok = ok && run_engine_workload(&config, "huge_sparse", huge_sparse);
+    ok = ok && run_engine_workload(&config, "flood_fill", flood_fill);
+    ok = ok && run_engine_workload(&config, "find_heavy", find_heavy);
+
+    if (ok && (config.only == NULL || strcmp(config.only, "tournament") == 0)) {
+        rng_seed(&r, config.seed);
+        ok = tournament(&config, &r);
+    }
+
+    if (ok && (config.only == NULL || strcmp(config.only, "batch_parser") == 0)) {
+        rng_seed(&r, config.seed);
+        ok = batch_parser(&config, &r);
+    }
+
+    if (ok && (config.only == NULL || strcmp(config.only, "spectators") == 0))
+        ok = spectators(&config);
+
+    if (ok && (config.only == NULL || strcmp(config.only, "free_for_all") == 0))
+        ok = free_for_all(&config);
+
+    printf("\n  ]\n}\n");
+
+    if (!ok)
+        fprintf(stderr, "out of memory\n");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,776 @@
+/** @file
+ * Różnicowe sprawdzanie silnika gry gamma
+ *
+ * Rozgrywa na puli wątków wiele losowych ciągów wywołań jednocześnie na
+ * silniku z gamma.h i na wzorcowej implementacji z gamma_ref.h, porównując
+ * każdy zwrócony wynik. Po każdym wywołaniu porównuje też wyniki
+ * @ref gamma_split_count, @ref gamma_query, @ref gamma_legal_moves
+ * i @ref gamma_golden_targets, a część ruchów wykonuje funkcją
+ * @ref gamma_apply_moves. Ciągi zawierają także niepoprawne wywołania
+ * (zły numer gracza, pole poza planszą) oraz zapisy i wczytania gry
+ * funkcjami @ref gamma_save i @ref gamma_load. Parametry każdego ciągu zależą
+ * tylko od ziarna i numeru ciągu, więc znalezioną rozbieżność można
+ * odtworzyć opcją -i, która wypisuje wszystkie wywołania tego ciągu.
+ * Na końcu sprawdza, że @ref gamma_read_board w innym wątku nie widzi planszy
+ * w trakcie złotego ruchu.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "gamma.h"
+#include "gamma_ref.h"
+#include "rng.h"
+#include "thread_pool.h"
+
+/** Oznaczenie ciągu, w którym nie znaleziono rozbieżności. */
+#define NO_MISMATCH UINT64_MAX
+/** Liczba graczy w sprawdzaniu odczytów w trakcie złotych ruchów. */
+#define TORN_PLAYERS 9
+/** Najmniejsza liczba odczytów planszy w sprawdzaniu złotych ruchów. */
+#define TORN_READS 20000
+/** Najmniejsza liczba udanych złotych ruchów w trakcie tych odczytów. */
+#define TORN_GOLDEN 300000
+/** Największa liczba ruchów w jednym wywołaniu @ref gamma_apply_moves. */
+#define BATCH_MOVES 4
+/** Liczba zapytań w jednym wywołaniu @ref gamma_query. */
+#define QUERIES 6
+
+/** @brief Parametry sprawdzania. */
+typedef struct diff_config {
+    uint32_t max_width;         ///< Największa szerokość planszy.
+    uint32_t max_height;        ///< Największa wysokość planszy.
+    uint32_t max_players;       ///< Największa liczba graczy.
+    uint32_t max_areas;         ///< Największy limit obszarów.
+    uint64_t sequences;         ///< Liczba losowych ciągów.
+    uint64_t steps;             ///< Liczba wywołań w jednym ciągu.
+    uint32_t threads;           ///< Liczba wątków.
+    uint64_t seed;              ///< Ziarno generatora.
+    uint64_t only;              ///< Numer jedynego ciągu do odtworzenia.
+    bool trace;                 ///< Czy wypisywać wywołania (opcja -i).
+} diff_config;
+
+/** @brief Dane jednego wątku. */
+typedef struct diff_worker {
+    uint64_t calls;             ///< Liczba porównanych wywołań.
+    uint64_t sequence;          ///< Najmniejszy ciąg z rozbieżnością.
+    uint64_t step;              ///< Numer wywołania z rozbieżnością.
+    char what[128];             ///< Opis rozbieżnego wywołania.
+    bool failed;                ///< Czy zabrakło pamięci.
+} diff_worker;
+
+/** @brief Kontekst przekazywany do zadań puli. */
+typedef struct diff_context {
+    const diff_config* config;  ///< Parametry sprawdzania.
+    diff_worker* workers;       ///< Dane wątków.
+    atomic_bool stop;           ///< Czy znaleziono już rozbieżność.
+} diff_context;
+
+/** @brief Plansza jednego ciągu i pomocnicze tablice jej rozmiaru. */
+typedef struct diff_board {
+    uint32_t width;             ///< Szerokość planszy.
+    uint32_t height;            ///< Wysokość planszy.
+    uint32_t players;           ///< Liczba graczy.
+    pair* fields;               ///< Pola zwrócone przez sprawdzaną funkcję.
+    bool* seen;                 ///< Znaczniki pól (x, y) pod indeksem x * height + y.
+} diff_board;
+
+/** @brief Losuje argument wywołania, czasem spoza poprawnego zakresu.
+ * @param[in,out] r     - generator
+ * @param[in] first     - najmniejsza poprawna wartość
+ * @param[in] count     - liczba poprawnych wartości
+ * @return Wartość z przedziału [first, first + count), a z małym
+ * prawdopodobieństwem wartość tuż poza nim lub UINT32_MAX.
+ */
+static uint32_t random_argument(rng *r, uint32_t first, uint32_t count) {
+    uint64_t roll = rng_below(r, 64);
+
+    if (roll == 0)
+        return UINT32_MAX;
+    if (roll == 1)
+        return first + count;
+    if (roll == 2 && first > 0)
+        return first - 1;
+
+    return first + rng_below(r, count);
+}
+
+/** @brief Zapisuje rozbieżność, jeżeli jest pierwszą w wątku.
+ * @param[in,out] worker    - dane wątku
+ * @param[in] sequence      - numer ciągu
+ * @param[in] step          - numer wywołania
+ * @param[in] what          - opis wywołania
+ */
+static void record_mismatch(diff_worker *worker, uint64_t sequence,
+                            uint64_t step, const char *what) {
+    if (sequence < worker->sequence) {
+        worker->sequence = sequence;
+        worker->step = step;
+        snprintf(worker->what, sizeof(worker->what), "%s", what);
+    }
+}
+
+/** @brief Porównuje wynik wywołania z wynikiem wzorca.
+ * @param[in] what      - opis wywołania
+ * @param[in] got       - wynik sprawdzanej gry
+ * @param[in] expected  - wynik gry wzorcowej
+ * @param[in] trace     - czy wypisać wywołanie
+ * @return Wartość @p true, jeżeli wyniki są równe.
+ */
+static bool same_result(const char *what, uint64_t got, uint64_t expected,
+                        bool trace) {
+    if (trace)
+        printf("    %s = %lu, expected %lu\n", what, got, expected);
+
+    return got == expected;
+}
+
+/** @brief Sprawdza, że pola są dokładnie tymi, które przyjmuje wzorzec.
+ * Pola muszą leżeć na planszy i się nie powtarzać, a każde musi być
+ * przyjęte przez @p accept.
+ * @param[in] ref       - wskaźnik na grę wzorcową
+ * @param[in] player    - numer gracza, argument @p accept
+ * @param[in] count     - liczba pól w @p b->fields
+ * @param[in,out] b     - plansza ciągu, po wywołaniu znaczniki są wyzerowane
+ * @param[in] accept    - funkcja wzorca przyjmująca pole
+ * @return Wartość @p true, jeżeli pola są poprawne.
+ */
+static bool same_fields(gamma_ref *ref, uint32_t player, uint64_t count,
+                        diff_board *b,
+                        bool (*accept)(gamma_ref *, uint32_t, uint32_t, uint32_t)) {
+    uint64_t checked = 0;
+    bool out = true;
+
+    for (; out && checked < count; checked++) {
+        pair field = b->fields[checked];
+        uint64_t i = (uint64_t)field.fst * b->height + field.snd;
+
+        out = field.fst < b->width && field.snd < b->height && !b->seen[i] &&
+              accept(ref, player, field.fst, field.snd);
+
+        if (out)
+            b->seen[i] = true;
+    }
+
+    while (checked-- > 0) {
+        pair field = b->fields[checked];
+
+        if (field.fst < b->width && field.snd < b->height)
+            b->seen[(uint64_t)field.fst * b->height + field.snd] = false;
+    }
+
+    return out;
+}
+
+/** @brief Porównuje pola, na które gracz może wykonać złoty ruch.
+ * @param[in] g         - wskaźnik na sprawdzaną grę
+ * @param[in] ref       - wskaźnik na grę wzorcową
+ * @param[in] player    - numer gracza, także niepoprawny
+ * @param[in,out] b     - plansza ciągu
+ * @param[in] trace     - czy wypisać wywołanie
+ * @param[out] what     - opis wywołania, gdy wyniki się różnią
+ * @param[in] size      - rozmiar bufora @p what
+ * @return Wartość @p true, jeżeli wyniki są zgodne.
+ */
+static bool same_golden_targets(gamma_t *g, gamma_ref *ref, uint32_t player,
+                                diff_board *b, bool trace, char *what, size_t size) {
+    uint64_t count = 0, expected = 0;
+    pair *targets = gamma_golden_targets(g, player, &count);
+    bool out;
+
+    for (uint32_t x = 0; x < b->width; x++) {
+        for (uint32_t y = 0; y < b->height; y++)
+            expected += ref_golden_target(ref, player, x, y);
+    }
+
+    snprintf(what, size, "gamma_golden_targets(%u)", player);
+
+    /* Dla niepoprawnego gracza wynikiem jest NULL. */
+    if (player == 0 || player > b->players) {
+        out = same_result(what, targets == NULL, true, trace);
+    }
+    else {
+        out = same_result(what, targets == NULL ? 0 : count, expected, trace) &&
+              targets != NULL;
+
+        if (out) {
+            memcpy(b->fields, targets, count * sizeof(pair));
+            snprintf(what, size, "gamma_golden_targets(%u) fields", player);
+            out = same_result(what, same_fields(ref, player, count, b,
+                                                ref_golden_target), true, trace);
+        }
+    }
+
+    free(targets);
+
+    return out;
+}
+
+/** @brief Porównuje wyniki zapytań, które nie zmieniają stanu gry.
+ * Sprawdza @ref gamma_golden_targets, @ref gamma_legal_moves z losowym
+ * ograniczeniem liczby pól, @ref gamma_query dla gracza i losowego drugiego
+ * gracza oraz @ref gamma_split_count dla pola (@p x, @p y).
+ * @param[in] g         - wskaźnik na sprawdzaną grę
+ * @param[in] ref       - wskaźnik na grę wzorcową
+ * @param[in,out] r     - generator
+ * @param[in] player    - numer gracza, także niepoprawny
+ * @param[in] x         - numer kolumny, także niepoprawny
+ * @param[in] y         - numer wiersza, także niepoprawny
+ * @param[in,out] b     - plansza ciągu
+ * @param[in] trace     - czy wypisać wywołania
+ * @param[out] what     - opis wywołania, gdy wyniki się różnią
+ * @param[in] size      - rozmiar bufora @p what
+ * @return Wartość @p true, jeżeli wszystkie wyniki są zgodne.
+ */
+static bool same_queries(gamma_t *g, gamma_ref *ref, rng *r, uint32_t player,
+                         uint32_t x, uint32_t y, diff_board *b, bool trace,
+                         char *what, size_t size) {
+    static const char *kinds[] = {"QUERY_BUSY", "QUERY_FREE", "QUERY_GOLDEN"};
+    uint64_t cap = rng_below(r, (uint64_t)b->width * b->height + 1);
+    uint64_t count, expected, answers[QUERIES];
+    query_t queries[QUERIES];
+
+    if (!same_golden_targets(g, ref, player, b, trace, what, size))
+        return false;
+
+    count = gamma_legal_moves(g, player, b->fields, cap);
+    expected = ref_free_fields(ref, player);
+    if (expected > cap)
+        expected = cap;
+
+    snprintf(what, size, "gamma_legal_moves(%u, %lu)", player, cap);
+    if (!same_result(what, count, expected, trace))
+        return false;
+
+    snprintf(what, size, "gamma_legal_moves(%u, %lu) fields", player, cap);
+    if (!same_result(what, same_fields(ref, player, count, b, ref_move_legal),
+                     true, trace))
+        return false;
+
+    for (int i = 0; i < QUERIES; i++) {
+        queries[i].kind = (query_kind)(i % 3);
+        queries[i].player = i < 3 ? player : random_argument(r, 1, b->players);
+    }
+
+    gamma_query(g, queries, QUERIES, answers);
+
+    for (int i = 0; i < QUERIES; i++) {
+        uint32_t p = queries[i].player;
+
+        expected = queries[i].kind == QUERY_BUSY ? ref_busy_fields(ref, p) :
+                   queries[i].kind == QUERY_FREE ? ref_free_fields(ref, p) :
+                   ref_golden_possible(ref, p);
+
+        snprintf(what, size, "gamma_query(%s, %u)", kinds[queries[i].kind], p);
+        if (!same_result(what, answers[i], expected, trace))
+            return false;
+    }
+
+    snprintf(what, size, "gamma_split_count(%u, %u)", x, y);
+
+    return same_result(what, gamma_split_count(g, x, y),
+                       ref_split_count(ref, x, y), trace);
+}
+
+/** @brief Wykonuje kilka ruchów funkcją @ref gamma_apply_moves i porównuje wyniki.
+ * Pierwszym ruchem jest @p first, a pozostałe są losowe.
+ * @param[in,out] g     - wskaźnik na sprawdzaną grę
+ * @param[in,out] ref   - wskaźnik na grę wzorcową
+ * @param[in,out] r     - generator
+ * @param[in] first     - pierwszy ruch
+ * @param[in] b         - plansza ciągu
+ * @param[out] what     - opis wywołania
+ * @param[in] size      - rozmiar bufora @p what
+ * @return Wartość @p true, jeżeli wyniki wszystkich ruchów są zgodne.
+ */
+static bool same_batch(gamma_t *g, gamma_ref *ref, rng *r, move_t first,
+                       const diff_board *b, char *what, size_t size) {
+    move_t moves[BATCH_MOVES];
+    uint8_t results[BATCH_MOVES];
+    size_t n = 1 + rng_below(r, BATCH_MOVES), done, expected = 0;
+    int length;
+
+    moves[0] = first;
+
+    for (size_t i = 1; i < n; i++) {
+        moves[i].player = random_argument(r, 1, b->players);
+        moves[i].x = random_argument(r, 0, b->width);
+        moves[i].y = random_argument(r, 0, b->height);
+        moves[i].golden = rng_below(r, 4) == 0;
+    }
+
+    length = snprintf(what, size, "gamma_apply_moves(");
+    for (size_t i = 0; i < n && length >= 0 && (size_t)length < size; i++) {
+        length += snprintf(what + length, size - length, "%s{%u, %u, %u, %d}",
+                           i > 0 ? ", " : "", moves[i].player, moves[i].x,
+                           moves[i].y, moves[i].golden);
+    }
+    if (length >= 0 && (size_t)length < size)
+        snprintf(what + length, size - length, ")");
+
+    done = gamma_apply_moves(g, moves, n, results);
+
+    for (size_t i = 0; i < n; i++) {
+        bool made = moves[i].golden ?
+                    ref_golden_move(ref, moves[i].player, moves[i].x, moves[i].y) :
+                    ref_move(ref, moves[i].player, moves[i].x, moves[i].y);
+
+        if (results[i] != made)
+            return false;
+
+        expected += made;
+    }
+
+    return done == expected;
+}
+
+/** @brief Porównuje plansze obu implementacji.
+ * @param[in] g         - wskaźnik na sprawdzaną grę
+ * @param[in] ref       - wskaźnik na grę wzorcową
+ * @param[in] trace     - czy wypisać planszę
+ * @return Wartość @p true, jeżeli plansze są identyczne.
+ */
+static bool same_board(gamma_t *g, gamma_ref *ref, bool trace) {
+    char *board = gamma_board(g), *expected = ref_board(ref);
+    bool out = board != NULL && expected != NULL && strcmp(board, expected) == 0;
+
+    if (trace) {
+        printf("gamma_board:\n%s", board != NULL ? board : "(null)\n");
+        if (!out)
+            printf("expected:\n%s", expected != NULL ? expected : "(null)\n");
+    }
+
+    free(board);
+    free(expected);
+
+    return out;
+}
+
+/** @brief Zastępuje grę jej kopią zapisaną i wczytaną z pliku w pamięci.
+ * @param[in,out] g         - wskaźnik na wskaźnik na grę
+ * @param[in] compress      - czy zapisać grę w postaci skompresowanej
+ * @return Wartość @p true, jeżeli się udało; w przeciwnym razie gra
+ * pozostaje bez zmian.
+ */
+static bool reload(gamma_t **g, bool compress) {
+    int fd = memfd_create("gamma_diff", 0);
+    char path[64];
+    gamma_t *loaded = NULL;
+
+    if (fd < 0)
+        return false;
+
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+
+    if (gamma_save(*g, fd, compress))
+        loaded = gamma_load(path);
+
+    close(fd);
+
+    if (loaded == NULL)
+        return false;
+
+    gamma_delete(*g);
+    *g = loaded;
+
+    return true;
+}
+
+/** @brief Sprawdza jeden losowy ciąg wywołań - zadanie puli wątków.
+ * @param[in,out] context   - kontekst sprawdzania
+ * @param[in] id            - numer wątku
+ * @param[in] index         - numer ciągu
+ */
+static void check_sequence(void *context, uint32_t id, uint64_t index) {
+    diff_context *diff = context;
+    const diff_config *config = diff->config;
+    diff_worker *worker = &diff->workers[id];
+    uint32_t width, height, players, areas;
+    diff_board b;
+    gamma_t *g;
+    gamma_ref *ref;
+    rng r;
+
+    if (worker->failed || atomic_load_explicit(&diff->stop, memory_order_relaxed))
+        return;
+
+    rng_seed(&r, config->seed ^ (index * 0x9e3779b97f4a7c15ULL));
+
+    width = 1 + rng_below(&r, config->max_width);
+    height = 1 + rng_below(&r, config->max_height);
+    players = 1 + rng_below(&r, config->max_players);
+    areas = 1 + rng_below(&r, config->max_areas);
+
+    g = gamma_new(width, height, players, areas);
+    ref = ref_new(width, height, players, areas);
+    b.width = width;
+    b.height = height;
+    b.players = players;
+    b.fields = malloc((uint64_t)width * height * sizeof(pair));
+    b.seen = calloc((uint64_t)width * height, sizeof(bool));
+
+    if (g == NULL || ref == NULL || b.fields == NULL || b.seen == NULL) {
+        gamma_delete(g);
+        ref_delete(ref);
+        free(b.fields);
+        free(b.seen);
+        worker->failed = true;
+        return;
+    }
+
+    if (config->trace)
+        printf("gamma_new(%u, %u, %u, %u)\n", width, height, players, areas);
+
+    for (uint64_t step = 0; step <= config->steps; step++) {
+        uint32_t player = random_argument(&r, 1, players);
+        uint32_t x = random_argument(&r, 0, width);
+        uint32_t y = random_argument(&r, 0, height);
+        uint64_t roll = rng_below(&r, 100), got, expected;
+        char what[128];
+
+        /* Ostatnie wywołanie zawsze porównuje całą planszę. */
+        if (step == config->steps)
+            roll = 99;
+
+        if (roll < 75 && rng_below(&r, 4) == 0) {
+            move_t first = {player, x, y, roll >= 60};
+
+            got = same_batch(g, ref, &r, first, &b, what, sizeof(what));
+            expected = true;
+        }
+        else if (roll < 60) {
+            got = gamma_move(g, player, x, y);
+            expected = ref_move(ref, player, x, y);
+            snprintf(what, sizeof(what), "gamma_move(%u, %u, %u)", player, x, y);
+        }
+        else if (roll < 75) {
+            got = gamma_golden_move(g, player, x, y);
+            expected = ref_golden_move(ref, player, x, y);
+            snprintf(what, sizeof(what), "gamma_golden_move(%u, %u, %u)", player, x, y);
+        }
+        else if (roll < 83) {
+            got = gamma_busy_fields(g, player);
+            expected = ref_busy_fields(ref, player);
+            snprintf(what, sizeof(what), "gamma_busy_fields(%u)", player);
+        }
+        else if (roll < 91) {
+            got = gamma_free_fields(g, player);
+            expected = ref_free_fields(ref, player);
+            snprintf(what, sizeof(what), "gamma_free_fields(%u)", player);
+        }
+        else if (roll < 96) {
+            got = gamma_golden_possible(g, player);
+            expected = ref_golden_possible(ref, player);
+            snprintf(what, sizeof(what), "gamma_golden_possible(%u)", player);
+        }
+        else if (roll < 97) {
+            /* Zwolnienie pamięci pomocniczej nie może zmienić wyników. */
+            gamma_shrink(g);
+            got = expected = 0;
+            snprintf(what, sizeof(what), "gamma_shrink()");
+        }
+        else if (roll < 98) {
+            got = reload(&g, x % 2 == 0);
+            expected = true;
+            snprintf(what, sizeof(what), "gamma_save(%d), gamma_load()", x % 2 == 0);
+        }
+        else {
+            got = same_board(g, ref, config->trace);
+            expected = true;
+            snprintf(what, sizeof(what), "gamma_board()");
+        }
+
+        worker->calls++;
+
+        if (config->trace)
+            printf("%lu: %s = %lu, expected %lu\n", step, what, got, expected);
+
+        if (got != expected) {
+            record_mismatch(worker, index, step, what);
+            atomic_store_explicit(&diff->stop, true, memory_order_relaxed);
+            break;
+        }
+
+        worker->calls += 4;
+
+        if (!same_queries(g, ref, &r, player, x, y, &b, config->trace,
+                          what, sizeof(what))) {
+            record_mismatch(worker, index, step, what);
+            atomic_store_explicit(&diff->stop, true, memory_order_relaxed);
+            break;
+        }
+
+        /* Zapytanie gamma_split_count tworzy pamięć podręczną punktów
+         * artykulacji. W co drugim ciągu ją usuwamy, żeby złote ruchy
+         * i gamma_golden_targets sprawdzać także bez niej. */
+        if (index % 2 == 1)
+            gamma_shrink(g);
+    }
+
+    gamma_delete(g);
+    ref_delete(ref);
+    free(b.fields);
+    free(b.seen);
+}
+
+/** @brief Wspólny stan sprawdzania odczytów w trakcie złotych ruchów. */
+typedef struct torn_check {
+    gamma_t* g;                 ///< Gra zmieniana przez wątek piszący.
+    uint32_t size;              ///< Bok planszy.
+    uint64_t seed;              ///< Ziarno generatora wątku piszącego.
+    atomic_bool stop;           ///< Czy wątek piszący ma skończyć.
+    _Atomic uint64_t golden;    ///< Liczba udanych złotych ruchów.
+} torn_check;
+
+/** @brief Wątek piszący: zapełnia planszę i wykonuje na niej złote ruchy.
+ * Pola zajmujemy w kolejności, w jakiej występują w napisie planszy, więc
+ * w każdym stanie między ruchami wolne pola tworzą koniec napisu. Złote
+ * ruchy wykonujemy tylko na pełnej planszy, a potem ją czyścimy.
+ * @param[in,out] arg   - wskaźnik na @ref torn_check
+ * @return NULL.
+ */
+static void* torn_writer(void *arg) {
+    torn_check *check = arg;
+    uint32_t n = check->size;
+    rng r;
+
+    rng_seed(&r, check->seed);
+
+    while (!atomic_load_explicit(&check->stop, memory_order_relaxed)) {
+        for (uint32_t i = 0; i < n * n; i++)
+            gamma_move(check->g, 1 + i % TORN_PLAYERS, i % n, n - 1 - i / n);
+
+        for (uint32_t player = 1; player <= TORN_PLAYERS; player++) {
+            if (gamma_golden_move(check->g, player, rng_below(&r, n), rng_below(&r, n)))
+                atomic_fetch_add_explicit(&check->golden, 1, memory_order_relaxed);
+        }
+
+        gamma_reset(check->g);
+    }
+
+    return NULL;
+}
+
+/** @brief Sprawdza, że odczyty planszy nie widzą stanu w trakcie złotego ruchu.
+ * Złoty ruch najpierw usuwa pole właściciela, a potem stawia na nim pionek
+ * gracza, więc odczyt w jego trakcie zobaczyłby wolne pole przed zajętymi.
+ * @param[in] size      - bok planszy
+ * @param[in] seed      - ziarno generatora
+ * @param[out] reads    - liczba odczytów planszy
+ * @return Wartość @p true, jeżeli żaden odczyt nie zobaczył takiego stanu,
+ * @p false w przeciwnym razie lub gdy zabrakło pamięci.
+ */
+static bool check_torn_reads(uint32_t size, uint64_t seed, uint64_t *reads) {
+    torn_check check;
+    pthread_t writer;
+    bool ok = true;
+
+    check.g = gamma_new(size, size, TORN_PLAYERS, size * size);
+    check.size = size;
+    check.seed = seed;
+    atomic_init(&check.stop, false);
+    atomic_init(&check.golden, 0);
+    *reads = 0;
+
+    if (check.g == NULL || pthread_create(&writer, NULL, torn_writer, &check) != 0) {
+        gamma_delete(check.g);
+        return false;
+    }
+
+    /* Przy jednym procesorze wątek piszący może jeszcze nie ruszyć, więc
+     * czytamy także do chwili, gdy wykona dość złotych ruchów. */
+    for (; ok && (*reads < TORN_READS ||
+                  atomic_load_explicit(&check.golden, memory_order_relaxed) < TORN_GOLDEN);
+         (*reads)++) {
+        char *board = gamma_read_board(check.g);
+        bool free_seen = false;
+
+        ok = board != NULL;
+
+        for (char *c = board; ok && *c != '\0'; c++) {
+            if (*c == '.')
+                free_seen = true;
+            else if (*c != '\n' && free_seen)
+                ok = false;
+        }
+
+        free(board);
+    }
+
+    atomic_store(&check.stop, true);
+    pthread_join(writer, NULL);
+    gamma_delete(check.g);
+
+    return ok;
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-W max_width] [-H max_height] [-p max_players]\n"
+            "          [-a max_areas] [-n sequences] [-m steps] [-t threads]\n"
+            "          [-s seed] [-i sequence]\n", name);
+}
+
+/** @brief Odczytuje liczbę z argumentu programu.
+ * @param[in] text      - napis z liczbą
+ * @param[out] value    - odczytana liczba
+ * @return Wartość @p true, jeżeli napis jest poprawną liczbą.
+ */
+static bool parse_number(const char *text, uint64_t *value) {
+    char *end;
+
+    if (*text < '0' || *text > '9')
+        return false;
+
+    *value = strtoull(text, &end, 10);
+
+    return *end == '\0';
+}
+
+/** @brief Odczytuje parametry sprawdzania.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @param[out] config   - parametry sprawdzania
+ * @return Wartość @p true, jeżeli argumenty są poprawne.
+ */
+static bool parse_config(int argc, char *argv[], diff_config *config) {
+    uint64_t value = 0;
+    int option;
+
+    config->max_width = 10;
+    config->max_height = 10;
+    config->max_players = 12;
+    config->max_areas = 4;
+    config->sequences = 100000;
+    config->steps = 200;
+    config->threads = pool_default_threads();
+    config->seed = 1;
+    config->only = 0;
+    config->trace = false;
+
+    while ((option = getopt(argc, argv, "W:H:p:a:n:m:t:s:i:")) != -1) {
+        if (option == '?' || !parse_number(optarg, &value))
+            return false;
+
+        if (option != 'n' && option != 'm' && option != 's' && option != 'i' &&
+            (value == 0 || value > UINT32_MAX))
+            return false;
+
+        switch (option) {
+            case 'W': config->max_width = value; break;
+            case 'H': config->max_height = value; break;
+            case 'p': config->max_players = value; break;
+            case 'a': config->max_areas = value; break;
+            case 'n': config->sequences = value; break;
+            case 'm': config->steps = value; break;
+            case 't': config->threads = value; break;
+            case 's': config->seed = value; break;
+            case 'i': config->only = value; config->trace = true; break;
+            default: return false;
+        }
+    }
+
+    return optind == argc;
+}
+
+/** @brief Podaje czas w sekundach.
+ * @return Czas zegara monotonicznego w sekundach.
+ */
+static double now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** @brief Uruchamia sprawdzanie.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @return Zero, gdy nie znaleziono rozbieżności, jeden w przeciwnym wypadku.
+ */
+int main(int argc, char *argv[]) {
+    diff_config config;
+    diff_context context;
+    diff_worker *first = NULL;
+    uint64_t calls = 0;
+    double start, seconds;
+    bool failed = false, torn = false;
+
+    if (!parse_config(argc, argv, &config)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    context.config = &config;
+    atomic_init(&context.stop, false);
+    context.workers = calloc(config.threads, sizeof(diff_worker));
+    if (context.workers == NULL)
+        return 1;
+
+    for (uint32_t i = 0; i < config.threads; i++)
+        context.workers[i].sequence = NO_MISMATCH;
+
+    start = now();
+    if (config.trace)
+        check_sequence(&context, 0, config.only);
+    else if (!pool_run(config.threads, config.sequences, check_sequence, &context))
+        failed = true;
+    seconds = now() - start;
+
+    for (uint32_t i = 0; i < config.threads; i++) {
+        diff_worker *w = &context.workers[i];
+
+        failed |= w->failed;
+        calls += w->calls;
+
+        if (w->sequence != NO_MISMATCH &&
+            (first == NULL || w->sequence < first->sequence))
+            first = w;
+    }
+
+    if (failed) {
+        fprintf(stderr, "out of memory\n");
+    }
+    else if (first != NULL) {
+        printf("mismatch in sequence %lu (seed %lu), step %lu: %s\n"
+               "rerun with -s %lu -i %lu to trace it\n",
+               first->sequence, config.seed, first->step, first->what,
+               config.seed, first->sequence);
+    }
+    else if (!config.trace) {
+        printf("%lu sequences, %lu calls, time %.3f s, %.1f calls/s, no mismatches\n",
+               config.sequences, calls, seconds, calls / seconds);
+
+        /* Plansza 8 x 8 ma wyspecjalizowany silnik, a 5 x 5 korzysta z ogólnego. */
+        for (uint32_t size = 5; size <= 8 && first == NULL && !failed; size += 3) {
+            uint64_t reads;
+
+            if (!check_torn_reads(size, config.seed, &reads)) {
+                printf("gamma_read_board saw a golden move in progress on %u x %u\n",
+                       size, size);
+                torn = true;
+            }
+            else {
+                printf("%u x %u: %lu boards read during at least %d golden moves, "
+                       "none torn\n", size, size, reads, TORN_GOLDEN);
+            }
+        }
+    }
+
+    free(context.workers);
+
+    return failed || torn || first != NULL;
+}
@@ -0,0 +1,341 @@
+/** @file
+ * Wzorcowa implementacja gry gamma
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "gamma_ref.h"
+
+/** @brief Struktura przechowująca stan gry wzorcowej. */
+struct gamma_ref {
+    uint32_t width;         ///< Liczba kolumn.
+    uint32_t height;        ///< Liczba wierszy.
+    uint32_t players;       ///< Liczba graczy.
+    uint32_t areas;         ///< Maksymalna liczba obszarów gracza.
+    uint32_t* owner;        ///< Właściciel pola (x, y) pod indeksem x * height + y.
+    bool* golden_used;      ///< Czy gracz i + 1 wykonał już złoty ruch.
+    bool* seen;             ///< Pomocnicza tablica odwiedzonych pól.
+    uint64_t* queue;        ///< Pomocnicza kolejka przeszukiwania.
+};
+
+gamma_ref* ref_new(uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas) {
+    uint64_t size = (uint64_t)width * height;
+    gamma_ref *g;
+
+    if (width == 0 || height == 0 || players == 0 || areas == 0)
+        return NULL;
+
+    g = malloc(sizeof(gamma_ref));
+    if (g == NULL)
+        return NULL;
+
+    g->width = width;
+    g->height = height;
+    g->players = players;
+    g->areas = areas;
+    g->owner = calloc(size, sizeof(uint32_t));
+    g->golden_used = calloc(players, sizeof(bool));
+    g->seen = malloc(size * sizeof(bool));
+    g->queue = malloc(size * sizeof(uint64_t));
+
+    if (g->owner == NULL || g->golden_used == NULL ||
+        g->seen == NULL || g->queue == NULL) {
+        ref_delete(g);
+        return NULL;
+    }
+
+    return g;
+}
+
+void ref_delete(gamma_ref *g) {
+    if (g != NULL) {
+        free(g->owner);
+        free(g->golden_used);
+        free(g->seen);
+        free(g->queue);
+        free(g);
+    }
+}
+
+/** @brief Sprawdza, czy pole sąsiaduje z polem gracza.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] player    - numer gracza
+ * @param[in] x         - numer kolumny pola
+ * @param[in] y         - numer wiersza pola
+ * @return Wartość @p true, jeżeli któryś z sąsiadów należy do gracza.
+ */
+static bool touches(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y) {
+    uint64_t i = (uint64_t)x * g->height + y;
+
+    return (x > 0 && g->owner[i - g->height] == player) ||
+           (x + 1 < g->width && g->owner[i + g->height] == player) ||
+           (y > 0 && g->owner[i - 1] == player) ||
+           (y + 1 < g->height && g->owner[i + 1] == player);
+}
+
+/** @brief Liczy obszary gracza przeszukiwaniem wszerz całej planszy.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] player    - numer gracza
+ * @return Liczba spójnych obszarów pól gracza.
+ */
+static uint64_t count_areas(gamma_ref *g, uint32_t player) {
+    uint64_t size = (uint64_t)g->width * g->height, out = 0;
+
+    memset(g->seen, 0, size * sizeof(bool));
+
+    for (uint64_t start = 0; start < size; start++) {
+        uint64_t head = 0, tail = 0;
+
+        if (g->owner[start] != player || g->seen[start])
+            continue;
+
+        out++;
+        g->seen[start] = true;
+        g->queue[tail++] = start;
+
+        while (head < tail) {
+            uint64_t i = g->queue[head++];
+            uint64_t x = i / g->height, y = i % g->height;
+            uint64_t next[4];
+            int count = 0;
+
+            if (x > 0)
+                next[count++] = i - g->height;
+            if (x + 1 < g->width)
+                next[count++] = i + g->height;
+            if (y > 0)
+                next[count++] = i - 1;
+            if (y + 1 < g->height)
+                next[count++] = i + 1;
+
+            for (int k = 0; k < count; k++) {
+                if (g->owner[next[k]] == player && !g->seen[next[k]]) {
+                    g->seen[next[k]] = true;
+                    g->queue[tail++] = next[k];
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
+bool ref_move(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y) {
+    uint64_t i;
+
+    if (g == NULL || player == 0 || player > g->players ||
+        x >= g->width || y >= g->height)
+        return false;
+
+    i = (uint64_t)x * g->height + y;
+
+    if (g->owner[i] != 0)
+        return false;
+
+    g->owner[i] = player;
+
+    if (count_areas(g, player) > g->areas) {
+        g->owner[i] = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool ref_golden_move(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y) {
+    uint32_t previous;
+    uint64_t i;
+
+    if (g == NULL || player == 0 || player > g->players ||
+        x >= g->width || y >= g->height || g->golden_used[player - 1])
+        return false;
+
+    i = (uint64_t)x * g->height + y;
+    previous = g->owner[i];
+
+    if (previous == 0 || previous == player)
+        return false;
+
+    g->owner[i] = player;
+
+    if (count_areas(g, player) > g->areas ||
+        count_areas(g, previous) > g->areas) {
+        g->owner[i] = previous;
+        return false;
+    }
+
+    g->golden_used[player - 1] = true;
+
+    return true;
+}
+
+bool ref_move_legal(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y) {
+    if (!ref_move(g, player, x, y))
+        return false;
+
+    g->owner[(uint64_t)x * g->height + y] = 0;
+
+    return true;
+}
+
+bool ref_golden_target(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y) {
+    uint32_t previous;
+    uint64_t i;
+
+    if (g == NULL || x >= g->width || y >= g->height)
+        return false;
+
+    i = (uint64_t)x * g->height + y;
+    previous = g->owner[i];
+
+    if (!ref_golden_move(g, player, x, y))
+        return false;
+
+    g->owner[i] = previous;
+    g->golden_used[player - 1] = false;
+
+    return true;
+}
+
+uint32_t ref_split_count(gamma_ref *g, uint32_t x, uint32_t y) {
+    uint64_t i, before, after;
+    uint32_t owner;
+
+    if (g == NULL || x >= g->width || y >= g->height)
+        return 0;
+
+    i = (uint64_t)x * g->height + y;
+    owner = g->owner[i];
+
+    if (owner == 0)
+        return 0;
+
+    /* Pole samo w sobie jest obszarem, więc po jego usunięciu zostaje
+     * after - before + 1 części. */
+    before = count_areas(g, owner);
+    g->owner[i] = 0;
+    after = count_areas(g, owner);
+    g->owner[i] = owner;
+
+    return after + 1 - before;
+}
+
+uint64_t ref_busy_fields(gamma_ref *g, uint32_t player) {
+    uint64_t size, out = 0;
+
+    if (g == NULL || player == 0 || player > g->players)
+        return 0;
+
+    size = (uint64_t)g->width * g->height;
+
+    for (uint64_t i = 0; i < size; i++)
+        out += g->owner[i] == player;
+
+    return out;
+}
+
+uint64_t ref_free_fields(gamma_ref *g, uint32_t player) {
+    uint64_t out = 0;
+    bool anywhere;
+
+    if (g == NULL || player == 0 || player > g->players)
+        return 0;
+
+    anywhere = count_areas(g, player) < g->areas;
+
+    for (uint32_t x = 0; x < g->width; x++) {
+        for (uint32_t y = 0; y < g->height; y++) {
+            if (g->owner[(uint64_t)x * g->height + y] == 0 &&
+                (anywhere || touches(g, player, x, y)))
+                out++;
+        }
+    }
+
+    return out;
+}
+
+bool ref_golden_possible(gamma_ref *g, uint32_t player) {
+    uint64_t size;
+
+    if (g == NULL || player == 0 || player > g->players ||
+        g->golden_used[player - 1])
+        return false;
+
+    size = (uint64_t)g->width * g->height;
+
+    for (uint64_t i = 0; i < size; i++) {
+        if (g->owner[i] != 0 && g->owner[i] != player)
+            return true;
+    }
+
+    return false;
+}
+
+/** @brief Liczy cyfry liczby.
+ * @param[in] x         - liczba
+ * @return Liczba cyfr zapisu dziesiętnego @p x.
+ */
+static int digits(uint32_t x) {
+    int out = 1;
+
+    while (x >= 10) {
+        x /= 10;
+        out++;
+    }
+
+    return out;
+}
+
+char* ref_board(gamma_ref *g) {
+    uint64_t size, position = 0;
+    uint32_t highest = 0;
+    int cell;
+    char *out;
+
+    if (g == NULL)
+        return NULL;
+
+    size = (uint64_t)g->width * g->height;
+
+    for (uint64_t i = 0; i < size; i++) {
+        if (g->owner[i] > highest)
+            highest = g->owner[i];
+    }
+
+    /* Gdy numery mają więcej niż jedną cyfrę, oddzielamy je spacjami. */
+    cell = digits(highest) > 1 ? digits(highest) + 1 : 1;
+
+    out = malloc(size * cell + g->height + 1);
+    if (out == NULL)
+        return NULL;
+
+    for (uint32_t row = g->height; row-- > 0;) {
+        for (uint32_t x = 0; x < g->width; x++) {
+            uint32_t owner = g->owner[(uint64_t)x * g->height + row];
+
+            for (int k = cell - (owner == 0 ? 1 : digits(owner)); k > 0; k--)
+                out[position++] = ' ';
+
+            if (owner == 0) {
+                out[position++] = '.';
+            }
+            else {
+                for (int k = digits(owner) - 1; k >= 0; k--) {
+                    uint32_t d = owner;
+
+                    for (int j = 0; j < k; j++)
+                        d /= 10;
+                    out[position++] = '0' + d % 10;
+                }
+            }
+        }
+        out[position++] = '\n';
+    }
+    out[position] = '\0';
+
+    return out;
+}
@@ -0,0 +1,62 @@
+/** @file
+ * Interfejs wzorcowej implementacji gry gamma
+ *
+ * Celowo prosta implementacja tych samych zasad co w gamma.h, służąca jako
+ * wyrocznia przy sprawdzaniu zoptymalizowanego silnika. Plansza to płaska
+ * tablica właścicieli, a liczbę obszarów gracza za każdym razem liczymy od
+ * nowa przeszukiwaniem całej planszy. Nie ma tu żadnych struktur, które
+ * trzeba by aktualizować przy ruchach, więc trudno o błąd.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_REF_H
+#define GAMMA_REF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Struktura przechowująca stan gry wzorcowej. */
+typedef struct gamma_ref gamma_ref;
+
+/** @brief Tworzy grę, tak jak @ref gamma_new. */
+gamma_ref* ref_new(uint32_t width, uint32_t height,
+                   uint32_t players, uint32_t areas);
+
+/** @brief Usuwa grę, tak jak @ref gamma_delete. */
+void ref_delete(gamma_ref *g);
+
+/** @brief Wykonuje ruch, tak jak @ref gamma_move. */
+bool ref_move(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Wykonuje złoty ruch, tak jak @ref gamma_golden_move. */
+bool ref_golden_move(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Sprawdza bez zmiany stanu gry, czy ruch by się udał.
+ * Pola, dla których zwraca @p true, powinna wypisać @ref gamma_legal_moves.
+ */
+bool ref_move_legal(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Sprawdza bez zmiany stanu gry, czy złoty ruch by się udał.
+ * Pola, dla których zwraca @p true, powinna wypisać @ref gamma_golden_targets.
+ */
+bool ref_golden_target(gamma_ref *g, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Podaje, na ile części rozpadnie się obszar, tak jak @ref gamma_split_count. */
+uint32_t ref_split_count(gamma_ref *g, uint32_t x, uint32_t y);
+
+/** @brief Liczy pola gracza, tak jak @ref gamma_busy_fields. */
+uint64_t ref_busy_fields(gamma_ref *g, uint32_t player);
+
+/** @brief Liczy pola dostępne dla gracza, tak jak @ref gamma_free_fields. */
+uint64_t ref_free_fields(gamma_ref *g, uint32_t player);
+
+/** @brief Sprawdza możliwość złotego ruchu, tak jak @ref gamma_golden_possible. */
+bool ref_golden_possible(gamma_ref *g, uint32_t player);
+
+/** @brief Podaje napis opisujący planszę, tak jak @ref gamma_board. */
+char* ref_board(gamma_ref *g);
+
+#endif //GAMMA_REF_H
@@ -0,0 +1,366 @@
+/** @file
+ * Równoległe odtwarzanie zapisów trybu wsadowego
+ *
+ * Wykonuje polecenia trybu wsadowego z wielu plików naraz na puli wątków
+ * i zapisuje wynik każdego pliku (wyjście i komunikaty o błędach, w kolejności
+ * linii) do osobnego pliku @p KATALOG/NAZWA.out. Każdy wątek ma własny parser,
+ * bufory wejścia i wyjścia oraz grę, której pamięć wykorzystuje ponownie
+ * w kolejnych plikach, więc koszty uruchomienia i alokacji nie zależą od
+ * liczby plików. Polecenie I jest błędem, bo nie ma tu terminala.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "new_parser.h"
+#include "thread_pool.h"
+
+/** Rozmiar buforów wejścia i wyjścia jednego wątku. */
+#define IO_BUFFER (1 << 20)
+
+/** @brief Plik do odtworzenia. */
+typedef struct log_file {
+    char *path;                 ///< Ścieżka pliku.
+    const char *name;           ///< Nazwa pliku bez katalogu, wewnątrz @p path.
+    uint64_t size;              ///< Rozmiar pliku w bajtach.
+} log_file;
+
+/** @brief Dane jednego wątku. */
+typedef struct replay_worker {
+    batch_state state;          ///< Parser wielokrotnego użytku.
+    char *line;                 ///< Bufor linii.
+    size_t size;                ///< Rozmiar bufora linii.
+    char *in_buffer;            ///< Bufor strumienia wejścia.
+    char *out_buffer;           ///< Bufor strumienia wyjścia.
+    uint64_t files;             ///< Liczba odtworzonych plików.
+    uint64_t lines;             ///< Liczba wykonanych linii.
+    uint64_t bytes_in;          ///< Liczba przeczytanych bajtów.
+    uint64_t bytes_out;         ///< Liczba zapisanych bajtów.
+    uint64_t failed;            ///< Liczba plików, których nie udało się odtworzyć.
+} replay_worker;
+
+/** @brief Kontekst przekazywany do zadań puli. */
+typedef struct replay_context {
+    const char *output;         ///< Katalog plików wynikowych.
+    log_file *files;            ///< Pliki do odtworzenia.
+    replay_worker *workers;     ///< Dane wątków.
+} replay_context;
+
+/** @brief Podaje bieżący czas.
+ * @return Liczba sekund od ustalonej chwili w przeszłości.
+ */
+static double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/** @brief Odtwarza jeden plik.
+ * @param[in,out] context   - kontekst odtwarzania
+ * @param[in] id            - numer wątku
+ * @param[in] index         - numer pliku
+ */
+static void replay_file(void *context, uint32_t id, uint64_t index) {
+    replay_context *replay = context;
+    replay_worker *worker = &replay->workers[id];
+    const char *path = replay->files[index].path;
+    const char *name = replay->files[index].name;
+    char *out_path = NULL;
+    FILE *in, *out = NULL;
+    ssize_t length;
+
+    in = fopen(path, "r");
+
+    if (in != NULL && asprintf(&out_path, "%s/%s.out", replay->output, name) >= 0)
+        out = fopen(out_path, "w");
+
+    if (in == NULL || out == NULL) {
+        fprintf(stderr, "could not replay %s\n", path);
+        worker->failed++;
+
+        if (in != NULL)
+            fclose(in);
+
+        free(out_path);
+        return;
+    }
+
+    setvbuf(in, worker->in_buffer, _IOFBF, IO_BUFFER);
+    setvbuf(out, worker->out_buffer, _IOFBF, IO_BUFFER);
+    batch_restart(&worker->state, out, out);
+
+    while ((length = getline(&worker->line, &worker->size, in)) != -1) {
+        worker->bytes_in += length;
+
+        if (!batch_line(&worker->state, worker->line, length))
+            break;
+    }
+
+    batch_flush(&worker->state);
+    worker->files++;
+    worker->lines += worker->state.lines;
+    worker->bytes_out += ftello(out);
+    fclose(in);
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "could not write %s\n", out_path);
+        worker->failed++;
+    }
+
+    free(out_path);
+}
+
+/** @brief Porównuje pliki malejąco według rozmiaru (dla qsort).
+ * Duże pliki idą pierwsze, żeby na końcu zostały krótkie zadania.
+ * @param[in] a         - wskaźnik na pierwszy plik
+ * @param[in] b         - wskaźnik na drugi plik
+ * @return Liczba ujemna, zero lub dodatnia.
+ */
+static int compare_size(const void *a, const void *b) {
+    uint64_t x = ((const log_file *)a)->size;
+    uint64_t y = ((const log_file *)b)->size;
+
+    return (x < y) - (x > y);
+}
+
+/** @brief Porównuje pliki według nazwy bez katalogu (dla qsort).
+ * @param[in] a         - wskaźnik na pierwszy plik
+ * @param[in] b         - wskaźnik na drugi plik
+ * @return Liczba ujemna, zero lub dodatnia.
+ */
+static int compare_name(const void *a, const void *b) {
+    return strcmp(((const log_file *)a)->name, ((const log_file *)b)->name);
+}
+
+/** @brief Sprawdza, czy wyniki różnych plików nie trafią do jednego pliku.
+ * Plik wynikowy nazywamy nazwą pliku bez katalogu, więc na przykład
+ * @p a/game.log i @p b/game.log nadpisałyby nawzajem swoje wyniki.
+ * Zmienia kolejność plików.
+ * @param[in,out] files     - tablica plików
+ * @param[in] count         - liczba plików
+ * @return Wartość @p true, jeżeli nazwy plików są różne.
+ */
+static bool unique_names(log_file *files, uint64_t count) {
+    bool ok = true;
+
+    qsort(files, count, sizeof(log_file), compare_name);
+
+    for (uint64_t i = 1; i < count; i++) {
+        if (strcmp(files[i - 1].name, files[i].name) == 0) {
+            fprintf(stderr, "%s and %s would both write %s.out\n",
+                    files[i - 1].path, files[i].path, files[i].name);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+/** @brief Dopisuje plik do listy plików.
+ * @param[in,out] files     - wskaźnik na tablicę plików
+ * @param[in,out] count     - liczba plików
+ * @param[in,out] capacity  - rozmiar tablicy
+ * @param[in] path          - ścieżka pliku (kopiowana)
+ * @param[in] size          - rozmiar pliku
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool add_file(log_file **files, uint64_t *count, uint64_t *capacity,
+                     const char *path, uint64_t size) {
+    log_file *file;
+
+    if (*count == *capacity) {
+        uint64_t bigger = *capacity == 0 ? 64 : 2 * *capacity;
+        log_file *grown = realloc(*files, bigger * sizeof(log_file));
+
+        if (grown == NULL)
+            return false;
+
+        *files = grown;
+        *capacity = bigger;
+    }
+
+    file = &(*files)[*count];
+    file->path = strdup(path);
+    file->size = size;
+
+    if (file->path == NULL)
+        return false;
+
+    file->name = strrchr(file->path, '/');
+    file->name = file->name == NULL ? file->path : file->name + 1;
+    (*count)++;
+
+    return true;
+}
+
+/** @brief Dopisuje do listy plik lub zwykłe pliki z katalogu.
+ * Pliki katalogu o nazwach zaczynających się od kropki są pomijane.
+ * @param[in,out] files     - wskaźnik na tablicę plików
+ * @param[in,out] count     - liczba plików
+ * @param[in,out] capacity  - rozmiar tablicy
+ * @param[in] path          - ścieżka pliku lub katalogu
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool add_path(log_file **files, uint64_t *count, uint64_t *capacity,
+                     const char *path) {
+    struct stat info;
+    struct dirent *entry;
+    DIR *dir;
+    char *child;
+    bool ok = true;
+
+    if (stat(path, &info) != 0)
+        return false;
+
+    if (S_ISREG(info.st_mode))
+        return add_file(files, count, capacity, path, info.st_size);
+
+    if (!S_ISDIR(info.st_mode) || (dir = opendir(path)) == NULL)
+        return false;
+
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        if (asprintf(&child, "%s/%s", path, entry->d_name) < 0) {
+            ok = false;
+            break;
+        }
+
+        if (stat(child, &info) == 0 && S_ISREG(info.st_mode))
+            ok = add_file(files, count, capacity, child, info.st_size);
+
+        free(child);
+    }
+
+    closedir(dir);
+
+    return ok;
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-t threads] [-o output_dir] log_or_dir...\n", name);
+}
+
+/** @brief Odtwarza pliki podane w argumentach.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @return Zero, gdy wszystkie pliki odtworzono, jeden w przeciwnym wypadku.
+ */
+int main(int argc, char *argv[]) {
+    uint32_t threads = pool_default_threads();
+    const char *output = ".";
+    log_file *files = NULL;
+    uint64_t count = 0, capacity = 0;
+    replay_worker *workers;
+    replay_worker total = {0};
+    replay_context context;
+    double start, seconds;
+    bool ok = true;
+    char *end;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:o:")) != -1) {
+        if (option == 'o') {
+            output = optarg;
+        }
+        else if (option == 't' && *optarg >= '0' && *optarg <= '9') {
+            unsigned long value = strtoul(optarg, &end, 10);
+
+            if (*end != '\0' || value == 0 || value > 1024) {
+                usage(argv[0]);
+                return 1;
+            }
+            threads = value;
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (optind == argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        if (!add_path(&files, &count, &capacity, argv[i])) {
+            fprintf(stderr, "could not read %s\n", argv[i]);
+            ok = false;
+        }
+    }
+
+    ok = ok && unique_names(files, count);
+
+    if (ok && mkdir(output, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "could not create %s\n", output);
+        ok = false;
+    }
+
+    workers = calloc(threads, sizeof(replay_worker));
+
+    for (uint32_t i = 0; ok && workers != NULL && i < threads; i++) {
+        batch_init(&workers[i].state, NULL, NULL);
+        workers[i].state.interactive = false;
+        workers[i].state.runs = true;
+        workers[i].in_buffer = malloc(IO_BUFFER);
+        workers[i].out_buffer = malloc(IO_BUFFER);
+        ok = workers[i].in_buffer != NULL && workers[i].out_buffer != NULL;
+    }
+
+    qsort(files, count, sizeof(log_file), compare_size);
+    context.output = output;
+    context.files = files;
+    context.workers = workers;
+
+    start = now();
+    ok = ok && workers != NULL && pool_run(threads, count, replay_file, &context);
+    seconds = now() - start;
+
+    for (uint32_t i = 0; workers != NULL && i < threads; i++) {
+        total.files += workers[i].files;
+        total.lines += workers[i].lines;
+        total.bytes_in += workers[i].bytes_in;
+        total.bytes_out += workers[i].bytes_out;
+        total.failed += workers[i].failed;
+
+        batch_free(&workers[i].state);
+        free(workers[i].line);
+        free(workers[i].in_buffer);
+        free(workers[i].out_buffer);
+    }
+
+    if (ok) {
+        printf("%lu files, %lu lines, %.1f MB in, %.1f MB out, %u threads, "
+               "time %.3f s, %.1f lines/s, %.1f MB/s, %lu failed\n",
+               total.files, total.lines, total.bytes_in / 1e6, total.bytes_out / 1e6,
+               threads, seconds, seconds > 0 ? total.lines / seconds : 0,
+               seconds > 0 ? total.bytes_in / 1e6 / seconds : 0, total.failed);
+    }
+    else {
+        fprintf(stderr, "out of memory or bad arguments\n");
+    }
+
+    for (uint64_t i = 0; i < count; i++)
+        free(files[i].path);
+
+    free(files);
+    free(workers);
+
+    return ok && total.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+/** @file
+ * Symulator losowych rozgrywek gry gamma
+ *
+ * Rozgrywa wiele gier na puli wątków i wypisuje statystyki zwycięstw
+ * oraz długości rozgrywek. Służy do porównywania wariantów zasad
+ * (rozmiaru planszy, liczby graczy i limitu obszarów).
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gamma.h"
+#include "playout.h"
+#include "thread_pool.h"
+
+/** @brief Parametry symulacji. */
+typedef struct sim_config {
+    uint32_t width;             ///< Szerokość planszy.
+    uint32_t height;            ///< Wysokość planszy.
+    uint32_t players;           ///< Liczba graczy.
+    uint32_t areas;             ///< Maksymalna liczba obszarów gracza.
+    uint64_t games;             ///< Liczba rozgrywek.
+    uint32_t threads;           ///< Liczba wątków.
+    uint64_t seed;              ///< Ziarno generatora.
+    uint32_t golden_percent;    ///< Szansa próby złotego ruchu w turze (w %).
+    playout_policy strategy;    ///< Strategia wyboru ruchu.
+} sim_config;
+
+/** @brief Statystyki zebrane przez jeden wątek. */
+typedef struct sim_stats {
+    uint64_t* wins;             ///< Liczba zwycięstw każdego gracza.
+    uint64_t draws;             ///< Liczba remisów.
+    uint64_t games;             ///< Liczba rozegranych gier.
+    uint64_t moves;             ///< Suma długości gier.
+    double moves_squared;       ///< Suma kwadratów długości gier.
+    uint64_t min_moves;         ///< Najkrótsza gra.
+    uint64_t max_moves;         ///< Najdłuższa gra.
+    uint64_t golden_moves;      ///< Liczba udanych złotych ruchów.
+} sim_stats;
+
+/** @brief Dane jednego wątku.
+ * Każdy wątek ma własną grę, którą czyścimy między rozgrywkami,
+ * własny bufor ruchów i własne statystyki.
+ */
+typedef struct sim_worker {
+    gamma_t* game;              ///< Gra wielokrotnego użytku.
+    pair* moves;                ///< Bufor na legalne ruchy.
+    sim_stats stats;            ///< Statystyki wątku.
+    bool failed;                ///< Czy zabrakło pamięci.
+} sim_worker;
+
+/** @brief Kontekst przekazywany do zadań puli. */
+typedef struct sim_context {
+    const sim_config* config;   ///< Parametry symulacji.
+    sim_worker* workers;        ///< Dane wątków.
+} sim_context;
+
+/** @brief Zapisuje wynik zakończonej gry.
+ * Wygrywa gracz z największą liczbą pól, a przy równej liczbie jest remis.
+ * @param[in] g             - wskaźnik na grę
+ * @param[in,out] stats     - statystyki wątku
+ * @param[in] moves         - liczba wykonanych ruchów
+ */
+static void record_game(gamma_t *g, sim_stats *stats, uint64_t moves) {
+    uint64_t best = 0, fields;
+    uint32_t winner = 0;
+    bool draw = false;
+
+    for (uint32_t player = 1; player <= gamma_how_many_players(g); player++) {
+        fields = gamma_busy_fields(g, player);
+
+        if (fields > best) {
+            best = fields;
+            winner = player;
+            draw = false;
+        }
+        else if (fields == best) {
+            draw = true;
+        }
+    }
+
+    if (draw || winner == 0)
+        stats->draws++;
+    else
+        stats->wins[winner - 1]++;
+
+    if (stats->games == 0 || moves < stats->min_moves)
+        stats->min_moves = moves;
+    if (moves > stats->max_moves)
+        stats->max_moves = moves;
+
+    stats->games++;
+    stats->moves += moves;
+    stats->moves_squared += (double)moves * moves;
+}
+
+/** @brief Rozgrywa jedną grę - zadanie puli wątków.
+ * Gracze ruszają się po kolei. Gra kończy się, gdy wszyscy gracze
+ * po kolei spasują. Ziarno zależy tylko od numeru gry, więc wyniki nie
+ * zależą od liczby wątków.
+ * @param[in,out] context   - kontekst symulacji
+ * @param[in] id            - numer wątku
+ * @param[in] index         - numer gry
+ */
+static void play_game(void *context, uint32_t id, uint64_t index) {
+    sim_context *sim = context;
+    const sim_config *config = sim->config;
+    sim_worker *worker = &sim->workers[id];
+    uint64_t moves;
+    rng r;
+
+    if (worker->failed)
+        return;
+
+    if (worker->game == NULL) {
+        worker->game = gamma_new(config->width, config->height,
+                                 config->players, config->areas);
+        worker->moves = malloc((uint64_t)config->width * config->height * sizeof(pair));
+
+        if (worker->game == NULL || worker->moves == NULL) {
+            worker->failed = true;
+            return;
+        }
+    }
+    else {
+        gamma_reset(worker->game);
+    }
+
+    rng_seed(&r, config->seed ^ (index * 0x9e3779b97f4a7c15ULL));
+
+    moves = playout_game(worker->game, &r, 1, config->strategy,
+                         config->golden_percent, worker->moves,
+                         &worker->stats.golden_moves);
+
+    record_game(worker->game, &worker->stats, moves);
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-W width] [-H height] [-p players] [-a areas]\n"
+            "          [-n games] [-t threads] [-s seed] [-g golden%%]\n"
+            "          [-P random|greedy]\n", name);
+}
+
+/** @brief Odczytuje liczbę z argumentu programu.
+ * @param[in] text      - napis z liczbą
+ * @param[out] value    - odczytana liczba
+ * @return Wartość @p true, jeżeli napis jest poprawną liczbą.
+ */
+static bool parse_number(const char *text, uint64_t *value) {
+    char *end;
+
+    if (*text < '0' || *text > '9')
+        return false;
+
+    *value = strtoull(text, &end, 10);
+
+    return *end == '\0';
+}
+
+/** @brief Odczytuje parametry symulacji.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @param[out] config   - parametry symulacji
+ * @return Wartość @p true, jeżeli argumenty są poprawne.
+ */
+static bool parse_config(int argc, char *argv[], sim_config *config) {
+    uint64_t value = 0;
+    int option;
+
+    config->width = 10;
+    config->height = 10;
+    config->players = 2;
+    config->areas = 5;
+    config->games = 10000;
+    config->threads = pool_default_threads();
+    config->seed = 1;
+    config->golden_percent = 5;
+    config->strategy = PLAYOUT_RANDOM;
+
+    while ((option = getopt(argc, argv, "W:H:p:a:n:t:s:g:P:")) != -1) {
+        if (option == 'P') {
+            if (strcmp(optarg, "random") == 0)
+                config->strategy = PLAYOUT_RANDOM;
+            else if (strcmp(optarg, "greedy") == 0)
+                config->strategy = PLAYOUT_GREEDY;
+            else
+                return false;
+            continue;
+        }
+
+        if (option == '?' || !parse_number(optarg, &value))
+            return false;
+
+        /* Zero szans na złoty ruch ma sens, a wątków jest tyle, co w gamma_replay. */
+        if ((option == 'g' && value > 100) || (option == 't' && value > 1024))
+            return false;
+
+        if (option != 'n' && option != 's' && option != 'g' &&
+            (value == 0 || value > UINT32_MAX))
+            return false;
+
+        switch (option) {
+            case 'W': config->width = value; break;
+            case 'H': config->height = value; break;
+            case 'p': config->players = value; break;
+            case 'a': config->areas = value; break;
+            case 'n': config->games = value; break;
+            case 't': config->threads = value; break;
+            case 's': config->seed = value; break;
+            case 'g': config->golden_percent = value; break;
+            default: return false;
+        }
+    }
+
+    return optind == argc;
+}
+
+/** @brief Podaje czas w sekundach.
+ * @return Czas zegara monotonicznego w sekundach.
+ */
+static double now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** @brief Sumuje statystyki wszystkich wątków i je wypisuje.
+ * @param[in] config    - parametry symulacji
+ * @param[in] workers   - dane wątków
+ * @param[in] seconds   - czas symulacji
+ */
+static void report(const sim_config *config, sim_worker *workers, double seconds) {
+    sim_stats total = {0};
+    double mean, variance;
+
+    total.wins = calloc(config->players, sizeof(uint64_t));
+    if (total.wins == NULL)
+        return;
+
+    for (uint32_t i = 0; i < config->threads; i++) {
+        sim_stats *s = &workers[i].stats;
+
+        if (s->games == 0)
+            continue;
+
+        for (uint32_t p = 0; p < config->players; p++)
+            total.wins[p] += s->wins[p];
+
+        if (total.games == 0 || s->min_moves < total.min_moves)
+            total.min_moves = s->min_moves;
+        if (s->max_moves > total.max_moves)
+            total.max_moves = s->max_moves;
+
+        total.draws += s->draws;
+        total.games += s->games;
+        total.moves += s->moves;
+        total.moves_squared += s->moves_squared;
+        total.golden_moves += s->golden_moves;
+    }
+
+    mean = total.games ? (double)total.moves / total.games : 0;
+    variance = total.games ? total.moves_squared / total.games - mean * mean : 0;
+
+    printf("board %ux%u, players %u, areas %u, policy %s\n",
+           config->width, config->height, config->players, config->areas,
+           config->strategy == PLAYOUT_RANDOM ? "random" : "greedy");
+    printf("games %lu, threads %u, time %.3f s, %.1f games/s, %.1f moves/s\n",
+           total.games, config->threads, seconds,
+           total.games / seconds, total.moves / seconds);
+    printf("length mean %.2f, stddev %.2f, min %lu, max %lu, golden moves %.3f/game\n",
+           mean, sqrt(variance > 0 ? variance : 0), total.min_moves, total.max_moves,
+           total.games ? (double)total.golden_moves / total.games : 0);
+
+    for (uint32_t p = 0; p < config->players; p++) {
+        printf("player %u wins %lu (%.2f%%)\n", p + 1, total.wins[p],
+               total.games ? 100.0 * total.wins[p] / total.games : 0);
+    }
+    printf("draws %lu (%.2f%%)\n", total.draws,
+           total.games ? 100.0 * total.draws / total.games : 0);
+
+    free(total.wins);
+}
+
+/** @brief Uruchamia symulację.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @return Zero, gdy symulacja się powiodła, jeden w przeciwnym wypadku.
+ */
+int main(int argc, char *argv[]) {
+    sim_config config;
+    sim_context context;
+    double start, seconds;
+    int out = 0;
+
+    if (!parse_config(argc, argv, &config)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    context.config = &config;
+    context.workers = calloc(config.threads, sizeof(sim_worker));
+    if (context.workers == NULL)
+        return 1;
+
+    for (uint32_t i = 0; i < config.threads; i++) {
+        context.workers[i].stats.wins = calloc(config.players, sizeof(uint64_t));
+        if (context.workers[i].stats.wins == NULL)
+            context.workers[i].failed = true;
+    }
+
+    start = now();
+    if (!pool_run(config.threads, config.games, play_game, &context))
+        out = 1;
+    seconds = now() - start;
+
+    for (uint32_t i = 0; i < config.threads; i++) {
+        if (context.workers[i].failed)
+            out = 1;
+    }
+
+    if (out == 0)
+        report(&config, context.workers, seconds);
+    else
+        fprintf(stderr, "out of memory\n");
+
+    for (uint32_t i = 0; i < config.threads; i++) {
+        gamma_delete(context.workers[i].game);
+        free(context.workers[i].moves);
+        free(context.workers[i].stats.wins);
+    }
+    free(context.workers);
+
+    return out;
+}
@@ -0,0 +1,548 @@
+/** @file
+ * Serwer gier na gnieździe uniksowym
+ *
+ * Nasłuchuje na gnieździe domeny uniksowej i obsługuje w jednym wątku wiele
+ * połączeń naraz za pomocą epoll. Każde połączenie mówi protokołem trybu
+ * wsadowego i ma własny parser, grę oraz bufory wejścia i wyjścia. Wyniki
+ * poleceń i komunikaty o błędach trafiają, w kolejności linii, z powrotem
+ * do klienta. Gdy klient nie odbiera wyników, przestajemy czytać jego
+ * polecenia. Polecenie I jest błędem, bo nie ma tu terminala.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "new_parser.h"
+
+/** Liczba bajtów czytanych z gniazda naraz. */
+#define READ_CHUNK (1 << 16)
+/** Największa długość linii wejścia; dłuższa linia jest błędna. */
+#define LINE_MAX_BYTES (1 << 20)
+/** Liczba bajtów nieodebranych wyników, powyżej której nie czytamy poleceń. */
+#define OUTPUT_HIGH (1 << 20)
+/** Liczba zdarzeń odbieranych jednym wywołaniem epoll_wait. */
+#define MAX_EVENTS 256
+/** Domyślna największa liczba jednoczesnych połączeń. */
+#define DEFAULT_CLIENTS 4096
+
+/** @brief Bufor bajtów z nieprzetworzonym początkiem. */
+typedef struct byte_buffer {
+    char* data;             ///< Zawartość bufora.
+    size_t start;           ///< Początek nieprzetworzonych bajtów.
+    size_t length;          ///< Koniec zapisanych bajtów.
+    size_t capacity;        ///< Rozmiar tablicy @p data.
+} byte_buffer;
+
+/** @brief Połączenie z klientem. */
+typedef struct connection {
+    int fd;                     ///< Gniazdo połączenia.
+    uint32_t events;            ///< Zdarzenia zgłoszone do epoll.
+    batch_state state;          ///< Parser z grą klienta.
+    FILE* out;                  ///< Strumień dopisujący do @p output.
+    byte_buffer input;          ///< Odebrane, jeszcze niewykonane polecenia.
+    byte_buffer output;         ///< Wyniki czekające na wysłanie.
+    bool skipping;              /**< @brief Czy pomijamy resztę za długiej linii.
+                                 * Jej początek wykonaliśmy już jako błędną
+                                 * linię.
+                                 */
+    bool eof;                   ///< Czy klient skończył wysyłać polecenia.
+    bool failed;                ///< Czy połączenie trzeba zamknąć od razu.
+    struct connection* prev;    ///< Poprzednie połączenie na liście albo NULL.
+    struct connection* next;    ///< Następne połączenie na liście albo NULL.
+} connection;
+
+/** @brief Stan serwera. */
+typedef struct server {
+    int listener;               ///< Gniazdo nasłuchujące.
+    int epoll;                  ///< Deskryptor epoll.
+    bool accepting;             ///< Czy gniazdo nasłuchujące jest w epoll.
+    uint64_t clients;           ///< Liczba otwartych połączeń.
+    uint64_t max_clients;       ///< Największa liczba otwartych połączeń.
+    uint64_t served;            ///< Liczba wszystkich przyjętych połączeń.
+    uint64_t lines;             ///< Liczba linii zamkniętych połączeń.
+    connection* first;          ///< Lista otwartych połączeń.
+} server;
+
+/** @brief Czy przyszedł sygnał zakończenia pracy. */
+static volatile sig_atomic_t stopping = 0;
+
+/** @brief Zapamiętuje, że należy zakończyć pracę.
+ * @param[in] signal    - numer sygnału
+ */
+static void stop_handler(int signal) {
+    (void)signal;
+    stopping = 1;
+}
+
+/** @brief Zapewnia w buforze miejsce na kolejne bajty.
+ * Najpierw przesuwa nieprzetworzone bajty na początek tablicy, a dopiero
+ * gdy to nie wystarczy, powiększa ją.
+ * @param[in,out] buffer    - bufor
+ * @param[in] free_bytes    - potrzebna liczba wolnych bajtów na końcu
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool reserve(byte_buffer *buffer, size_t free_bytes) {
+    size_t used = buffer->length - buffer->start;
+    size_t capacity = buffer->capacity == 0 ? READ_CHUNK : buffer->capacity;
+    char *grown;
+
+    if (buffer->capacity - buffer->length >= free_bytes)
+        return true;
+
+    if (buffer->start > 0) {
+        memmove(buffer->data, buffer->data + buffer->start, used);
+        buffer->start = 0;
+        buffer->length = used;
+
+        if (buffer->capacity - used >= free_bytes)
+            return true;
+    }
+
+    while (capacity - used < free_bytes)
+        capacity *= 2;
+
+    grown = realloc(buffer->data, capacity);
+
+    if (grown == NULL)
+        return false;
+
+    buffer->data = grown;
+    buffer->capacity = capacity;
+
+    return true;
+}
+
+/** @brief Dopisuje wyniki parsera do bufora wyjścia połączenia.
+ * Funkcja zapisu strumienia utworzonego przez fopencookie.
+ * @param[in,out] cookie    - wskaźnik na połączenie
+ * @param[in] bytes         - dopisywane bajty
+ * @param[in] size          - liczba bajtów
+ * @return Liczba dopisanych bajtów, zero gdy zabrakło pamięci.
+ */
+static ssize_t output_write(void *cookie, const char *bytes, size_t size) {
+    connection *c = cookie;
+
+    if (!reserve(&c->output, size))
+        return 0;
+
+    memcpy(c->output.data + c->output.length, bytes, size);
+    c->output.length += size;
+
+    return size;
+}
+
+/** @brief Ustawia zdarzenia, na które czeka połączenie.
+ * Czytamy tylko wtedy, gdy wyniki czekające na wysłanie nie przekraczają
+ * @ref OUTPUT_HIGH, a na możliwość zapisu czekamy tylko, gdy coś zostało
+ * do wysłania.
+ * @param[in,out] s     - serwer
+ * @param[in,out] c     - połączenie
+ */
+static void update_events(server *s, connection *c) {
+    struct epoll_event event = {0};
+    uint32_t events = 0;
+
+    if (!c->eof && c->output.length - c->output.start < OUTPUT_HIGH)
+        events |= EPOLLIN;
+
+    if (c->output.length > c->output.start)
+        events |= EPOLLOUT;
+
+    if (events == c->events)
+        return;
+
+    event.events = events;
+    event.data.ptr = c;
+
+    if (epoll_ctl(s->epoll, EPOLL_CTL_MOD, c->fd, &event) == 0)
+        c->events = events;
+    else
+        c->failed = true;
+}
+
+/** @brief Przyjmuje nowe połączenia, dopóki jakieś czekają.
+ * Po osiągnięciu limitu połączeń wyjmuje gniazdo nasłuchujące z epoll.
+ * @param[in,out] s     - serwer
+ */
+static void accept_clients(server *s) {
+    struct epoll_event event = {0};
+    connection *c;
+    int fd;
+
+    while (s->clients < s->max_clients) {
+        fd = accept4(s->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("accept");
+            return;
+        }
+
+        c = calloc(1, sizeof(connection));
+
+        if (c != NULL)
+            c->out = fopencookie(c, "w", (cookie_io_functions_t){NULL, output_write,
+                                                                  NULL, NULL});
+
+        event.events = EPOLLIN;
+        event.data.ptr = c;
+
+        if (c == NULL || c->out == NULL ||
+            epoll_ctl(s->epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            if (c != NULL && c->out != NULL)
+                fclose(c->out);
+
+            free(c);
+            close(fd);
+            continue;
+        }
+
+        c->fd = fd;
+        c->events = EPOLLIN;
+        batch_init(&c->state, c->out, c->out);
+        c->state.interactive = false;
+        c->state.runs = true;
+
+        c->next = s->first;
+        if (s->first != NULL)
+            s->first->prev = c;
+        s->first = c;
+
+        s->clients++;
+        s->served++;
+    }
+
+    if (s->accepting && epoll_ctl(s->epoll, EPOLL_CTL_DEL, s->listener, NULL) == 0)
+        s->accepting = false;
+}
+
+/** @brief Zamyka połączenie i zwalnia jego pamięć.
+ * Przywraca gniazdo nasłuchujące do epoll, jeżeli było z niego wyjęte.
+ * @param[in,out] s     - serwer
+ * @param[in] c         - połączenie
+ */
+static void close_connection(server *s, connection *c) {
+    struct epoll_event event = {0};
+
+    if (c->prev != NULL)
+        c->prev->next = c->next;
+    else
+        s->first = c->next;
+
+    if (c->next != NULL)
+        c->next->prev = c->prev;
+
+    s->lines += c->state.lines;
+    close(c->fd);
+    fclose(c->out);
+    batch_free(&c->state);
+    free(c->input.data);
+    free(c->output.data);
+    free(c);
+    s->clients--;
+
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (!s->accepting && epoll_ctl(s->epoll, EPOLL_CTL_ADD, s->listener, &event) == 0)
+        s->accepting = true;
+}
+
+/** @brief Wypisuje błąd linii dłuższej niż @ref LINE_MAX_BYTES.
+ * Linię liczymy tak, jakby ją wykonał parser, ale jej nie analizujemy.
+ * @param[in,out] c     - połączenie
+ */
+static void long_line(connection *c) {
+    batch_command cmd = {0};
+    batch_result result;
+
+    c->state.lines++;
+    batch_flush(&c->state);
+    batch_execute(&c->state, LINE_ERROR, &cmd, &result);
+    batch_print(c->out, c->out, &result);
+}
+
+/** @brief Wykonuje odebrane linie, dopóki klient odbiera wyniki.
+ * Serię poleceń wykonujemy przed każdym powrotem do pętli zdarzeń, więc
+ * klient czekający na wynik ostatniego polecenia zawsze go dostanie. Ostatnią
+ * linię bez znaku końca linii pomijamy, jak w programie gamma, a linia
+ * dłuższa niż @ref LINE_MAX_BYTES jest błędna.
+ * @param[in,out] c     - połączenie
+ */
+static void process_input(connection *c) {
+    byte_buffer *in = &c->input;
+    char *line, *end;
+    size_t length;
+
+    while (c->output.length - c->output.start < OUTPUT_HIGH && in->start < in->length) {
+        line = in->data + in->start;
+        end = memchr(line, '\n', in->length - in->start);
+        length = end == NULL ? in->length - in->start : (size_t)(end - line) + 1;
+
+        if (end == NULL && !c->eof && length < LINE_MAX_BYTES)
+            break;
+
+        in->start += length;
+
+        if (c->skipping) {
+            c->skipping = end == NULL;
+            continue;
+        }
+
+        /* Za długa linia jest błędna, a jej resztę pomijamy. */
+        if (end == NULL && !c->eof) {
+            c->skipping = true;
+            long_line(c);
+            continue;
+        }
+
+        batch_line(&c->state, line, length);
+    }
+
+    if (in->start == in->length)
+        in->start = in->length = 0;
+
+    batch_flush(&c->state);
+
+    if (fflush(c->out) != 0)
+        c->failed = true;
+}
+
+/** @brief Czyta polecenia klienta i je wykonuje.
+ * @param[in,out] c     - połączenie
+ */
+static void read_input(connection *c) {
+    ssize_t got;
+
+    if (!reserve(&c->input, READ_CHUNK)) {
+        c->failed = true;
+        return;
+    }
+
+    got = read(c->fd, c->input.data + c->input.length, READ_CHUNK);
+
+    if (got < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            c->failed = true;
+        return;
+    }
+
+    if (got == 0)
+        c->eof = true;
+
+    c->input.length += got;
+    process_input(c);
+}
+
+/** @brief Wysyła tyle wyników, ile przyjmie gniazdo.
+ * Potem wykonuje odebrane linie wstrzymane przez zbyt wiele wyników.
+ * @param[in,out] c     - połączenie
+ */
+static void write_output(connection *c) {
+    byte_buffer *out = &c->output;
+    ssize_t sent;
+
+    while (out->start < out->length) {
+        sent = send(c->fd, out->data + out->start, out->length - out->start,
+                    MSG_NOSIGNAL);
+
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                c->failed = true;
+            break;
+        }
+
+        out->start += sent;
+    }
+
+    if (out->start == out->length)
+        out->start = out->length = 0;
+
+    if (!c->failed && c->input.start < c->input.length)
+        process_input(c);
+}
+
+/** @brief Obsługuje zdarzenie połączenia.
+ * Połączenie zamykamy, gdy klient skończył wysyłać polecenia, a wszystkie
+ * wyniki zostały wysłane, albo gdy wystąpił błąd.
+ * @param[in,out] s     - serwer
+ * @param[in,out] c     - połączenie
+ * @param[in] events    - zgłoszone zdarzenia
+ */
+static void handle_connection(server *s, connection *c, uint32_t events) {
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        read_input(c);
+
+    if (!c->failed && c->output.length > c->output.start)
+        write_output(c);
+
+    if (!c->failed)
+        update_events(s, c);
+
+    if (c->failed || (c->eof && c->input.length == c->input.start &&
+                      c->output.length == c->output.start))
+        close_connection(s, c);
+}
+
+/** @brief Podnosi limit otwartych plików do największej dozwolonej wartości.
+ * @param[in] clients   - żądana liczba połączeń
+ * @return Liczba połączeń, na którą wystarczy deskryptorów, nie większa
+ * niż @p clients.
+ */
+static uint64_t raise_file_limit(uint64_t clients) {
+    struct rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return clients;
+
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    /* Kilka deskryptorów zostawiamy na standardowe strumienie, epoll i gniazdo. */
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < clients + 16)
+        return limit.rlim_cur > 16 ? limit.rlim_cur - 16 : 1;
+
+    return clients;
+}
+
+/** @brief Tworzy gniazdo nasłuchujące.
+ * Usuwa wcześniej istniejący plik gniazda o tej samej ścieżce.
+ * @param[in] path      - ścieżka gniazda
+ * @return Deskryptor gniazda lub -1, gdy się nie udało.
+ */
+static int listen_on(const char *path) {
+    struct sockaddr_un address = {0};
+    int fd;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (fd < 0 || bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        perror(path);
+
+        if (fd >= 0)
+            close(fd);
+
+        return -1;
+    }
+
+    return fd;
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-c max_clients] socket_path\n", name);
+}
+
+/** @brief Obsługuje klientów do otrzymania sygnału SIGINT lub SIGTERM.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @return Zero, gdy serwer zakończył pracę po sygnale, jeden w przeciwnym
+ * wypadku.
+ */
+int main(int argc, char *argv[]) {
+    struct epoll_event events[MAX_EVENTS];
+    struct epoll_event event = {0};
+    struct sigaction action = {0};
+    server s = {0};
+    char *end;
+    int option, ready;
+    bool ok = true;
+
+    s.max_clients = DEFAULT_CLIENTS;
+
+    while ((option = getopt(argc, argv, "c:")) != -1) {
+        if (option == 'c' && *optarg >= '0' && *optarg <= '9') {
+            s.max_clients = strtoull(optarg, &end, 10);
+
+            if (*end == '\0' && s.max_clients > 0)
+                continue;
+        }
+
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    s.max_clients = raise_file_limit(s.max_clients);
+    action.sa_handler = stop_handler;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    s.listener = listen_on(argv[optind]);
+    s.epoll = epoll_create1(EPOLL_CLOEXEC);
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (s.listener < 0 || s.epoll < 0 ||
+        epoll_ctl(s.epoll, EPOLL_CTL_ADD, s.listener, &event) != 0) {
+        if (s.listener >= 0) {
+            close(s.listener);
+            unlink(argv[optind]);
+        }
+
+        return 1;
+    }
+
+    s.accepting = true;
+
+    while (!stopping) {
+        ready = epoll_wait(s.epoll, events, MAX_EVENTS, -1);
+
+        if (ready < 0) {
+            if (errno == EINTR)
+                continue;
+
+            perror("epoll_wait");
+            ok = false;
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == NULL)
+                accept_clients(&s);
+            else
+                handle_connection(&s, events[i].data.ptr, events[i].events);
+        }
+    }
+
+    while (s.first != NULL)
+        close_connection(&s, s.first);
+
+    close(s.listener);
+    close(s.epoll);
+    unlink(argv[optind]);
+
+    fprintf(stderr, "%lu connections, %lu lines\n", s.served, s.lines);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+/** @file
+ * Implementacja tablicy haszującej o kluczach i wartościach typu uint64_t.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "hash_map.h"
+
+/** Początkowa liczba komórek tablicy. */
+#define HASH_MAP_MIN_CAPACITY 16
+
+/** @brief Miesza bity klucza.
+ * Funkcja mieszająca z generatora splitmix64. Sąsiednie pola planszy mają
+ * kolejne indeksy, więc bez mieszania tworzyłyby długie ciągi zajętych komórek.
+ * @param[in] key       - klucz
+ * @return Wartość skrótu.
+ */
+static uint64_t mix(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+
+    return key;
+}
+
+void hash_map_init(hash_map *map) {
+    map->table = NULL;
+    map->size = 0;
+    map->shared = false;
+    map->retired = NULL;
+}
+
+void hash_map_share(hash_map *map) {
+    map->shared = true;
+}
+
+/** @brief Alokuje puste komórki.
+ * Struktura i obie tablice leżą w jednym bloku pamięci.
+ * @param[in] capacity  - liczba komórek, potęga dwójki
+ * @return Wskaźnik na komórki lub NULL, gdy zabrakło pamięci.
+ */
+static hash_map_table* table_new(uint64_t capacity) {
+    hash_map_table *table;
+
+    if (capacity > (SIZE_MAX - sizeof(hash_map_table)) / (2 * sizeof(uint64_t)))
+        return NULL;
+
+    table = calloc(1, sizeof(hash_map_table) + 2 * capacity * sizeof(uint64_t));
+    if (table == NULL)
+        return NULL;
+
+    table->capacity = capacity;
+    table->keys = (uint64_t *)(table + 1);
+    table->values = table->keys + capacity;
+    table->next = NULL;
+
+    return table;
+}
+
+/** @brief Szuka komórki z danym kluczem lub pierwszej wolnej komórki.
+ * @param[in] table     - wskaźnik na komórki
+ * @param[in] stored    - klucz powiększony o jeden
+ * @return Indeks komórki.
+ */
+static uint64_t find_slot(const hash_map_table *table, uint64_t stored) {
+    uint64_t mask = table->capacity - 1;
+    uint64_t i = mix(stored) & mask;
+
+    while (table->keys[i] != 0 && table->keys[i] != stored)
+        i = (i + 1) & mask;
+
+    return i;
+}
+
+/** @brief Zmienia pojemność tablicy.
+ * Przepisuje wszystkie elementy do nowych komórek o pojemności @p capacity.
+ * @param[in,out] map   - wskaźnik na tablicę
+ * @param[in] capacity  - nowa pojemność, potęga dwójki większa od liczby elementów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool resize(hash_map *map, uint64_t capacity) {
+    hash_map_table *old = map->table, *bigger = table_new(capacity);
+    uint64_t slot;
+
+    if (bigger == NULL)
+        return false;
+
+    for (uint64_t i = 0; old != NULL && i < old->capacity; i++) {
+        if (old->keys[i] != 0) {
+            slot = find_slot(bigger, old->keys[i]);
+            bigger->keys[slot] = old->keys[i];
+            bigger->values[slot] = old->values[i];
+        }
+    }
+
+    if (map->shared) {
+        if (old != NULL) {
+            old->next = map->retired;
+            map->retired = old;
+        }
+
+        /* Czytelnik, który zobaczy nowe komórki, zobaczy je całe wypełnione. */
+        __atomic_store_n(&map->table, bigger, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    free(old);
+    map->table = bigger;
+
+    return true;
+}
+
+bool hash_map_get(const hash_map *map, uint64_t key, uint64_t *value) {
+    uint64_t slot;
+
+    if (map->size == 0)
+        return false;
+
+    slot = find_slot(map->table, key + 1);
+
+    if (map->table->keys[slot] == 0)
+        return false;
+
+    if (value != NULL)
+        *value = map->table->values[slot];
+
+    return true;
+}
+
+bool hash_map_get_shared(const hash_map *map, uint64_t key, uint64_t *value) {
+    const hash_map_table *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+    uint64_t stored = key + 1, mask, i, found;
+
+    if (table == NULL)
+        return false;
+
+    mask = table->capacity - 1;
+    i = mix(stored) & mask;
+
+    /* Zapełnienie jest poniżej 3/4, więc wolna komórka zawsze się znajdzie. */
+    while ((found = __atomic_load_n(&table->keys[i], __ATOMIC_ACQUIRE)) != 0) {
+        if (found == stored) {
+            *value = __atomic_load_n(&table->values[i], __ATOMIC_RELAXED);
+            return true;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return false;
+}
+
+bool hash_map_put(hash_map *map, uint64_t key, uint64_t value) {
+    uint64_t capacity = map->table == NULL ? 0 : map->table->capacity;
+    hash_map_table *table;
+    uint64_t slot;
+
+    /* Utrzymujemy zapełnienie poniżej 3/4. */
+    if (4 * (map->size + 1) > 3 * capacity &&
+        !resize(map, capacity == 0 ? HASH_MAP_MIN_CAPACITY : 2 * capacity))
+        return false;
+
+    table = map->table;
+    slot = find_slot(table, key + 1);
+
+    if (map->shared) {
+        __atomic_store_n(&table->values[slot], value, __ATOMIC_RELAXED);
+
+        if (table->keys[slot] == 0) {
+            __atomic_store_n(&table->keys[slot], key + 1, __ATOMIC_RELEASE);
+            map->size++;
+        }
+
+        return true;
+    }
+
+    if (table->keys[slot] == 0) {
+        table->keys[slot] = key + 1;
+        map->size++;
+    }
+    table->values[slot] = value;
+
+    return true;
+}
+
+bool hash_map_remove(hash_map *map, uint64_t key) {
+    hash_map_table *table = map->table;
+    uint64_t mask, hole, i, home;
+
+    if (map->size == 0)
+        return false;
+
+    mask = table->capacity - 1;
+    hole = find_slot(table, key + 1);
+
+    if (table->keys[hole] == 0)
+        return false;
+
+    /* Przesuwamy wstecz elementy, które bez dziury nie byłyby osiągalne. */
+    i = hole;
+    while (true) {
+        i = (i + 1) & mask;
+
+        if (table->keys[i] == 0)
+            break;
+
+        home = mix(table->keys[i]) & mask;
+
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->keys[hole] = table->keys[i];
+            table->values[hole] = table->values[i];
+            hole = i;
+        }
+    }
+
+    table->keys[hole] = 0;
+    map->size--;
+
+    return true;
+}
+
+bool hash_map_copy(hash_map *dst, const hash_map *src) {
+    uint64_t capacity = src->table == NULL ? 0 : src->table->capacity;
+
+    if ((dst->table == NULL ? 0 : dst->table->capacity) != capacity) {
+        hash_map_table *table = NULL;
+
+        if (capacity != 0 && (table = table_new(capacity)) == NULL)
+            return false;
+
+        hash_map_free(dst);
+        dst->table = table;
+    }
+
+    if (capacity != 0) {
+        memcpy(dst->table->keys, src->table->keys, capacity * sizeof(uint64_t));
+        memcpy(dst->table->values, src->table->values, capacity * sizeof(uint64_t));
+    }
+    dst->size = src->size;
+
+    return true;
+}
+
+void hash_map_clear(hash_map *map) {
+    if (map->size != 0)
+        memset(map->table->keys, 0, map->table->capacity * sizeof(uint64_t));
+
+    map->size = 0;
+}
+
+void hash_map_free(hash_map *map) {
+    hash_map_table *next;
+
+    for (hash_map_table *t = map->retired; t != NULL; t = next) {
+        next = t->next;
+        free(t);
+    }
+
+    free(map->table);
+    hash_map_init(map);
+}
@@ -0,0 +1,129 @@
+/** @file
+ * Interfejs tablicy haszującej o kluczach i wartościach typu uint64_t.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_HASH_MAP_H
+#define GAMMA_HASH_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Komórki tablicy haszującej.
+ * Pojemność i obie tablice trzymamy razem, żeby czytelnik współdzielonej
+ * tablicy, który jednym odczytem wskaźnika dostaje całą strukturę, nie
+ * połączył pojemności jednej tablicy z komórkami innej.
+ */
+typedef struct hash_map_table {
+    uint64_t capacity;              ///< Liczba komórek, potęga dwójki.
+    uint64_t* keys;                 ///< Tablica kluczy (powiększonych o jeden).
+    uint64_t* values;               ///< Tablica wartości.
+    struct hash_map_table* next;    /**< @brief Kolejna zastąpiona tablica
+                                    * albo NULL, zob. @p retired.
+                                    */
+} hash_map_table;
+
+/** @brief Struktura tablicy haszującej.
+ * Tablica z adresowaniem otwartym (liniowe próbkowanie). Klucze przechowujemy
+ * powiększone o jeden, dzięki czemu zero oznacza wolną komórkę. <br>
+ * Wyzerowana struktura jest poprawną, pustą tablicą - pamięć alokujemy
+ * dopiero przy pierwszym wstawieniu.
+ */
+typedef struct hash_map {
+    hash_map_table* table;  ///< Komórki tablicy albo NULL, gdy pojemność jest zerowa.
+    uint64_t size;          ///< Liczba zapisanych par.
+    bool shared;            /**< @brief Czy tablicę czytają inne wątki.
+                            * Zob. @ref hash_map_share.
+                            */
+    hash_map_table* retired; /**< @brief Komórki zastąpione większymi.
+                            * Tablica współdzielona zwalnia je dopiero
+                            * w @ref hash_map_free, bo mogą ich jeszcze
+                            * przeglądać czytelnicy z innych wątków.
+                            */
+} hash_map;
+
+/** @brief Inicjuje pustą tablicę haszującą.
+ * Nie alokuje pamięci.
+ * @param[out] map      - wskaźnik na inicjowaną strukturę
+ */
+void hash_map_init(hash_map *map);
+
+/** @brief Wyszukuje wartość przypisaną do klucza.
+ * @param[in] map       - wskaźnik na tablicę
+ * @param[in] key       - klucz, liczba mniejsza od UINT64_MAX
+ * @param[out] value    - wskaźnik pod który zapisujemy znalezioną wartość,
+ *                        może być NULL
+ * @return Wartość @p true, jeżeli klucz jest w tablicy, @p false w przeciwnym
+ * wypadku.
+ */
+bool hash_map_get(const hash_map *map, uint64_t key, uint64_t *value);
+
+/** @brief Pozwala czytać tablicę w trakcie wstawiania.
+ * Funkcja @ref hash_map_put współdzielonej tablicy zapisuje wartość przed
+ * kluczem, nowe komórki publikuje jednym zapisem wskaźnika dopiero po
+ * przepisaniu do nich elementów, a komórek zastąpionych większymi nie
+ * zwalnia aż do @ref hash_map_free. Dzięki temu
+ * @ref hash_map_get_shared wywołana w innym wątku w trakcie wstawiania nie
+ * czyta zwolnionej pamięci ani nie wychodzi poza tablicę, i znajduje każdy
+ * klucz, którego wstawienie ją poprzedza (np. dzięki blokadzie). Klucz
+ * wstawiany w tej chwili może jednak pominąć, a nadpisywanej w tej chwili
+ * wartości nie musi podać aktualnej. Funkcji @ref hash_map_remove
+ * i @ref hash_map_copy nie wolno wtedy wywoływać.
+ * @param[in,out] map   - wskaźnik na tablicę
+ */
+void hash_map_share(hash_map *map);
+
+/** @brief Wyszukuje wartość w tablicy, do której inny wątek może wstawiać.
+ * Tablica musi być współdzielona funkcją @ref hash_map_share.
+ * @param[in] map       - wskaźnik na tablicę
+ * @param[in] key       - klucz, liczba mniejsza od UINT64_MAX
+ * @param[out] value    - wskaźnik pod który zapisujemy znalezioną wartość
+ * @return Wartość @p true, jeżeli klucz jest w tablicy, @p false w przeciwnym
+ * wypadku lub gdy inny wątek właśnie go wstawia.
+ */
+bool hash_map_get_shared(const hash_map *map, uint64_t key, uint64_t *value);
+
+/** @brief Przypisuje wartość do klucza.
+ * Wstawia parę (@p key, @p value) lub nadpisuje wartość istniejącego klucza.
+ * W razie potrzeby dwukrotnie powiększa tablicę.
+ * @param[in,out] map   - wskaźnik na tablicę
+ * @param[in] key       - klucz, liczba mniejsza od UINT64_MAX
+ * @param[in] value     - zapisywana wartość
+ * @return Wartość @p true, jeżeli się udało, lub @p false, gdy zabrakło pamięci.
+ */
+bool hash_map_put(hash_map *map, uint64_t key, uint64_t value);
+
+/** @brief Usuwa klucz z tablicy.
+ * Usuwa element przesuwając wstecz kolejne elementy z tego samego ciągu,
+ * więc tablica nie potrzebuje nagrobków.
+ * @param[in,out] map   - wskaźnik na tablicę
+ * @param[in] key       - usuwany klucz
+ * @return Wartość @p true, jeżeli klucz był w tablicy, @p false w przeciwnym
+ * wypadku.
+ */
+bool hash_map_remove(hash_map *map, uint64_t key);
+
+/** @brief Kopiuje zawartość tablicy.
+ * Po wywołaniu @p dst zawiera te same pary co @p src. Pamięć @p dst
+ * wykorzystujemy ponownie, jeżeli ma tę samą pojemność.
+ * @param[in,out] dst   - wskaźnik na tablicę docelową
+ * @param[in] src       - wskaźnik na kopiowaną tablicę
+ * @return Wartość @p true, jeżeli się udało, lub @p false, gdy zabrakło pamięci.
+ */
+bool hash_map_copy(hash_map *dst, const hash_map *src);
+
+/** @brief Usuwa wszystkie elementy, zachowując zaalokowaną pamięć.
+ * @param[in,out] map   - wskaźnik na tablicę
+ */
+void hash_map_clear(hash_map *map);
+
+/** @brief Zwalnia pamięć tablicy.
+ * Po wywołaniu struktura jest ponownie pustą tablicą.
+ * @param[in,out] map   - wskaźnik na tablicę
+ */
+void hash_map_free(hash_map *map);
+
+#endif //GAMMA_HASH_MAP_H
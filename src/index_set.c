@@ -0,0 +1,172 @@
+/** @file
+ * Implementacja indeksowanego zbioru pól.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "index_set.h"
+
+/** Początkowy rozmiar tablicy elementów. */
+#define INDEX_SET_MIN_CAPACITY 8
+
+void index_set_init(index_set *set) {
+    set->items = NULL;
+    set->keys = NULL;
+    set->size = 0;
+    set->capacity = 0;
+    set->slots = NULL;
+    set->universe = 0;
+    hash_map_init(&set->positions);
+}
+
+void index_set_init_dense(index_set *set, uint64_t universe) {
+    index_set_init(set);
+    set->universe = universe;
+}
+
+bool index_set_contains(const index_set *set, uint64_t key) {
+    if (set->universe != 0)
+        return set->slots != NULL && set->slots[key] != 0;
+
+    return hash_map_get(&set->positions, key, NULL);
+}
+
+/** @brief Zapisuje pozycję elementu.
+ * @param[in,out] set   - wskaźnik na zbiór
+ * @param[in] key       - klucz elementu
+ * @param[in] position  - pozycja w tablicy elementów
+ * @return Wartość @p false, jeżeli zabrakło pamięci, @p true w przeciwnym
+ * wypadku.
+ */
+static bool put_position(index_set *set, uint64_t key, uint64_t position) {
+    if (set->universe == 0)
+        return hash_map_put(&set->positions, key, position);
+
+    if (set->slots == NULL) {
+        set->slots = calloc(set->universe, sizeof(uint32_t));
+
+        if (set->slots == NULL)
+            return false;
+    }
+
+    set->slots[key] = (uint32_t)position + 1;
+
+    return true;
+}
+
+/** @brief Powiększa dwukrotnie tablice elementów.
+ * @param[in,out] set   - wskaźnik na zbiór
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci.
+ */
+static bool grow(index_set *set) {
+    uint64_t capacity = set->capacity == 0 ?
+                        INDEX_SET_MIN_CAPACITY : 2 * set->capacity;
+    pair *items = realloc(set->items, capacity * sizeof(pair));
+
+    if (items == NULL)
+        return false;
+    set->items = items;
+
+    uint64_t *keys = realloc(set->keys, capacity * sizeof(uint64_t));
+
+    if (keys == NULL)
+        return false;
+    set->keys = keys;
+
+    set->capacity = capacity;
+
+    return true;
+}
+
+bool index_set_insert(index_set *set, uint64_t key, pair field) {
+    if (index_set_contains(set, key))
+        return true;
+
+    if (set->size == set->capacity && !grow(set))
+        return false;
+
+    if (!put_position(set, key, set->size))
+        return false;
+
+    set->items[set->size] = field;
+    set->keys[set->size] = key;
+    set->size++;
+
+    return true;
+}
+
+void index_set_remove(index_set *set, uint64_t key) {
+    uint64_t position, last;
+
+    if (set->universe != 0) {
+        if (!index_set_contains(set, key))
+            return;
+
+        position = set->slots[key] - 1;
+        set->slots[key] = 0;
+    }
+    else {
+        if (!hash_map_get(&set->positions, key, &position))
+            return;
+
+        hash_map_remove(&set->positions, key);
+    }
+
+    last = --set->size;
+
+    if (position != last) {
+        set->items[position] = set->items[last];
+        set->keys[position] = set->keys[last];
+        put_position(set, set->keys[position], position);
+    }
+}
+
+bool index_set_copy(index_set *dst, const index_set *src) {
+    if (dst->universe != src->universe)
+        return false;
+
+    while (dst->capacity < src->size) {
+        if (!grow(dst))
+            return false;
+    }
+
+    if (dst->universe != 0) {
+        index_set_clear(dst);
+
+        for (uint64_t i = 0; i < src->size; i++) {
+            if (!put_position(dst, src->keys[i], i))
+                return false;
+        }
+    }
+    else if (!hash_map_copy(&dst->positions, &src->positions)) {
+        return false;
+    }
+
+    if (src->size != 0) {
+        memcpy(dst->items, src->items, src->size * sizeof(pair));
+        memcpy(dst->keys, src->keys, src->size * sizeof(uint64_t));
+    }
+    dst->size = src->size;
+
+    return true;
+}
+
+void index_set_clear(index_set *set) {
+    /* Zerujemy tylko zajęte miejsca, bo zbiór bywa dużo mniejszy od tablicy. */
+    for (uint64_t i = 0; set->slots != NULL && i < set->size; i++)
+        set->slots[set->keys[i]] = 0;
+
+    set->size = 0;
+    hash_map_clear(&set->positions);
+}
+
+void index_set_free(index_set *set) {
+    free(set->items);
+    free(set->keys);
+    free(set->slots);
+    hash_map_free(&set->positions);
+    index_set_init(set);
+}
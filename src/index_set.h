@@ -0,0 +1,98 @@
+/** @file
+ * Interfejs indeksowanego zbioru pól.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_INDEX_SET_H
+#define GAMMA_INDEX_SET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pairs.h"
+#include "hash_map.h"
+
+/** @brief Struktura indeksowanego zbioru pól.
+ * Elementy trzymamy w spójnej tablicy @p items, a tablica @p positions
+ * przypisuje kluczowi pola jego pozycję w @p items. Dzięki temu wstawianie,
+ * usuwanie i sprawdzanie przynależności działają w czasie stałym, a przejście
+ * po zbiorze kosztuje tyle, ile ma on elementów. <br>
+ * Kluczem pola jest jego indeks na planszy, wyliczany przez wywołującego.
+ * Gdy klucze są mniejsze od znanego z góry @p universe, pozycje trzymamy
+ * w zwykłej tablicy @p slots zamiast w tablicy haszującej.
+ * Wyzerowana struktura jest poprawnym, pustym zbiorem.
+ */
+typedef struct index_set {
+    pair* items;            ///< Spójna tablica elementów.
+    uint64_t* keys;         ///< Klucze elementów, równoległe do @p items.
+    uint64_t size;          ///< Liczba elementów.
+    uint64_t capacity;      ///< Rozmiar tablicy @p items.
+    hash_map positions;     ///< Klucz pola -> pozycja w @p items.
+    uint32_t* slots;        /**< @brief Klucz pola -> pozycja w @p items plus jeden.
+                            * Zero oznacza brak pola w zbiorze. Używana
+                            * zamiast @p positions, gdy @p universe nie jest
+                            * zerem, i tworzona przy pierwszym wstawieniu.
+                            */
+    uint64_t universe;      ///< Ograniczenie kluczy tablicy @p slots albo zero.
+} index_set;
+
+/** @brief Inicjuje pusty zbiór.
+ * @param[out] set      - wskaźnik na inicjowaną strukturę
+ */
+void index_set_init(index_set *set);
+
+/** @brief Inicjuje pusty zbiór pól o kluczach mniejszych od @p universe.
+ * Pozycje elementów trzyma w tablicy o @p universe elementach.
+ * @param[out] set      - wskaźnik na inicjowaną strukturę
+ * @param[in] universe  - ograniczenie kluczy, mniejsze od 2^32
+ */
+void index_set_init_dense(index_set *set, uint64_t universe);
+
+/** @brief Sprawdza, czy pole należy do zbioru.
+ * @param[in] set       - wskaźnik na zbiór
+ * @param[in] key       - klucz pola
+ * @return Wartość @p true, jeżeli pole należy do zbioru, @p false w przeciwnym
+ * wypadku.
+ */
+bool index_set_contains(const index_set *set, uint64_t key);
+
+/** @brief Dodaje pole do zbioru.
+ * Nic nie robi, jeżeli pole już jest w zbiorze.
+ * @param[in,out] set   - wskaźnik na zbiór
+ * @param[in] key       - klucz pola
+ * @param[in] field     - współrzędne pola
+ * @return Wartość @p false, jeżeli zabrakło pamięci, @p true w przeciwnym
+ * wypadku.
+ */
+bool index_set_insert(index_set *set, uint64_t key, pair field);
+
+/** @brief Usuwa pole ze zbioru.
+ * Na zwolnione miejsce przenosimy ostatni element tablicy.
+ * Nic nie robi, jeżeli pola nie ma w zbiorze.
+ * @param[in,out] set   - wskaźnik na zbiór
+ * @param[in] key       - klucz pola
+ */
+void index_set_remove(index_set *set, uint64_t key);
+
+/** @brief Kopiuje zawartość zbioru.
+ * Oba zbiory muszą być zainicjowane z tym samym ograniczeniem kluczy.
+ * @param[in,out] dst   - wskaźnik na zbiór docelowy
+ * @param[in] src       - wskaźnik na kopiowany zbiór
+ * @return Wartość @p true, jeżeli się udało, lub @p false, gdy zabrakło pamięci
+ * lub zbiory mają różne ograniczenia kluczy.
+ */
+bool index_set_copy(index_set *dst, const index_set *src);
+
+/** @brief Usuwa wszystkie elementy, zachowując zaalokowaną pamięć.
+ * @param[in,out] set   - wskaźnik na zbiór
+ */
+void index_set_clear(index_set *set);
+
+/** @brief Zwalnia pamięć zbioru.
+ * @param[in,out] set   - wskaźnik na zbiór
+ */
+void index_set_free(index_set *set);
+
+#endif //GAMMA_INDEX_SET_H
@@ -1,9 +1,19 @@
+#define _GNU_SOURCE
+#include <time.h>
 #include "interactive.h"
 #include "gamma.h"
+#include "ai.h"
+#include "thread_pool.h"
 
 typedef struct board_interactive {
     gamma_t *gamma_game;
 
+    ai_t *ai;
+    const bool *ai_players;
+    uint32_t ai_time;
+    uint64_t ai_playouts;
+    double ai_rate;
+
     uint32_t actual_player;
     uint32_t cell_size;
 
@@ -24,6 +34,11 @@ boardInteractive* make_board (gamma_t *g) {
     new_board->cell_size = how_many_digits(gamma_how_many_players(g)) + 1;
     new_board->my_row = 0;
     new_board->my_column = 0;
+    new_board->ai = NULL;
+    new_board->ai_players = NULL;
+    new_board->ai_time = 0;
+    new_board->ai_playouts = 0;
+    new_board->ai_rate = 0;
 
     return new_board;
 }
@@ -45,10 +60,10 @@ bool will_board_fit(gamma_t *g) {
     struct winsize w;
     ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
 
-    if (gamma_height(g) + 1 > w.ws_row) {
+    if ((uint64_t)gamma_height(g) + 1 > w.ws_row) {
         return false;
     }
-    if (gamma_width(g) * cell_width > w.ws_col) {
+    if ((uint64_t)gamma_width(g) * cell_width > w.ws_col) {
         return false;
     }
     return true;
@@ -177,9 +192,46 @@ void new_feedback(boardInteractive* board) {
     if (gamma_golden_possible(gamma, act_player))
         GOLDEN;
 
+    if (board->ai_playouts > 0)
+        printf(" | AI: %lu playouts, %.0f playouts/s", board->ai_playouts,
+               board->ai_rate);
+
     move_cursor(RESET, board);
 }
 
+static bool is_ai_turn(boardInteractive *board) {
+    return board->ai != NULL && board->ai_players[board->actual_player];
+}
+
+/* Rozpoczyna przeszukiwanie w tle dla aktualnego stanu gry. W turze
+ * człowieka komputerowi gracze przeszukują jego możliwe ruchy, a po
+ * ruchu korzystają z poddrzewa tego ruchu. */
+static void start_thinking(boardInteractive *board) {
+    if (board->ai != NULL)
+        ai_start(board->ai, board->actual_player);
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static void thinking_feedback(boardInteractive *board, double seconds) {
+    uint64_t playouts = ai_playouts(board->ai);
+
+    move_cursor(FEEDBACK, board);
+
+    printf("PLAYER %u | AI thinking: %lu playouts, %.0f playouts/s",
+           board->actual_player, playouts,
+           seconds > 0 ? playouts / seconds : 0);
+
+    move_cursor(RESET, board);
+    fflush(stdout);
+}
+
 
 void end_game(boardInteractive* board){
     gamma_t *gamma = board->gamma_game;
@@ -250,12 +302,105 @@ bool make_golden_move(boardInteractive* board) {
     return false;
 }
 
-void interactive_input(gamma_t *g)
+/* Wykonuje ruch na zaznaczonym polu i informuje o nim komputerowych graczy. */
+static bool play_marked(boardInteractive *board, bool golden) {
+    uint32_t player = board->actual_player;
+    uint32_t column = board->my_column;
+    uint32_t row = board->my_row;
+    uint32_t owner = gamma_player(board->gamma_game, column, row);
+    bool end;
+
+    ai_stop(board->ai);
+
+    end = golden ? make_golden_move(board) : make_move(board);
+
+    if (owner != player && gamma_player(board->gamma_game, column, row) == player)
+        ai_played(board->ai, player, make_pair(column, row), golden);
+
+    if (!end && !is_ai_turn(board))
+        start_thinking(board);
+
+    return end;
+}
+
+static bool skip_marked(boardInteractive *board) {
+    bool end;
+
+    ai_stop(board->ai);
+    ai_passed(board->ai);
+
+    end = skip_move(board);
+
+    if (!end && !is_ai_turn(board))
+        start_thinking(board);
+
+    return end;
+}
+
+/* Tura komputerowego gracza. Wątek interfejsu w trakcie przeszukiwania
+ * obsługuje klawiaturę (CTRL+D kończy grę) i wypisuje postęp. */
+static bool ai_turn(boardInteractive *board) {
+    struct timespec start;
+    double seconds = 0;
+    uint32_t owner;
+    pair field;
+    bool golden;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ai_start(board->ai, board->actual_player);
+
+    while (seconds * 1000 < board->ai_time) {
+        if (kbget_timeout() == 4) {
+            ai_stop(board->ai);
+            light_off(board);
+            end_game(board);
+            return true;
+        }
+
+        seconds = elapsed_seconds(&start);
+        thinking_feedback(board, seconds);
+    }
+
+    ai_stop(board->ai);
+    seconds = elapsed_seconds(&start);
+    board->ai_playouts = ai_playouts(board->ai);
+    board->ai_rate = seconds > 0 ? board->ai_playouts / seconds : 0;
+
+    if (!ai_best(board->ai, &field, &golden))
+        return skip_marked(board);
+
+    light_off(board);
+    board->my_column = field.fst;
+    board->my_row = field.snd;
+    move_cursor(RESET, board);
+
+    owner = gamma_player(board->gamma_game, field.fst, field.snd);
+
+    if (play_marked(board, golden))
+        return true;
+
+    /* Ruch nie powinien się nie udać, ale wtedy nie możemy czekać na
+     * kolejny wybór tego samego ruchu. */
+    if (gamma_player(board->gamma_game, field.fst, field.snd) == owner &&
+        skip_marked(board))
+        return true;
+
+    light_up(board);
+    return false;
+}
+
+void interactive_input(gamma_t *g, const bool *ai_players, uint32_t ai_time)
 {
     int c;
     char *board = gamma_board_max(g);
     boardInteractive* game_board = make_board(g);
 
+    if (ai_players != NULL) {
+        game_board->ai = ai_new(g, pool_default_threads(), (uint64_t)time(NULL));
+        game_board->ai_players = ai_players;
+        game_board->ai_time = ai_time;
+    }
+
     printf ("\033[3 q");
     printf("\033[2J");
     moveTo(0,0);
@@ -266,10 +411,20 @@ void interactive_input(gamma_t *g)
     prepare_cursor(game_board);
     new_feedback(game_board);
 
+    if (!is_ai_turn(game_board))
+        start_thinking(game_board);
+
     while (1) {
+        if (is_ai_turn(game_board)) {
+            if (ai_turn(game_board))
+                break;
+
+            continue;
+        }
+
         c = kbget();
         if (c == KEY_SPACE) {
-            if (make_move(game_board))
+            if (play_marked(game_board, false))
                 break;
 
             light_up(game_board);
@@ -291,10 +446,11 @@ void interactive_input(gamma_t *g)
             light_up(game_board);
         }
         else if (c == 'c' || c == 'C'){
-            skip_move(game_board);
+            if (skip_marked(game_board))
+                break;
         }
         else if (c == 'g' || c == 'G'){
-            if (make_golden_move(game_board))
+            if (play_marked(game_board, true))
                 break;
 
             light_up(game_board);
@@ -306,4 +462,7 @@ void interactive_input(gamma_t *g)
         }
     }
     printf("\n");
+
+    ai_delete(game_board->ai);
+    free(game_board);
 }
\ No newline at end of file
@@ -21,6 +21,9 @@
 
 bool will_board_fit(gamma_t *g);
 
-void interactive_input(gamma_t *g);
+/* Rozgrywa grę w trybie interaktywnym. Gracze, dla których ai_players[i]
+ * jest prawdą (tablica indeksowana numerami graczy, może być NULL), są
+ * komputerowymi graczami, którzy na ruch mają ai_time milisekund. */
+void interactive_input(gamma_t *g, const bool *ai_players, uint32_t ai_time);
 
 #endif //GAMMA_INTERACTIVE_H
@@ -2,10 +2,86 @@
 #include "parser.h"
 #include "batch.h"
 #include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "checkpoint.h"
 #include "interactive.h"
 
 #include "new_parser.h"
-int main() {
+#include "pipeline.h"
+#include "trace.h"
+
+/** Pojemność bufora zdarzeń śledzenia jednego wątku. */
+#define TRACE_EVENTS (1 << 20)
+/** Domyślna liczba linii między punktami kontrolnymi. */
+#define CHECKPOINT_LINES 1000000
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] name      - nazwa programu
+ */
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-p | -c checkpoint [-l lines] [-s seconds] [-r]]\n", name);
+}
+
+/** @brief Odczytuje argumenty programu.
+ * @param[in] argc      - liczba argumentów
+ * @param[in] argv      - argumenty programu
+ * @param[out] config   - ustawienia punktów kontrolnych
+ * @param[out] pipelined - czy wykonywać polecenia potokowo
+ * @return Wartość @p true, jeżeli argumenty są poprawne.
+ */
+static bool parse_arguments(int argc, char *argv[], checkpoint_config *config,
+                            bool *pipelined) {
+    char *end;
+    uint64_t value;
+    int option;
+
+    config->path = NULL;
+    config->every_lines = 0;
+    config->every_seconds = 0;
+    config->resume = false;
+    *pipelined = false;
+
+    while ((option = getopt(argc, argv, "c:l:s:rp")) != -1) {
+        if (option == 'c') {
+            config->path = optarg;
+            continue;
+        }
+
+        if (option == 'r') {
+            config->resume = true;
+            continue;
+        }
+
+        if (option == 'p') {
+            *pipelined = true;
+            continue;
+        }
+
+        if (option == '?' || *optarg < '0' || *optarg > '9')
+            return false;
+
+        value = strtoull(optarg, &end, 10);
+        if (*end != '\0' || value == 0)
+            return false;
+
+        if (option == 'l')
+            config->every_lines = value;
+        else
+            config->every_seconds = value;
+    }
+
+    if (config->path == NULL)
+        return optind == argc && !config->resume && config->every_lines == 0 &&
+               config->every_seconds == 0;
+
+    if (config->every_lines == 0 && config->every_seconds == 0)
+        config->every_lines = CHECKPOINT_LINES;
+
+    return optind == argc && !*pipelined;
+}
+
+int main(int argc, char *argv[]) {
     /*char *buffer = NULL;
     size_t bufsize = 0;
     int linelen;
@@ -66,6 +142,33 @@ int main() {
     }
     free(buffer);
      */
-    batch();
+    const char *trace_file = getenv("GAMMA_TRACE");
+    checkpoint_config checkpoint;
+    bool pipelined;
+    int status = 0;
+
+    if (!parse_arguments(argc, argv, &checkpoint, &pipelined)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (trace_file != NULL && !trace_start(trace_file, TRACE_EVENTS))
+        fprintf(stderr, "tracing is not available in this build\n");
+
+    if (pipelined) {
+        batch_pipelined(stdin, stdout, stderr);
+    }
+    else if (checkpoint.path == NULL) {
+        batch();
+    }
+    else if (!batch_checkpointed(stdin, stdout, stderr, &checkpoint)) {
+        fprintf(stderr, "could not use checkpoint %s\n", checkpoint.path);
+        status = 1;
+    }
+
+    if (!trace_stop())
+        fprintf(stderr, "could not write %s\n", trace_file);
+
+    return status;
 }
 
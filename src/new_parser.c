@@ -1,235 +1,511 @@
+#define _GNU_SOURCE
 #include "gamma.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #include "interactive.h"
 #include "new_parser.h"
+#include "trace.h"
 
+#define GAME_ARGS 4
 #define MOVE_ARGS 3
 #define FIELD_AND_POSSIBLE_ARGS 1
 #define BOARD_ARGS 0
+#define REGION_ARGS 4
+#define STATS_ARGS 0
+
+/** Domyślny czas namysłu komputerowego gracza (w milisekundach). */
+#define DEFAULT_AI_TIME 1000
+
+/** @brief Zamienia napis z samych cyfr na liczbę.
+ * @param[in] s         - napis zakończony zerem
+ * @param[out] number   - odczytana liczba
+ * @return Wartość @p true, jeżeli napis jest liczbą nie większą od INT32_MAX,
+ * jak w pierwotnym parserze trybu wsadowego.
+ */
+static bool read_number(const char *s, uint32_t *number) {
+    uint64_t out = 0;
+
+    if (*s == '\0')
+        return false;
+
+    for (; *s != '\0'; s++) {
+        if (*s < '0' || *s > '9')
+            return false;
 
-void ERROR (uint64_t x) {
-    fprintf(stderr,"ERROR %lu\n", x);
+        out = out * 10 + (*s - '0');
+
+        if (out > INT32_MAX)
+            return false;
+    }
+
+    *number = out;
+    return true;
 }
 
-void OK(uint64_t x) {
-    printf("OK %lu\n", x);
+/** @brief Odczytuje opcję polecenia I.
+ * @param[in] token     - napis zaczynający się od "--"
+ * @param[in,out] cmd   - polecenie
+ * @return Wartość @p true, jeżeli opcja jest poprawna.
+ */
+static bool read_option(char *token, batch_command *cmd) {
+    if (strncmp(token, "--ai=", 5) == 0 && cmd->ai_list == NULL) {
+        cmd->ai_list = token + 5;
+        return *cmd->ai_list != '\0';
+    }
+
+    if (strncmp(token, "--ai-time=", 10) == 0)
+        return read_number(token + 10, &cmd->ai_time) && cmd->ai_time > 0;
+
+    return false;
 }
 
-bool akt_number(uint32_t *number, unsigned char new_digit) {
-    uint64_t new_number = *number;
+line_kind batch_parse(char *line, size_t length, batch_command *cmd) {
+    char *token, *rest;
 
-    if (new_digit < '0' || new_digit > '9')
-        return false;
+    /* Ostatnią linię bez znaku końca linii pomijamy, jak pierwotny parser. */
+    if (length == 0 || line[length - 1] != '\n')
+        return LINE_SKIP;
 
-    new_number = (*number)*10 + (new_digit - '0');
+    if (length == 1 || line[0] == '#')
+        return LINE_SKIP;
 
-    if (new_number < *number || new_number > INT32_MAX)
-        return false;
+    if (memchr(line, '\0', length) != NULL || isspace((unsigned char)line[0]) ||
+        !isspace((unsigned char)line[1]))
+        return LINE_ERROR;
 
-    *number = new_number;
-    return true;
-}
+    memset(cmd, 0, sizeof(batch_command));
+    cmd->name = line[0];
+    cmd->ai_time = DEFAULT_AI_TIME;
 
-void skip_line() {
-    int c;
-    c = getchar();
-    while (c != EOF && c != '\n'){
-        c = getchar();
-    }
-}
+    line[length - 1] = '\0';
+    rest = line + 1;
 
-void skip_spaces() {
-    int c;
-    c = getchar();
-    while (c != EOF && (c != '\n' && isspace(c)))
-        c = getchar();
+    while ((token = strtok_r(rest, " \t\v\f\r", &rest)) != NULL) {
+        if (strncmp(token, "--", 2) == 0) {
+            if (cmd->name != 'I' || !read_option(token, cmd))
+                return LINE_ERROR;
+        }
+        else if (cmd->args == BATCH_MAX_ARGS ||
+                 !read_number(token, &cmd->values[cmd->args++])) {
+            return LINE_ERROR;
+        }
+    }
 
-    ungetc(c, stdin);
+    return LINE_COMMAND;
 }
 
-gamma_t *new_game(uint32_t values[5], uint16_t args) {
-    if (args - 5 != 0)
-        return false;
+/** @brief Odczytuje listę komputerowych graczy.
+ * @param[in] list      - numery graczy oddzielone przecinkami
+ * @param[in] players   - liczba graczy
+ * @return Tablica indeksowana numerami graczy lub NULL, gdy lista jest
+ * niepoprawna lub zabrakło pamięci.
+ */
+static bool* read_ai_players(char *list, uint32_t players) {
+    bool *out = calloc((uint64_t)players + 1, sizeof(bool));
+    char *token, *rest = list;
+    uint32_t player;
+
+    if (out == NULL)
+        return NULL;
+
+    if (list[strlen(list) - 1] == ',') {
+        free(out);
+        return NULL;
+    }
+
+    while ((token = strtok_r(rest, ",", &rest)) != NULL) {
+        if (!read_number(token, &player) || player == 0 || player > players) {
+            free(out);
+            return NULL;
+        }
+        out[player] = true;
+    }
 
-    return gamma_new(values[0], values[1], values[2], values[3]);
+    return out;
+}
 
+/** @brief Zapisuje w wyniku liczbę zwróconą przez silnik.
+ * @param[out] result   - wynik
+ * @param[in] number    - liczba do wypisania
+ */
+static void number_result(batch_result *result, uint64_t number) {
+    result->kind = RESULT_NUMBER;
+    result->number = number;
 }
 
-void print_gamma(gamma_t *g) {
-    char *board = gamma_board(g);
-    printf("%s", board);
-    free(board);
+/** @brief Zapisuje w wyniku planszę gry lub jej prostokąt.
+ * @param[in] state     - stan parsera
+ * @param[in] cmd       - polecenie p lub r, bez parametrów albo z czterema
+ *                        parametrami x0 y0 x1 y1 opisującymi prostokąt
+ * @param[out] result   - wynik
+ */
+static void board_result(batch_state *state, const batch_command *cmd,
+                         batch_result *result) {
+    gamma_t *g = state->gamma;
+    const uint32_t *v = cmd->values;
+
+    if (cmd->name == 'p' && cmd->args == BOARD_ARGS)
+        result->board = gamma_board(g);
+    else if (cmd->name == 'p')
+        result->board = gamma_board_region(g, v[0], v[1], v[2], v[3]);
+    else if (cmd->args == BOARD_ARGS)
+        result->board = gamma_board_rle(g, 0, 0, gamma_width(g) - 1, gamma_height(g) - 1);
+    else
+        result->board = gamma_board_rle(g, v[0], v[1], v[2], v[3]);
+
+    result->kind = result->board == NULL ? RESULT_ERROR : RESULT_BOARD;
 }
 
-void feed(uint64_t number) {
-    printf("%lu\n", number);
+/** @brief Zapisuje w wyniku liczniki pracy silnika.
+ * Gdy silnik skompilowano bez liczników, wynikiem jest błąd.
+ * @param[in] state     - stan parsera
+ * @param[out] result   - wynik
+ */
+static void stats_result(batch_state *state, batch_result *result) {
+    result->stats = malloc(sizeof(gamma_counters));
+    result->kind = RESULT_STATS;
+
+    if (result->stats == NULL || !gamma_stats(state->gamma, result->stats)) {
+        free(result->stats);
+        result->kind = RESULT_ERROR;
+    }
 }
 
-void validate_batch_command(gamma_t *g, unsigned char command, uint32_t values[5], uint16_t args, uint64_t lines) {
-    switch (command) {
+/** @brief Wykonuje polecenie na utworzonej grze.
+ * @param[in,out] state - stan parsera
+ * @param[in] cmd       - polecenie
+ * @param[out] result   - wynik polecenia
+ */
+static void validate_batch_command(batch_state *state, const batch_command *cmd,
+                                   batch_result *result) {
+    gamma_t *g = state->gamma;
+    const uint32_t *values = cmd->values;
+    int args = cmd->args;
+
+    result->kind = RESULT_ERROR;
+
+    switch (cmd->name) {
         case 'm' :
-            if (args - MOVE_ARGS != 0)
-                ERROR(lines);
-            else
-                feed(gamma_move(g, values[0], values[1], values[2]));
+            if (args == MOVE_ARGS)
+                number_result(result, gamma_move(g, values[0], values[1], values[2]));
             break;
 
         case 'g' :
-            if (args - MOVE_ARGS != 0)
-                ERROR(lines);
-            else
-                feed(gamma_golden_move(g, values[0], values[1], values[2]));
+            if (args == MOVE_ARGS)
+                number_result(result, gamma_golden_move(g, values[0], values[1], values[2]));
             break;
 
         case 'b' :
-            if (args - FIELD_AND_POSSIBLE_ARGS != 0)
-                ERROR(lines);
-            else
-                feed(gamma_busy_fields(g, values[0]));
+            if (args == FIELD_AND_POSSIBLE_ARGS)
+                number_result(result, gamma_busy_fields(g, values[0]));
             break;
 
         case 'f' :
-            if (args - FIELD_AND_POSSIBLE_ARGS != 0)
-                ERROR(lines);
-            else
-                feed(gamma_free_fields(g, values[0]));
+            if (args == FIELD_AND_POSSIBLE_ARGS)
+                number_result(result, gamma_free_fields(g, values[0]));
             break;
 
         case 'q' :
-            if (args - FIELD_AND_POSSIBLE_ARGS != 0)
-                ERROR(lines);
-            else
-                feed(gamma_golden_possible(g, values[0]));
+            if (args == FIELD_AND_POSSIBLE_ARGS)
+                number_result(result, gamma_golden_possible(g, values[0]));
             break;
 
         case 'p' :
-            if (args - BOARD_ARGS != 0)
-                ERROR(lines);
-            else
-                printf("%s", gamma_board(g));
+        case 'r' :
+            if (args == BOARD_ARGS || args == REGION_ARGS)
+                board_result(state, cmd, result);
             break;
 
-        default:
-            ERROR(lines);
+        case 's' :
+            if (args == STATS_ARGS)
+                stats_result(state, result);
+            break;
     }
 }
 
-void validate_command(unsigned char command, uint32_t values[5], uint16_t args, uint64_t lines) {
-    static bool mode = false;
-    static gamma_t *gamma;
+#ifdef GAMMA_TRACE
+/** @brief Podaje nazwę polecenia do zdarzeń śledzenia.
+ * @param[in] name      - znak polecenia
+ * @return Napis statyczny z nazwą polecenia.
+ */
+static const char* trace_name(char name) {
+    switch (name) {
+        case 'm': return "batch m";
+        case 'g': return "batch g";
+        case 'b': return "batch b";
+        case 'f': return "batch f";
+        case 'q': return "batch q";
+        case 'p': return "batch p";
+        case 'r': return "batch r";
+        case 's': return "batch s";
+        default: return "batch ?";
+    }
+}
+#endif
+
+/** @brief Wykonuje polecenie rozpoczynające grę.
+ * @param[in,out] state - stan parsera
+ * @param[in] cmd       - polecenie B lub I
+ * @param[out] result   - wynik polecenia
+ * @return Wartość @p true, jeżeli po tym poleceniu należy zakończyć
+ * czytanie wejścia (zakończyła się gra interaktywna).
+ */
+static bool start_game(batch_state *state, const batch_command *cmd,
+                       batch_result *result) {
+    const uint32_t *values = cmd->values;
+    bool *ai_players = NULL;
+    gamma_t *g;
+
+    result->kind = RESULT_ERROR;
+
+    if ((cmd->name != 'B' && (cmd->name != 'I' || !state->interactive)) ||
+        cmd->args != GAME_ARGS)
+        return false;
+
+    g = gamma_reuse(state->spare, values[0], values[1], values[2], values[3]);
+    state->spare = NULL;
+
+    if (g == NULL)
+        return false;
 
-    if (!mode) {
-        if (command == 'B') {
-            gamma = new_game(values, args);
+    if (cmd->name == 'B') {
+        state->gamma = g;
+        result->kind = RESULT_OK;
+        return false;
+    }
 
-            if (gamma == NULL) {
-                ERROR(lines);
-                return;
-            }
-            OK(lines);
-            mode = true;
+    if (cmd->ai_list != NULL) {
+        ai_players = read_ai_players(cmd->ai_list, values[2]);
 
-            return;
+        if (ai_players == NULL) {
+            gamma_delete(g);
+            return false;
         }
-        else if (command == 'I') {
-            gamma = new_game(values, args);
+    }
 
-            if (gamma == NULL || !will_board_fit(gamma)) {
-                ERROR(lines);
-                return;
-            }
+    if (!will_board_fit(g)) {
+        gamma_delete(g);
+        free(ai_players);
+        return false;
+    }
 
-            mode = true;
+    result->kind = RESULT_NONE;
+    interactive_input(g, ai_players, cmd->ai_time);
+    gamma_delete(g);
+    free(ai_players);
 
-            interactive_input(gamma);
-            return;
-        }
-        else {
-            ERROR(lines);
-            return;
-        }
+    return true;
+}
+
+void batch_init(batch_state *state, FILE *out, FILE *err) {
+    state->gamma = NULL;
+    state->spare = NULL;
+    state->lines = 0;
+    state->out = out;
+    state->err = err;
+    state->interactive = true;
+    state->runs = false;
+    state->run.size = 0;
+}
+
+void batch_restart(batch_state *state, FILE *out, FILE *err) {
+    if (state->gamma != NULL) {
+        gamma_delete(state->spare);
+        state->spare = state->gamma;
+        state->gamma = NULL;
+    }
+
+    state->lines = 0;
+    state->out = out;
+    state->err = err;
+}
+
+bool batch_execute(batch_state *state, line_kind kind, const batch_command *cmd,
+                   batch_result *result) {
+    result->line = state->lines;
+    result->kind = kind == LINE_SKIP ? RESULT_NONE : RESULT_ERROR;
+
+    if (kind != LINE_COMMAND)
+        return true;
+
+    if (state->gamma == NULL)
+        return !start_game(state, cmd, result);
+
+    TRACE_BEGIN(trace_name(cmd->name), "line", state->lines);
+    validate_batch_command(state, cmd, result);
+    TRACE_END(trace_name(cmd->name));
+
+    return true;
+}
+
+void batch_print(FILE *out, FILE *err, batch_result *result) {
+    gamma_counters *stats = result->stats;
+
+    switch (result->kind) {
+        case RESULT_NONE:
+            break;
+
+        case RESULT_ERROR:
+            fprintf(err, "ERROR %lu\n", result->line);
+            break;
+
+        case RESULT_OK:
+            fprintf(out, "OK %lu\n", result->line);
+            break;
+
+        case RESULT_NUMBER:
+            fprintf(out, "%lu\n", result->number);
+            break;
+
+        case RESULT_BOARD:
+            fputs(result->board, out);
+            free(result->board);
+            break;
+
+        case RESULT_STATS:
+            fprintf(out, "find_hops %lu\n", stats->find_hops);
+            fprintf(out, "path_writes %lu\n", stats->path_writes);
+            fprintf(out, "unions %lu\n", stats->unions);
+            fprintf(out, "reset_cells %lu\n", stats->reset_cells);
+            fprintf(out, "union_cells %lu\n", stats->union_cells);
+            fprintf(out, "memset_bytes %lu\n", stats->memset_bytes);
+            fprintf(out, "free_scans %lu\n", stats->free_scans);
+            fprintf(out, "golden_local %lu\n", stats->golden_local);
+            fprintf(out, "golden_rejected %lu\n", stats->golden_rejected);
+            fprintf(out, "golden_rollbacks %lu\n", stats->golden_rollbacks);
+            free(stats);
+            break;
     }
-    else {
-        validate_batch_command(gamma, command, values, args - 1, lines);
+}
+
+/** @brief Odkłada polecenie do serii, jeżeli się da.
+ * Seria złożona z ruchów nie przyjmuje zapytań i odwrotnie, więc wtedy
+ * najpierw ją wykonujemy. Pełną serię też wykonujemy od razu.
+ * @param[in,out] state - stan parsera z utworzoną grą
+ * @param[in] cmd       - polecenie
+ * @return Wartość @p true, jeżeli polecenie trafiło do serii, @p false
+ * gdy trzeba je wykonać zwykłą drogą.
+ */
+static bool add_to_run(batch_state *state, const batch_command *cmd) {
+    batch_run *run = &state->run;
+    const uint32_t *v = cmd->values;
+    bool moves;
+    query_kind kind;
+
+    switch (cmd->name) {
+        case 'm' :
+        case 'g' :
+            if (cmd->args != MOVE_ARGS)
+                return false;
+            moves = true;
+            break;
+
+        case 'b' :
+        case 'f' :
+        case 'q' :
+            if (cmd->args != FIELD_AND_POSSIBLE_ARGS)
+                return false;
+            moves = false;
+            kind = cmd->name == 'b' ? QUERY_BUSY
+                 : cmd->name == 'f' ? QUERY_FREE : QUERY_GOLDEN;
+            break;
+
+        default:
+            return false;
     }
+
+    if (run->size > 0 && run->moves != moves)
+        batch_flush(state);
+
+    run->moves = moves;
+
+    if (moves)
+        run->move[run->size] = (move_t){v[0], v[1], v[2], cmd->name == 'g'};
+    else
+        run->query[run->size] = (query_t){kind, v[0]};
+
+    if (++run->size == BATCH_RUN)
+        batch_flush(state);
+
+    return true;
 }
 
-void clear_numbers (uint32_t numbers[5]){
-    for (int i = 0; i < 5; i++) {
-        numbers[i] = 0;
+void batch_flush(batch_state *state) {
+    batch_run *run = &state->run;
+
+    if (run->size == 0)
+        return;
+
+    TRACE_BEGIN("batch run", "commands", run->size);
+    if (run->moves)
+        gamma_apply_moves(state->gamma, run->move, run->size, run->moved);
+    else
+        gamma_query(state->gamma, run->query, run->size, run->answer);
+    TRACE_END("batch run");
+
+    for (size_t i = 0; i < run->size; i++) {
+        if (run->moves)
+            fputs(run->moved[i] ? "1\n" : "0\n", state->out);
+        else
+            fprintf(state->out, "%lu\n", run->answer[i]);
     }
+
+    run->size = 0;
 }
 
-void batch() {
-    int c;
-    unsigned char first_char = 'd';
-    int how_many_args = 0;
-    uint64_t lines = 1;
-    uint32_t values[5] = {0};
-
-    c = getchar();
-
-    while (c != EOF) {
-
-        if (c == '\n') {
-            if (how_many_args != 0) {
-                validate_command(first_char, values, how_many_args, lines);
-                how_many_args = 0;
-                clear_numbers(values);
-            }
-            lines++;
-        }
-        else if (how_many_args > 5) {
-            skip_line();
-            ERROR(lines++);
-            how_many_args = 0;
-            clear_numbers(values);
-        }
-        else {
-            if (isspace(c)) {
-                if (how_many_args == 0) {
-                    ERROR(lines++);
-                    skip_line();
-                    how_many_args = 0;
-                    clear_numbers(values);
-                }
-                else {
-                    skip_spaces();
-                }
-            }
-            else if (how_many_args == 0) {
-                first_char = c;
-                how_many_args++;
-                if (first_char == '#') {
-                    skip_line();
-                    how_many_args=0;
-                    lines++;
-                }
-            }
-            else {
-                while (!isspace(c) && c != '\n' && c != EOF) {
-                    if (!akt_number(&values[how_many_args - 1], c)) {
-                        ERROR(lines++);
-                        skip_line();
-                        how_many_args = 0;
-                        clear_numbers(values);
-                        break;
-                    }
-                    printf("TAKA LICZBA!: %u\n", values[how_many_args - 1]);
-                    c = getchar();
-                }
-                if (c == '\n') {
-                    ungetc(c, stdin);
-                }
-                if (how_many_args != 0) {
-                    how_many_args++;
-                }
-
-            }
-        }
-        c = getchar();
+bool batch_line(batch_state *state, char *line, size_t length) {
+    batch_command cmd;
+    batch_result result;
+    line_kind kind;
+    bool go_on;
+
+    state->lines++;
+    kind = batch_parse(line, length, &cmd);
+
+    if (state->runs && state->gamma != NULL &&
+        (kind == LINE_SKIP || (kind == LINE_COMMAND && add_to_run(state, &cmd))))
+        return true;
+
+    batch_flush(state);
+    go_on = batch_execute(state, kind, &cmd, &result);
+    batch_print(state->out, state->err, &result);
+
+    return go_on;
+}
+
+void batch_free(batch_state *state) {
+    gamma_delete(state->gamma);
+    gamma_delete(state->spare);
+    state->gamma = NULL;
+    state->spare = NULL;
+}
+
+void batch_stream(FILE *in, FILE *out, FILE *err) {
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t length;
+    batch_state state;
+    struct stat info;
+
+    batch_init(&state, out, err);
+
+    /* Z potoku polecenia mogą przychodzić po jednym, w odpowiedzi na wyniki
+     * poprzednich, więc serie odkładamy tylko przy czytaniu pliku. */
+    state.runs = fstat(fileno(in), &info) == 0 && S_ISREG(info.st_mode);
+
+    while ((length = getline(&line, &size, in)) != -1) {
+        if (!batch_line(&state, line, length))
+            break;
     }
 
-}
\ No newline at end of file
+    batch_flush(&state);
+    batch_free(&state);
+    free(line);
+}
+
+void batch() {
+    batch_stream(stdin, stdout, stderr);
+}
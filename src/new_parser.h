@@ -5,6 +5,133 @@
 #ifndef GAMMA_NEW_PARSER_H
 #define GAMMA_NEW_PARSER_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "gamma.h"
+
+/** Największa liczba parametrów liczbowych polecenia. */
+#define BATCH_MAX_ARGS 4
+/** Największa liczba poleceń w jednej serii. */
+#define BATCH_RUN 256
+
+/** @brief Wynik analizy jednej linii wejścia. */
+typedef enum line_kind {
+    LINE_SKIP,          ///< Pusta linia lub komentarz.
+    LINE_ERROR,         ///< Niepoprawna linia.
+    LINE_COMMAND        ///< Poprawne polecenie.
+} line_kind;
+
+/** @brief Polecenie odczytane z jednej linii. */
+typedef struct batch_command {
+    char name;                          ///< Nazwa polecenia.
+    uint32_t values[BATCH_MAX_ARGS];    ///< Parametry liczbowe.
+    int args;                           ///< Liczba parametrów liczbowych.
+    char *ai_list;                      ///< Lista graczy z opcji --ai=, albo NULL.
+    uint32_t ai_time;                   ///< Czas namysłu z opcji --ai-time=.
+} batch_command;
+
+/** @brief Rodzaj wyniku wykonania jednej linii. */
+typedef enum result_kind {
+    RESULT_NONE,        ///< Linia nic nie wypisuje.
+    RESULT_ERROR,       ///< Komunikat ERROR z numerem linii.
+    RESULT_OK,          ///< Komunikat OK z numerem linii.
+    RESULT_NUMBER,      ///< Liczba zwrócona przez silnik.
+    RESULT_BOARD,       ///< Plansza gry.
+    RESULT_STATS        ///< Liczniki pracy silnika.
+} result_kind;
+
+/** @brief Wynik wykonania jednej linii, do wypisania przez @ref batch_print. */
+typedef struct batch_result {
+    uint64_t line;              ///< Numer linii.
+    result_kind kind;           ///< Rodzaj wyniku.
+    union {
+        uint64_t number;        ///< Liczba dla RESULT_NUMBER.
+        char *board;            ///< Zaalokowana plansza dla RESULT_BOARD.
+        gamma_counters *stats;  ///< Zaalokowane liczniki dla RESULT_STATS.
+    };
+} batch_result;
+
+/** @brief Seria poleceń m i g albo b, f i q czekających na wykonanie.
+ * Kolejne takie polecenia wykonujemy naraz funkcją @ref gamma_apply_moves
+ * albo @ref gamma_query. Każde z nich wypisuje tylko liczbę, więc wystarczy
+ * wykonać serię przed każdą inną linią, by wyjście się nie zmieniło.
+ */
+typedef struct batch_run {
+    bool moves;                         ///< Czy seria składa się z ruchów.
+    size_t size;                        ///< Liczba poleceń serii.
+    union {
+        move_t move[BATCH_RUN];         ///< Ruchy serii.
+        query_t query[BATCH_RUN];       ///< Zapytania serii.
+    };
+    union {
+        uint8_t moved[BATCH_RUN];       ///< Wyniki ruchów.
+        uint64_t answer[BATCH_RUN];     ///< Wyniki zapytań.
+    };
+} batch_run;
+
+/** @brief Stan parsera trybu wsadowego. */
+typedef struct batch_state {
+    gamma_t *gamma;     ///< Gra utworzona poleceniem B, albo NULL.
+    gamma_t *spare;     ///< Gra z poprzedniego wejścia do ponownego użycia, albo NULL.
+    uint64_t lines;     ///< Numer ostatnio przetworzonej linii.
+    FILE *out;          ///< Strumień wyników.
+    FILE *err;          ///< Strumień komunikatów o błędach.
+    bool interactive;   ///< Czy polecenie I uruchamia tryb interaktywny.
+    bool runs;          /**< @brief Czy @ref batch_line może odłożyć polecenie do serii.
+                         * Wyniki odłożonych poleceń pojawiają się dopiero
+                         * po kolejnej linii innego rodzaju albo po wywołaniu
+                         * @ref batch_flush, dlatego serie włączamy tylko
+                         * dla wejścia, które nie czeka na te wyniki.
+                         */
+    batch_run run;      ///< Polecenia odłożone do serii.
+} batch_state;
+
+/** @brief Inicjuje parser przed pierwszą linią. */
+void batch_init(batch_state *state, FILE *out, FILE *err);
+
+/** @brief Wykonuje jedną linię wejścia.
+ * Linia musi zawierać znak końca linii, chyba że jest ostatnią linią
+ * wejścia - wtedy jest pomijana. Zawartość linii może zostać zmieniona.
+ * Gdy @p state->runs jest ustawione, polecenia m, g, b, f i q mogą czekać
+ * w serii na wywołanie @ref batch_flush.
+ * Zwraca false, gdy należy przestać czytać wejście. */
+bool batch_line(batch_state *state, char *line, size_t length);
+
+/** @brief Wykonuje odłożoną serię poleceń i wypisuje jej wyniki.
+ * Trzeba ją wywołać po ostatniej linii wejścia i przed każdym użyciem
+ * @p state->gamma poza parserem. */
+void batch_flush(batch_state *state);
+
+/** @brief Dzieli linię na polecenie i parametry.
+ * Linia musi zaczynać się nazwą polecenia, po której występuje biały znak.
+ * Parametry oddzielone są dowolnymi białymi znakami. Linia zostaje zmieniona,
+ * a @p cmd->ai_list wskazuje do jej wnętrza. Nie zależy od stanu parsera,
+ * więc może działać w innym wątku niż @ref batch_execute. */
+line_kind batch_parse(char *line, size_t length, batch_command *cmd);
+
+/** @brief Wykonuje linię przeanalizowaną przez @ref batch_parse.
+ * Numerem linii w wyniku jest @p state->lines. Wynik trzeba przekazać do
+ * @ref batch_print, nawet jeżeli nic nie wypisuje.
+ * Zwraca false, gdy należy przestać czytać wejście. */
+bool batch_execute(batch_state *state, line_kind kind, const batch_command *cmd,
+                   batch_result *result);
+
+/** @brief Wypisuje wynik linii i zwalnia jego pamięć. */
+void batch_print(FILE *out, FILE *err, batch_result *result);
+
+/** @brief Przygotowuje parser do kolejnego wejścia.
+ * Gra z poprzedniego wejścia zostaje zachowana i polecenie B wykorzysta jej
+ * pamięć, jeżeli wymiary planszy i liczba graczy się zgadzają. */
+void batch_restart(batch_state *state, FILE *out, FILE *err);
+
+/** @brief Zwalnia pamięć parsera. */
+void batch_free(batch_state *state);
+
+/** @brief Wykonuje wszystkie polecenia ze strumienia @p in. */
+void batch_stream(FILE *in, FILE *out, FILE *err);
+
+/** @brief Wykonuje polecenia ze standardowego wejścia. */
 void batch();
 
 #endif //GAMMA_NEW_PARSER_H
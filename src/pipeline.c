@@ -0,0 +1,185 @@
+/** @file
+ * Implementacja potokowego trybu wsadowego
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "new_parser.h"
+#include "pipeline.h"
+#include "spsc_ring.h"
+
+/** Początkowy rozmiar bufora wejścia. */
+#define INPUT_BLOCK (1 << 16)
+/** Pojemność kolejek między etapami. */
+#define RING_CAPACITY 4096
+
+/** @brief Polecenie przekazywane z wątku czytającego do wątku silnika. */
+typedef struct command_record {
+    uint64_t line;              ///< Numer linii.
+    line_kind kind;             ///< Rodzaj linii.
+    batch_command cmd;          ///< Polecenie, gdy linia jest poprawna.
+} command_record;
+
+/** @brief Stan potoku. */
+typedef struct pipeline {
+    int input;                  ///< Deskryptor wejścia.
+    FILE *out;                  ///< Strumień wyników.
+    FILE *err;                  ///< Strumień komunikatów o błędach.
+    spsc_ring *commands;        ///< Polecenia do wykonania.
+    spsc_ring *results;         ///< Wyniki do wypisania.
+    uint64_t lines;             ///< Liczba przeczytanych linii.
+} pipeline;
+
+/** @brief Analizuje linię i przekazuje ją do wątku silnika.
+ * Puste linie i komentarze są pomijane, bo nic nie wypisują.
+ * @param[in,out] p     - stan potoku
+ * @param[in,out] line  - linia
+ * @param[in] length    - długość linii
+ */
+static void emit_line(pipeline *p, char *line, size_t length) {
+    command_record *record = ring_slot(p->commands);
+
+    record->line = ++p->lines;
+    record->kind = batch_parse(line, length, &record->cmd);
+
+    if (record->kind == LINE_SKIP)
+        return;
+
+    /* Bufor linii zaraz zostanie nadpisany, a polecenie I i tak jest błędem. */
+    record->cmd.ai_list = NULL;
+    ring_push(p->commands);
+}
+
+/** @brief Czyta wejście blokami i dzieli je na linie.
+ * Przed każdym czytaniem udostępnia wątkowi silnika wszystkie polecenia,
+ * żeby nie czekały, gdy wejście przychodzi powoli.
+ * @param[in,out] arg   - stan potoku
+ * @return NULL.
+ */
+static void* parse_stage(void *arg) {
+    pipeline *p = arg;
+    size_t size = INPUT_BLOCK, used = 0, start = 0, scan = 0;
+    char *buffer = malloc(size), *grown, *newline;
+    ssize_t got;
+
+    while (buffer != NULL) {
+        newline = memchr(buffer + scan, '\n', used - scan);
+
+        if (newline != NULL) {
+            scan = newline - buffer + 1;
+            emit_line(p, buffer + start, scan - start);
+            start = scan;
+            continue;
+        }
+
+        ring_flush(p->commands);
+        memmove(buffer, buffer + start, used - start);
+        used -= start;
+        scan = used;
+        start = 0;
+
+        if (used == size) {
+            grown = realloc(buffer, 2 * size);
+            if (grown == NULL)
+                break;
+
+            buffer = grown;
+            size *= 2;
+        }
+
+        got = read(p->input, buffer + used, size - used);
+
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got <= 0) {
+            /* Ostatnia linia bez znaku końca linii zostanie pominięta. */
+            if (used > 0)
+                emit_line(p, buffer, used);
+            break;
+        }
+
+        used += got;
+    }
+
+    free(buffer);
+    ring_close(p->commands);
+
+    return NULL;
+}
+
+/** @brief Wykonuje polecenia po kolei i przekazuje wyniki do wypisania.
+ * Zanim zacznie czekać na polecenia, udostępnia wszystkie wyniki.
+ * @param[in,out] arg   - stan potoku
+ * @return NULL.
+ */
+static void* execute_stage(void *arg) {
+    pipeline *p = arg;
+    command_record *record;
+    batch_result result;
+    batch_state state;
+
+    batch_init(&state, p->out, p->err);
+    state.interactive = false;
+
+    while ((record = ring_front(p->commands)) != NULL) {
+        state.lines = record->line;
+        batch_execute(&state, record->kind, &record->cmd, &result);
+        ring_pop(p->commands);
+
+        if (result.kind != RESULT_NONE) {
+            *(batch_result *)ring_slot(p->results) = result;
+            ring_push(p->results);
+        }
+
+        if (!ring_ready(p->commands))
+            ring_flush(p->results);
+    }
+
+    batch_free(&state);
+    ring_close(p->results);
+
+    return NULL;
+}
+
+void batch_pipelined(FILE *in, FILE *out, FILE *err) {
+    pipeline p = {fileno(in), out, err, NULL, NULL, 0};
+    pthread_t parser, engine;
+    batch_result *result;
+    bool started = false;
+
+    p.commands = ring_new(sizeof(command_record), RING_CAPACITY);
+    p.results = ring_new(sizeof(batch_result), RING_CAPACITY);
+
+    if (p.commands != NULL && p.results != NULL &&
+        pthread_create(&engine, NULL, execute_stage, &p) == 0) {
+        started = pthread_create(&parser, NULL, parse_stage, &p) == 0;
+
+        /* Bez wątku czytającego silnik od razu dostaje koniec wejścia. */
+        if (!started)
+            ring_close(p.commands);
+
+        while ((result = ring_front(p.results)) != NULL) {
+            batch_print(out, err, result);
+            ring_pop(p.results);
+        }
+
+        pthread_join(engine, NULL);
+
+        if (started)
+            pthread_join(parser, NULL);
+    }
+
+    ring_delete(p.commands);
+    ring_delete(p.results);
+
+    if (!started)
+        batch_stream(in, out, err);
+}
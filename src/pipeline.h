@@ -0,0 +1,33 @@
+/** @file
+ * Interfejs potokowego trybu wsadowego
+ *
+ * Tryb wsadowy rozdzielony na trzy wątki połączone kolejkami
+ * @ref spsc_ring. Pierwszy wątek czyta wejście blokami i zamienia linie na
+ * polecenia funkcją @ref batch_parse, drugi wykonuje je po kolei na silniku
+ * funkcją @ref batch_execute, a trzeci wypisuje wyniki funkcją
+ * @ref batch_print. Każdy etap przetwarza linie w kolejności wejścia, więc
+ * wyjście i komunikaty @p ERROR są takie same jak w zwykłym trybie
+ * wsadowym. Jedyną różnicą jest polecenie I, które tu jest błędem, bo
+ * wejście jest czytane z wyprzedzeniem.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_PIPELINE_H
+#define GAMMA_PIPELINE_H
+
+#include <stdio.h>
+
+/** @brief Wykonuje wszystkie polecenia ze strumienia @p in na trzech wątkach.
+ * Wejście jest czytane bezpośrednio z deskryptora strumienia @p in, więc
+ * nic nie mogło być z niego wcześniej przeczytane. Gdy nie da się utworzyć
+ * wątków, polecenia są wykonywane jak w @ref batch_stream.
+ * @param[in] in        - strumień poleceń
+ * @param[in] out       - strumień wyników
+ * @param[in] err       - strumień komunikatów o błędach
+ */
+void batch_pipelined(FILE *in, FILE *out, FILE *err);
+
+#endif //GAMMA_PIPELINE_H
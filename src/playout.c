@@ -0,0 +1,163 @@
+/** @file
+ * Implementacja losowych rozgrywek gry gamma
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include "playout.h"
+
+/** Liczba losowań pola, zanim przejdziemy do wypisania wszystkich ruchów. */
+#define RANDOM_PROBES 16
+/** Liczba kandydatów porównywanych przez strategię zachłanną. */
+#define GREEDY_CANDIDATES 8
+
+int playout_own_neighbours(gamma_t *g, uint32_t player, pair field) {
+    int out = 0;
+
+    if (field.fst > 0 && gamma_player(g, field.fst - 1, field.snd) == player)
+        out++;
+    if (field.fst + 1 < gamma_width(g) && gamma_player(g, field.fst + 1, field.snd) == player)
+        out++;
+    if (field.snd > 0 && gamma_player(g, field.fst, field.snd - 1) == player)
+        out++;
+    if (field.snd + 1 < gamma_height(g) && gamma_player(g, field.fst, field.snd + 1) == player)
+        out++;
+
+    return out;
+}
+
+/** @brief Próbuje wykonać złoty ruch na losowe dozwolone pole.
+ * @param[in,out] g     - wskaźnik na grę
+ * @param[in,out] r     - generator liczb losowych
+ * @param[in] player    - numer gracza
+ * @return Wartość @p true, jeżeli ruch został wykonany.
+ */
+static bool try_golden(gamma_t *g, rng *r, uint32_t player) {
+    uint64_t count;
+    pair *targets = gamma_golden_targets(g, player, &count);
+    bool out = false;
+
+    if (targets != NULL && count > 0) {
+        pair target = targets[rng_below(r, count)];
+        out = gamma_golden_move(g, player, target.fst, target.snd);
+    }
+
+    free(targets);
+
+    return out;
+}
+
+/** @brief Losuje wolne pole, na które gracz może się ruszyć.
+ * Gdy wolnych pól jest dużo, losujemy pola planszy aż trafimy na dobre,
+ * co zwykle jest dużo szybsze niż wypisanie wszystkich legalnych ruchów.
+ * @param[in] g             - wskaźnik na grę
+ * @param[in,out] r         - generator liczb losowych
+ * @param[in] player        - numer gracza
+ * @param[in] need_own      - czy pole musi sąsiadować z polem gracza
+ * @param[out] out          - wylosowane pole
+ * @return Wartość @p true, jeżeli się udało.
+ */
+static bool probe_move(gamma_t *g, rng *r, uint32_t player,
+                       bool need_own, pair *out) {
+    uint32_t width = gamma_width(g), height = gamma_height(g);
+
+    for (int i = 0; i < RANDOM_PROBES; i++) {
+        *out = make_pair(rng_below(r, width), rng_below(r, height));
+
+        if (gamma_player(g, out->fst, out->snd) == 0 &&
+            (!need_own || playout_own_neighbours(g, player, *out) > 0))
+            return true;
+    }
+
+    return false;
+}
+
+/** @brief Podaje liczbę wolnych pól planszy.
+ * @param[in] g             - wskaźnik na grę
+ * @return Liczba pól, których nie zajął żaden gracz.
+ */
+static uint64_t empty_fields(gamma_t *g) {
+    uint64_t out = (uint64_t)gamma_width(g) * gamma_height(g);
+
+    for (uint32_t player = 1; player <= gamma_how_many_players(g); player++)
+        out -= gamma_busy_fields(g, player);
+
+    return out;
+}
+
+playout_result playout_turn(gamma_t *g, rng *r, uint32_t player,
+                            playout_policy policy, uint32_t golden_percent,
+                            pair *moves) {
+    uint64_t free_fields = gamma_free_fields(g, player);
+    uint64_t count, best_score = 0;
+    pair choice = make_pair(0, 0);
+
+    if (gamma_golden_possible(g, player) &&
+        (free_fields == 0 || rng_below(r, 100) < golden_percent) &&
+        try_golden(g, r, player))
+        return PLAYOUT_GOLDEN;
+
+    if (free_fields == 0)
+        return PLAYOUT_PASS;
+
+    /* Jeżeli gracz może zająć każde wolne pole, wystarczy trafić na wolne. */
+    if (policy == PLAYOUT_RANDOM && free_fields == empty_fields(g) &&
+        probe_move(g, r, player, false, &choice))
+        return gamma_move(g, player, choice.fst, choice.snd) ?
+               PLAYOUT_MOVE : PLAYOUT_PASS;
+
+    if (policy == PLAYOUT_GREEDY && probe_move(g, r, player, true, &choice))
+        return gamma_move(g, player, choice.fst, choice.snd) ?
+               PLAYOUT_MOVE : PLAYOUT_PASS;
+
+    count = gamma_legal_moves(g, player, moves, free_fields);
+
+    if (count == 0)
+        return PLAYOUT_PASS;
+
+    if (policy == PLAYOUT_RANDOM) {
+        choice = moves[rng_below(r, count)];
+    }
+    else {
+        for (int i = 0; i < GREEDY_CANDIDATES; i++) {
+            pair candidate = moves[rng_below(r, count)];
+            uint64_t score = playout_own_neighbours(g, player, candidate) + 1;
+
+            if (score > best_score) {
+                best_score = score;
+                choice = candidate;
+            }
+        }
+    }
+
+    return gamma_move(g, player, choice.fst, choice.snd) ?
+           PLAYOUT_MOVE : PLAYOUT_PASS;
+}
+
+uint64_t playout_game(gamma_t *g, rng *r, uint32_t player,
+                      playout_policy policy, uint32_t golden_percent,
+                      pair *moves, uint64_t *golden) {
+    uint32_t players = gamma_how_many_players(g), passes = 0;
+    uint64_t out = 0;
+    playout_result result;
+
+    while (passes < players) {
+        result = playout_turn(g, r, player, policy, golden_percent, moves);
+
+        if (result == PLAYOUT_PASS) {
+            passes++;
+        }
+        else {
+            out++;
+            passes = 0;
+
+            if (result == PLAYOUT_GOLDEN && golden != NULL)
+                (*golden)++;
+        }
+        player = player % players + 1;
+    }
+
+    return out;
+}
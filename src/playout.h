@@ -0,0 +1,73 @@
+/** @file
+ * Interfejs losowych rozgrywek gry gamma
+ *
+ * Wspólna logika wyboru ruchów w losowych rozgrywkach, używana przez
+ * symulator i przez komputerowych graczy trybu interaktywnego.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_PLAYOUT_H
+#define GAMMA_PLAYOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+#include "rng.h"
+
+/** @brief Strategia wyboru ruchu. */
+typedef enum playout_policy {
+    PLAYOUT_RANDOM,             ///< Losowy legalny ruch.
+    PLAYOUT_GREEDY              ///< Ruch o największej liczbie własnych sąsiadów.
+} playout_policy;
+
+/** @brief Wynik tury gracza. */
+typedef enum playout_result {
+    PLAYOUT_PASS,               ///< Gracz nie mógł się ruszyć.
+    PLAYOUT_MOVE,               ///< Gracz zajął wolne pole.
+    PLAYOUT_GOLDEN              ///< Gracz wykonał złoty ruch.
+} playout_result;
+
+/** @brief Liczy sąsiadów pola należących do gracza.
+ * @param[in] g         - wskaźnik na grę
+ * @param[in] player    - numer gracza
+ * @param[in] field     - współrzędne pola
+ * @return Liczba sąsiednich pól gracza @p player.
+ */
+int playout_own_neighbours(gamma_t *g, uint32_t player, pair field);
+
+/** @brief Wykonuje turę gracza.
+ * Z szansą @p golden_percent (lub zawsze, gdy nie ma wolnych pól) gracz
+ * próbuje złotego ruchu na losowe dozwolone pole, a w przeciwnym wypadku
+ * zajmuje pole wybrane zgodnie ze strategią.
+ * @param[in,out] g             - wskaźnik na grę
+ * @param[in,out] r             - generator liczb losowych
+ * @param[in] player            - numer gracza
+ * @param[in] policy            - strategia wyboru ruchu
+ * @param[in] golden_percent    - szansa próby złotego ruchu (w %)
+ * @param[out] moves            - bufor na co najmniej tyle pól, ile ma plansza
+ * @return Rodzaj wykonanego ruchu.
+ */
+playout_result playout_turn(gamma_t *g, rng *r, uint32_t player,
+                            playout_policy policy, uint32_t golden_percent,
+                            pair *moves);
+
+/** @brief Rozgrywa grę do końca.
+ * Gracze ruszają się po kolei, zaczynając od gracza @p player. Gra kończy
+ * się, gdy wszyscy gracze po kolei spasują.
+ * @param[in,out] g             - wskaźnik na grę
+ * @param[in,out] r             - generator liczb losowych
+ * @param[in] player            - numer gracza, który rusza się pierwszy
+ * @param[in] policy            - strategia wyboru ruchu
+ * @param[in] golden_percent    - szansa próby złotego ruchu (w %)
+ * @param[out] moves            - bufor na co najmniej tyle pól, ile ma plansza
+ * @param[out] golden           - liczba wykonanych złotych ruchów, może być NULL
+ * @return Liczba wykonanych ruchów.
+ */
+uint64_t playout_game(gamma_t *g, rng *r, uint32_t player,
+                      playout_policy policy, uint32_t golden_percent,
+                      pair *moves, uint64_t *golden);
+
+#endif //GAMMA_PLAYOUT_H
@@ -30,6 +30,9 @@ static int kbhit(void) {
     tcsetattr(0, TCSANOW, &term);
     c = getchar();
     tcsetattr(0, TCSANOW, &oterm);
+    /* Po upływie czasu getchar ustawia znacznik końca pliku, który
+     * zostałby na stałe i kolejne odczyty nie czekałyby na klawisz. */
+    if (c == -1) clearerr(stdin);
     if (c != -1) ungetc(c, stdin);
     return ((c != -1) ? 1 : 0);
 }
@@ -70,4 +73,9 @@ int kbget(void)
 
     c = getch();
     return (c == KEY_ESCAPE) ? kbesc() : c;
-}
\ No newline at end of file
+}
+
+int kbget_timeout(void)
+{
+    return kbhit() ? kbget() : KEY_NONE;
+}
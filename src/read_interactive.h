@@ -17,7 +17,12 @@
 #define KEY_DOWN    0x0106
 #define KEY_LEFT    0x0107
 #define KEY_RIGHT   0x0108
+#define KEY_NONE    0x0100
 
 int kbget(void);
 
+/* Czeka na klawisz co najwyżej jedną dziesiątą sekundy.
+ * Zwraca KEY_NONE, jeżeli żaden klawisz nie został naciśnięty. */
+int kbget_timeout(void);
+
 #endif //GAMMA_READ_INTERACTIVE_H
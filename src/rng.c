@@ -0,0 +1,31 @@
+/** @file
+ * Implementacja generatora liczb pseudolosowych.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include "rng.h"
+
+void rng_seed(rng *r, uint64_t seed) {
+    /* Przepuszczamy ziarno przez splitmix64, żeby kolejne ziarna
+     * dawały niezależne ciągi, a stan nigdy nie był zerem. */
+    seed += 0x9e3779b97f4a7c15ULL;
+    seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebULL;
+    seed ^= seed >> 31;
+
+    r->state = seed != 0 ? seed : 1;
+}
+
+uint64_t rng_next(rng *r) {
+    r->state ^= r->state >> 12;
+    r->state ^= r->state << 25;
+    r->state ^= r->state >> 27;
+
+    return r->state * 0x2545f4914f6cdd1dULL;
+}
+
+uint64_t rng_below(rng *r, uint64_t bound) {
+    return rng_next(r) % bound;
+}
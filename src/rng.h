@@ -0,0 +1,42 @@
+/** @file
+ * Interfejs generatora liczb pseudolosowych.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_RNG_H
+#define GAMMA_RNG_H
+
+#include <stdint.h>
+
+/** @brief Stan generatora liczb pseudolosowych.
+ * Generator xorshift64*. Każdy wątek powinien mieć własny stan,
+ * a ten sam ziarno daje zawsze ten sam ciąg liczb.
+ */
+typedef struct rng {
+    uint64_t state;     ///< Stan generatora, liczba niezerowa.
+} rng;
+
+/** @brief Ustawia ziarno generatora.
+ * Różne ziarna (także kolejne liczby) dają niezależnie wyglądające ciągi.
+ * @param[out] r        - wskaźnik na stan generatora
+ * @param[in] seed      - ziarno, dowolna liczba
+ */
+void rng_seed(rng *r, uint64_t seed);
+
+/** @brief Losuje kolejną liczbę.
+ * @param[in,out] r     - wskaźnik na stan generatora
+ * @return Pseudolosowa liczba 64-bitowa.
+ */
+uint64_t rng_next(rng *r);
+
+/** @brief Losuje liczbę z przedziału [0, @p bound).
+ * @param[in,out] r     - wskaźnik na stan generatora
+ * @param[in] bound     - górne ograniczenie, liczba dodatnia
+ * @return Pseudolosowa liczba mniejsza od @p bound.
+ */
+uint64_t rng_below(rng *r, uint64_t bound);
+
+#endif //GAMMA_RNG_H
@@ -0,0 +1,222 @@
+/** @file
+ * Implementacja kolejki cyklicznej jednego producenta i jednego konsumenta
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <linux/futex.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "spsc_ring.h"
+
+/** Rozmiar linii pamięci podręcznej. */
+#define CACHE_LINE 64
+/** Liczba rekordów, po której strona ogłasza swoje położenie. */
+#define RING_BATCH 64
+/** Liczba sprawdzeń kolejki przed zaśnięciem na wielu procesorach. */
+#define RING_SPINS 4096
+
+/** @brief Położenie jednej strony kolejki widziane przez drugą stronę.
+ * Druga strona, czekając na zmianę @p index, ustawia @p sleeping i zasypia
+ * na futeksie @p signal. Strona, która zmienia @p index, sprawdza potem
+ * @p sleeping, więc zawsze któraś z nich zauważy zmianę drugiej.
+ */
+typedef struct ring_side {
+    _Alignas(CACHE_LINE) _Atomic uint64_t index;    ///< Ogłoszone położenie.
+    _Atomic uint32_t signal;    ///< Licznik pobudek, słowo futeksu.
+    _Atomic uint32_t sleeping;  ///< Czy druga strona śpi lub zaraz zaśnie.
+} ring_side;
+
+/** @brief Kolejka cykliczna jednego producenta i jednego konsumenta. */
+struct spsc_ring {
+    ring_side head;             ///< Liczba rekordów udostępnionych przez producenta.
+    ring_side tail;             ///< Liczba rekordów zwolnionych przez konsumenta.
+    _Atomic bool closed;        ///< Czy producent skończył.
+
+    _Alignas(CACHE_LINE) uint64_t push;     ///< Liczba rekordów dodanych przez producenta.
+    uint64_t tail_seen;         ///< Ostatnio odczytane @p tail.index.
+
+    _Alignas(CACHE_LINE) uint64_t pop;      ///< Liczba rekordów usuniętych przez konsumenta.
+    uint64_t head_seen;         ///< Ostatnio odczytane @p head.index.
+
+    _Alignas(CACHE_LINE) char *records;     ///< Tablica rekordów.
+    size_t element;             ///< Rozmiar rekordu.
+    uint64_t mask;              ///< Pojemność minus jeden.
+    uint32_t spins;             ///< Liczba sprawdzeń przed zaśnięciem.
+};
+
+/** @brief Czeka na futeksie, dopóki ma on podaną wartość.
+ * @param[in] word      - słowo futeksu
+ * @param[in] value     - oczekiwana wartość
+ */
+static void futex_wait(_Atomic uint32_t *word, uint32_t value) {
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+/** @brief Budzi wątek czekający na futeksie.
+ * @param[in] word      - słowo futeksu
+ */
+static void futex_wake(_Atomic uint32_t *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/** @brief Ogłasza nowe położenie strony i budzi czekającą drugą stronę.
+ * @param[in,out] side  - strona kolejki
+ * @param[in] index     - nowe położenie
+ */
+static void publish(ring_side *side, uint64_t index) {
+    atomic_store(&side->index, index);
+
+    if (atomic_load(&side->sleeping)) {
+        atomic_fetch_add(&side->signal, 1);
+        futex_wake(&side->signal);
+    }
+}
+
+/** @brief Czeka, aż położenie strony będzie inne niż @p seen.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ * @param[in,out] side  - strona kolejki
+ * @param[in] seen      - ostatnio odczytane położenie
+ * @param[in] closing   - czy przestać czekać po zamknięciu kolejki
+ * @return Nowe położenie strony.
+ */
+static uint64_t wait_change(spsc_ring *ring, ring_side *side, uint64_t seen,
+                            bool closing) {
+    uint64_t index;
+    uint32_t signal;
+
+    for (uint32_t i = 0; i < ring->spins; i++) {
+        index = atomic_load_explicit(&side->index, memory_order_acquire);
+
+        if (index != seen || (closing && atomic_load(&ring->closed)))
+            return index;
+    }
+
+    while (true) {
+        signal = atomic_load(&side->signal);
+        atomic_store(&side->sleeping, 1);
+        index = atomic_load(&side->index);
+
+        if (index != seen || (closing && atomic_load(&ring->closed)))
+            break;
+
+        futex_wait(&side->signal, signal);
+    }
+
+    atomic_store_explicit(&side->sleeping, 0, memory_order_relaxed);
+
+    return index;
+}
+
+spsc_ring* ring_new(size_t element, uint64_t capacity) {
+    spsc_ring *ring;
+    uint64_t size = RING_BATCH * 2;
+
+    while (size < capacity)
+        size *= 2;
+
+    ring = aligned_alloc(CACHE_LINE, sizeof(spsc_ring));
+    if (ring == NULL)
+        return NULL;
+
+    ring->records = malloc(size * element);
+    if (ring->records == NULL) {
+        free(ring);
+        return NULL;
+    }
+
+    atomic_init(&ring->head.index, 0);
+    atomic_init(&ring->head.signal, 0);
+    atomic_init(&ring->head.sleeping, 0);
+    atomic_init(&ring->tail.index, 0);
+    atomic_init(&ring->tail.signal, 0);
+    atomic_init(&ring->tail.sleeping, 0);
+    atomic_init(&ring->closed, false);
+    ring->push = ring->tail_seen = 0;
+    ring->pop = ring->head_seen = 0;
+    ring->element = element;
+    ring->mask = size - 1;
+    ring->spins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? RING_SPINS : 0;
+
+    return ring;
+}
+
+void ring_delete(spsc_ring *ring) {
+    if (ring == NULL)
+        return;
+
+    free(ring->records);
+    free(ring);
+}
+
+void* ring_slot(spsc_ring *ring) {
+    if (ring->push - ring->tail_seen > ring->mask) {
+        ring->tail_seen = atomic_load_explicit(&ring->tail.index, memory_order_acquire);
+
+        while (ring->push - ring->tail_seen > ring->mask) {
+            ring_flush(ring);
+            ring->tail_seen = wait_change(ring, &ring->tail, ring->tail_seen, false);
+        }
+    }
+
+    return ring->records + (ring->push & ring->mask) * ring->element;
+}
+
+void ring_push(spsc_ring *ring) {
+    ring->push++;
+
+    if (ring->push % RING_BATCH == 0)
+        ring_flush(ring);
+}
+
+void ring_flush(spsc_ring *ring) {
+    if (atomic_load_explicit(&ring->head.index, memory_order_relaxed) != ring->push)
+        publish(&ring->head, ring->push);
+}
+
+void ring_close(spsc_ring *ring) {
+    ring_flush(ring);
+    atomic_store(&ring->closed, true);
+    atomic_fetch_add(&ring->head.signal, 1);
+    futex_wake(&ring->head.signal);
+}
+
+bool ring_ready(spsc_ring *ring) {
+    if (ring->pop != ring->head_seen)
+        return true;
+
+    ring->head_seen = atomic_load_explicit(&ring->head.index, memory_order_acquire);
+
+    return ring->pop != ring->head_seen || atomic_load(&ring->closed);
+}
+
+void* ring_front(spsc_ring *ring) {
+    if (ring->pop == ring->head_seen) {
+        ring->head_seen = atomic_load_explicit(&ring->head.index, memory_order_acquire);
+
+        if (ring->pop == ring->head_seen) {
+            publish(&ring->tail, ring->pop);
+            ring->head_seen = wait_change(ring, &ring->head, ring->head_seen, true);
+        }
+
+        /* Po zamknięciu mogły jeszcze dojść ostatnie rekordy. */
+        if (ring->pop == ring->head_seen)
+            ring->head_seen = atomic_load(&ring->head.index);
+
+        if (ring->pop == ring->head_seen)
+            return NULL;
+    }
+
+    return ring->records + (ring->pop & ring->mask) * ring->element;
+}
+
+void ring_pop(spsc_ring *ring) {
+    ring->pop++;
+
+    if (ring->pop % RING_BATCH == 0)
+        publish(&ring->tail, ring->pop);
+}
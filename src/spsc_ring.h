@@ -0,0 +1,86 @@
+/** @file
+ * Interfejs kolejki cyklicznej jednego producenta i jednego konsumenta
+ *
+ * Kolejka przekazuje rekordy stałego rozmiaru między dwoma wątkami bez
+ * zamków. Producent i konsument ogłaszają swoje położenie w kolejce
+ * partiami, a nie po każdym rekordzie, więc liczniki położeń rzadko
+ * przechodzą między pamięciami podręcznymi procesorów. Wątek, który musi
+ * czekać, chwilę sprawdza kolejkę w pętli, a potem zasypia na futeksie,
+ * więc bezczynny etap nie zajmuje procesora. <br>
+ * Funkcje producenta może wywoływać tylko jeden wątek, a funkcje
+ * konsumenta tylko jeden (inny) wątek.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_SPSC_RING_H
+#define GAMMA_SPSC_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Kolejka cykliczna jednego producenta i jednego konsumenta. */
+typedef struct spsc_ring spsc_ring;
+
+/** @brief Tworzy pustą kolejkę.
+ * @param[in] element   - rozmiar rekordu w bajtach
+ * @param[in] capacity  - pojemność, zaokrąglana w górę do potęgi dwójki
+ * @return Wskaźnik na kolejkę lub NULL, gdy zabrakło pamięci.
+ */
+spsc_ring* ring_new(size_t element, uint64_t capacity);
+
+/** @brief Usuwa kolejkę.
+ * @param[in] ring      - wskaźnik na kolejkę lub NULL
+ */
+void ring_delete(spsc_ring *ring);
+
+/** @brief Podaje miejsce na następny rekord (producent).
+ * Czeka, aż w kolejce zwolni się miejsce. Rekord trafia do kolejki
+ * dopiero po wywołaniu @ref ring_push.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ * @return Wskaźnik na miejsce na rekord.
+ */
+void* ring_slot(spsc_ring *ring);
+
+/** @brief Dodaje do kolejki rekord zapisany w miejscu z @ref ring_slot
+ * (producent). Konsument może go zobaczyć dopiero po zebraniu się partii
+ * rekordów albo po @ref ring_flush.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ */
+void ring_push(spsc_ring *ring);
+
+/** @brief Udostępnia konsumentowi wszystkie dodane rekordy (producent).
+ * Należy ją wywołać przed każdym czekaniem producenta na coś innego.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ */
+void ring_flush(spsc_ring *ring);
+
+/** @brief Kończy dodawanie rekordów (producent).
+ * Udostępnia wszystkie dodane rekordy i budzi konsumenta.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ */
+void ring_close(spsc_ring *ring);
+
+/** @brief Sprawdza, czy @ref ring_front wróci bez czekania (konsument).
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ * @return Wartość @p true, jeżeli jest rekord lub kolejka jest zamknięta.
+ */
+bool ring_ready(spsc_ring *ring);
+
+/** @brief Podaje najstarszy rekord kolejki (konsument).
+ * Czeka, aż rekord się pojawi. Rekord zostaje w kolejce do wywołania
+ * @ref ring_pop.
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ * @return Wskaźnik na rekord lub NULL, gdy kolejka jest zamknięta i pusta.
+ */
+void* ring_front(spsc_ring *ring);
+
+/** @brief Usuwa z kolejki rekord podany przez @ref ring_front (konsument).
+ * @param[in,out] ring  - wskaźnik na kolejkę
+ */
+void ring_pop(spsc_ring *ring);
+
+#endif //GAMMA_SPSC_RING_H
@@ -7,8 +7,13 @@
  */
 #include "stack_pairs.h"
 
-stack* new_stack(uint32_t capacity) {
-    stack *ptr = (struct stack*)malloc(sizeof(stack));
+stack* new_stack(uint64_t capacity) {
+    stack *ptr;
+
+    if (capacity >= SIZE_MAX / sizeof(pair))
+        return NULL;
+
+    ptr = (struct stack*)malloc(sizeof(stack));
 
     if (ptr == NULL)
         return NULL;
@@ -25,6 +30,32 @@ stack* new_stack(uint32_t capacity) {
     return ptr;
 }
 
+bool stack_reserve(stack *ptr, uint64_t capacity) {
+    uint64_t size = ptr->maxsize;
+    pair *items;
+
+    if (capacity <= size)
+        return true;
+
+    if (capacity >= SIZE_MAX / sizeof(pair))
+        return false;
+
+    size = 2 * size > capacity ? 2 * size : capacity;
+
+    if (size >= SIZE_MAX / sizeof(pair))
+        size = capacity;
+
+    items = realloc(ptr->items, (size + 1) * sizeof(pair));
+
+    if (items == NULL)
+        return false;
+
+    ptr->items = items;
+    ptr->maxsize = size;
+
+    return true;
+}
+
 uint64_t stack_size(stack *ptr) {
     return ptr->top;
 }
@@ -24,9 +24,21 @@ typedef struct stack {
  * Funkcja wywołująca powinna usunąć ten stos z pamięci.
  * @param[in] capacity  - rozmiar tworzonego stosu, liczba dodatnia.
  * @return wskaźnik na utworzoną stukture, lub NULL jeżeli nie udało
- * się zaalokować pamięci.
+ * się zaalokować pamięci albo jej rozmiar się przepełnia.
  */
-stack* new_stack(uint32_t capacity);
+stack* new_stack(uint64_t capacity);
+
+/** @brief Zapewnia miejsce na podaną liczbę elementów.
+ * Powiększa tablicę elementów co najmniej dwukrotnie, jeżeli mieści mniej
+ * niż @p capacity elementów. Funkcja @ref push nie sprawdza rozmiaru,
+ * więc przed przejściem po obszarze należy zarezerwować miejsce na
+ * wszystkie jego pola.
+ * @param[in,out] ptr   - wskaźnik na stos
+ * @param[in] capacity  - wymagana liczba elementów
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci
+ * (stos pozostaje wtedy bez zmian).
+ */
+bool stack_reserve(stack *ptr, uint64_t capacity);
 
 /** @brief Zwraca ilość elementów na stosie.
  * @param[in] ptr   - zawiera wskaźnik do struktury, której rozmiar chcemy odczytać
@@ -0,0 +1,151 @@
+/** @file
+ * Implementacja puli wątków z podkradaniem pracy.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+struct pool;
+
+/** @brief Stan jednego wątku puli.
+ * Przedział [@p begin, @p end) to numery zadań, które wątek jeszcze ma do
+ * wykonania. Chroni go zamek @p lock, bo mogą go zmniejszać inne wątki.
+ */
+typedef struct pool_worker {
+    pthread_mutex_t lock;       ///< Zamek chroniący przedział zadań.
+    uint64_t begin;             ///< Pierwsze niewykonane zadanie.
+    uint64_t end;               ///< Koniec przedziału zadań.
+    uint32_t id;                ///< Numer wątku.
+    pthread_t thread;           ///< Wątek systemowy.
+    struct pool* pool;          ///< Pula, do której należy wątek.
+} pool_worker;
+
+/** @brief Stan całej puli. */
+typedef struct pool {
+    pool_worker* workers;       ///< Tablica wątków.
+    uint32_t threads;           ///< Liczba wątków.
+    pool_task task;             ///< Wykonywana funkcja.
+    void* context;              ///< Kontekst przekazywany do funkcji.
+} pool;
+
+/** @brief Bierze kolejne zadanie z własnego przedziału.
+ * @param[in,out] worker    - wskaźnik na wątek
+ * @param[out] index        - numer wziętego zadania
+ * @return Wartość @p true, jeżeli przedział nie był pusty.
+ */
+static bool take_own(pool_worker *worker, uint64_t *index) {
+    bool out = false;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->begin < worker->end) {
+        *index = worker->begin++;
+        out = true;
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    return out;
+}
+
+/** @brief Podkrada połowę pracy innego wątku.
+ * Przegląda pozostałe wątki po kolei, zaczynając od następnego,
+ * i zabiera drugą połowę pierwszego niepustego przedziału.
+ * @param[in,out] worker    - wskaźnik na wątek, któremu skończyła się praca
+ * @return Wartość @p true, jeżeli udało się coś podkraść.
+ */
+static bool steal(pool_worker *worker) {
+    pool *p = worker->pool;
+    uint64_t begin, end;
+
+    for (uint32_t i = 1; i < p->threads; i++) {
+        pool_worker *victim = &p->workers[(worker->id + i) % p->threads];
+
+        pthread_mutex_lock(&victim->lock);
+        begin = victim->begin;
+        end = victim->end;
+        if (begin < end) {
+            begin += (end - begin) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end) {
+            pthread_mutex_lock(&worker->lock);
+            worker->begin = begin;
+            worker->end = end;
+            pthread_mutex_unlock(&worker->lock);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief Główna pętla wątku puli.
+ * @param[in,out] arg       - wskaźnik na stan wątku
+ * @return NULL
+ */
+static void* worker_loop(void *arg) {
+    pool_worker *worker = arg;
+    pool *p = worker->pool;
+    uint64_t index;
+
+    do {
+        while (take_own(worker, &index))
+            p->task(p->context, worker->id, index);
+    } while (steal(worker));
+
+    return NULL;
+}
+
+bool pool_run(uint32_t threads, uint64_t tasks, pool_task task, void *context) {
+    pool p;
+    uint32_t started;
+
+    p.workers = calloc(threads, sizeof(pool_worker));
+    if (p.workers == NULL)
+        return false;
+
+    p.threads = threads;
+    p.task = task;
+    p.context = context;
+
+    for (uint32_t i = 0; i < threads; i++) {
+        pthread_mutex_init(&p.workers[i].lock, NULL);
+        p.workers[i].begin = tasks / threads * i + (i < tasks % threads ? i : tasks % threads);
+        p.workers[i].end = p.workers[i].begin + tasks / threads + (i < tasks % threads);
+        p.workers[i].id = i;
+        p.workers[i].pool = &p;
+    }
+
+    /* Wątek 0 to wątek wywołujący. */
+    for (started = 1; started < threads; started++) {
+        if (pthread_create(&p.workers[started].thread, NULL,
+                           worker_loop, &p.workers[started]) != 0)
+            break;
+    }
+
+    /* Jeżeli nie udało się uruchomić wszystkich wątków, działające
+     * wątki podkradną zadania z przedziałów brakujących. */
+    worker_loop(&p.workers[0]);
+
+    for (uint32_t i = 1; i < started; i++)
+        pthread_join(p.workers[i].thread, NULL);
+
+    for (uint32_t i = 0; i < threads; i++)
+        pthread_mutex_destroy(&p.workers[i].lock);
+    free(p.workers);
+
+    return true;
+}
+
+uint32_t pool_default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n > 0 ? (uint32_t)n : 1;
+}
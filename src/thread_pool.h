@@ -0,0 +1,43 @@
+/** @file
+ * Interfejs puli wątków z podkradaniem pracy.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_THREAD_POOL_H
+#define GAMMA_THREAD_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Zadanie wykonywane przez pulę.
+ * @param[in,out] context   - wspólny kontekst przekazany do @ref pool_run
+ * @param[in] worker        - numer wątku, liczba mniejsza od liczby wątków
+ * @param[in] index         - numer zadania, liczba mniejsza od liczby zadań
+ */
+typedef void (*pool_task)(void *context, uint32_t worker, uint64_t index);
+
+/** @brief Wykonuje zadania o numerach od 0 do @p tasks - 1 na wielu wątkach.
+ * Każdy wątek dostaje na początku równy przedział numerów zadań i bierze
+ * je po kolei od początku. Wątek, któremu skończyła się praca, podkrada
+ * drugą połowę przedziału innego wątku. Dzięki temu zadania o różnym czasie
+ * wykonania rozkładają się równo, a wątki rzadko walczą o ten sam zamek. <br>
+ * Numer wątku pozwala zadaniom korzystać z osobnych danych każdego wątku.
+ * Funkcja wraca, gdy wszystkie zadania są wykonane.
+ * @param[in] threads       - liczba wątków, liczba dodatnia
+ * @param[in] tasks         - liczba zadań
+ * @param[in] task          - wykonywana funkcja
+ * @param[in,out] context   - kontekst przekazywany do każdego wywołania
+ * @return Wartość @p true, jeżeli się udało, @p false gdy zabrakło pamięci
+ * (wtedy żadne zadanie nie zostało wykonane).
+ */
+bool pool_run(uint32_t threads, uint64_t tasks, pool_task task, void *context);
+
+/** @brief Podaje liczbę dostępnych procesorów.
+ * @return Liczba procesorów, co najmniej 1.
+ */
+uint32_t pool_default_threads(void);
+
+#endif //GAMMA_THREAD_POOL_H
@@ -0,0 +1,233 @@
+/** @file
+ * Implementacja śledzenia czasu wykonania operacji
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+/** @brief Jedno zdarzenie. */
+typedef struct trace_record {
+    const char *name;           ///< Nazwa operacji.
+    const char *key;            ///< Nazwa parametru lub NULL.
+    uint64_t arg;               ///< Wartość parametru.
+    uint64_t time;              ///< Czas w nanosekundach od początku śledzenia.
+    char phase;                 ///< 'B' lub 'E'.
+} trace_record;
+
+/** @brief Bufor cykliczny zdarzeń jednego wątku.
+ * Pisze do niego tylko wątek właściciel, czytamy go w @ref trace_stop.
+ */
+typedef struct trace_ring {
+    trace_record *records;      ///< Tablica zdarzeń o rozmiarze potęgi dwójki.
+    uint64_t mask;              ///< Rozmiar tablicy minus jeden.
+    _Atomic uint64_t head;      ///< Liczba wszystkich zapisanych zdarzeń.
+    uint32_t thread;            ///< Numer wątku w pliku wynikowym.
+    struct trace_ring *next;    ///< Następny bufor na liście.
+} trace_ring;
+
+atomic_bool trace_active = false;
+
+/** Lista buforów wszystkich wątków. */
+static _Atomic(trace_ring*) rings = NULL;
+/** Liczba wątków, które utworzyły bufor w bieżącej sesji. */
+static _Atomic uint32_t threads = 0;
+/** Numer bieżącej sesji, zwiększany przy każdym @ref trace_start. */
+static _Atomic uint64_t session = 0;
+/** Pojemność bufora wątku w bieżącej sesji. */
+static uint64_t capacity;
+/** Czas rozpoczęcia śledzenia w nanosekundach. */
+static uint64_t origin;
+/** Plik wynikowy bieżącej sesji. */
+static char *output;
+
+/** Bufor bieżącego wątku. */
+static _Thread_local trace_ring *own_ring = NULL;
+/** Sesja, w której utworzono @ref own_ring. Bufory starszych sesji są już
+ * zwolnione, więc nie wolno ich odczytywać. */
+static _Thread_local uint64_t own_session = 0;
+
+/** @brief Podaje czas zegara monotonicznego.
+ * @return Czas w nanosekundach.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+bool trace_start(const char *path, uint64_t events) {
+#ifdef GAMMA_TRACE
+    uint64_t size = 1;
+
+    if (path == NULL || events == 0 ||
+        atomic_load_explicit(&trace_active, memory_order_relaxed))
+        return false;
+
+    output = strdup(path);
+    if (output == NULL)
+        return false;
+
+    while (size < events)
+        size *= 2;
+
+    capacity = size;
+    origin = now_ns();
+    atomic_store(&threads, 0);
+    atomic_fetch_add(&session, 1);
+    atomic_store(&trace_active, true);
+
+    return true;
+#else
+    (void)path;
+    (void)events;
+
+    return false;
+#endif
+}
+
+/** @brief Tworzy bufor bieżącego wątku i dołącza go do listy.
+ * @return Wskaźnik na bufor lub NULL, gdy zabrakło pamięci.
+ */
+static trace_ring* register_ring(void) {
+    trace_ring *ring = malloc(sizeof(trace_ring));
+
+    if (ring == NULL)
+        return NULL;
+
+    ring->records = malloc(capacity * sizeof(trace_record));
+    if (ring->records == NULL) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    ring->thread = atomic_fetch_add(&threads, 1) + 1;
+    ring->next = atomic_load(&rings);
+
+    while (!atomic_compare_exchange_weak(&rings, &ring->next, ring))
+        ;
+
+    return ring;
+}
+
+void trace_event(const char *name, char phase, const char *key, uint64_t arg) {
+    trace_ring *ring = own_ring;
+    trace_record *record;
+    uint64_t head, current = atomic_load_explicit(&session, memory_order_relaxed);
+
+    if (own_session != current) {
+        ring = own_ring = register_ring();
+        own_session = current;
+    }
+
+    if (ring == NULL)
+        return;
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    record = &ring->records[head & ring->mask];
+    record->name = name;
+    record->key = key;
+    record->arg = arg;
+    record->time = now_ns() - origin;
+    record->phase = phase;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/** @brief Wypisuje napis jako napis JSON.
+ * Nazwy operacji są stałymi z kodu, ale na wszelki wypadek zamieniamy
+ * znaki specjalne.
+ * @param[in,out] out   - plik wynikowy
+ * @param[in] s         - napis
+ */
+static void write_string(FILE *out, const char *s) {
+    putc('"', out);
+
+    for (; *s != '\0'; s++) {
+        if (*s == '"' || *s == '\\')
+            putc('\\', out);
+
+        if ((unsigned char)*s >= ' ')
+            putc(*s, out);
+    }
+
+    putc('"', out);
+}
+
+/** @brief Wypisuje zdarzenia jednego bufora.
+ * @param[in,out] out   - plik wynikowy
+ * @param[in] ring      - bufor
+ * @param[in,out] first - czy nie wypisano jeszcze żadnego zdarzenia
+ */
+static void write_ring(FILE *out, trace_ring *ring, bool *first) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t start = head > ring->mask ? head - ring->mask - 1 : 0;
+
+    for (uint64_t i = start; i < head; i++) {
+        trace_record *record = &ring->records[i & ring->mask];
+
+        fputs(*first ? "\n" : ",\n", out);
+        *first = false;
+
+        fputs("{\"name\":", out);
+        write_string(out, record->name);
+        fprintf(out, ",\"ph\":\"%c\",\"ts\":%lu.%03lu,\"pid\":1,\"tid\":%u",
+                record->phase, record->time / 1000, record->time % 1000,
+                ring->thread);
+
+        if (record->key != NULL) {
+            fputs(",\"args\":{", out);
+            write_string(out, record->key);
+            fprintf(out, ":%lu}", record->arg);
+        }
+
+        putc('}', out);
+    }
+}
+
+bool trace_stop(void) {
+    trace_ring *ring, *next;
+    bool first = true, out = true;
+    FILE *file;
+
+    if (!atomic_load(&trace_active))
+        return true;
+
+    atomic_store(&trace_active, false);
+
+    file = fopen(output, "w");
+    if (file != NULL)
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+
+    ring = atomic_exchange(&rings, NULL);
+
+    for (; ring != NULL; ring = next) {
+        next = ring->next;
+
+        if (file != NULL)
+            write_ring(file, ring, &first);
+
+        free(ring->records);
+        free(ring);
+    }
+
+    if (file == NULL || fputs("\n]}\n", file) == EOF)
+        out = false;
+    if (file != NULL && fclose(file) != 0)
+        out = false;
+
+    free(output);
+    output = NULL;
+
+    return out;
+}
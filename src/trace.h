@@ -0,0 +1,71 @@
+/** @file
+ * Interfejs śledzenia czasu wykonania operacji
+ *
+ * Zapisuje zdarzenia początku i końca operacji (poleceń trybu wsadowego
+ * i wywołań silnika) ze znacznikiem czasu, a po zakończeniu wypisuje je
+ * w formacie JSON zdarzeń Chrome (chrome://tracing, Perfetto). <br>
+ * Każdy wątek zapisuje zdarzenia do własnego bufora cyklicznego, więc zapis
+ * nie wymaga blokad, a przy przepełnieniu przepadają najstarsze zdarzenia
+ * wątku. Bufor wątku tworzymy przy jego pierwszym zdarzeniu i dołączamy
+ * do wspólnej listy operacją compare-and-swap. <br>
+ * Zdarzenia są zapisywane tylko w programach skompilowanych z makrem
+ * @p GAMMA_TRACE (opcja CMake o tej samej nazwie). Bez niego makra
+ * @ref TRACE_BEGIN i @ref TRACE_END nic nie robią.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_TRACE_H
+#define GAMMA_TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Czy śledzenie jest włączone, sprawdzane przy każdym zdarzeniu. */
+extern atomic_bool trace_active;
+
+#ifdef GAMMA_TRACE
+/** Zapisuje początek operacji @p name z parametrem @p key o wartości @p arg. */
+#define TRACE_BEGIN(name, key, arg) \
+    (atomic_load_explicit(&trace_active, memory_order_relaxed) ? \
+     trace_event((name), 'B', (key), (arg)) : (void)0)
+/** Zapisuje koniec operacji @p name. */
+#define TRACE_END(name) \
+    (atomic_load_explicit(&trace_active, memory_order_relaxed) ? \
+     trace_event((name), 'E', NULL, 0) : (void)0)
+#else
+/** Bez makra GAMMA_TRACE zdarzenia nie są zapisywane. */
+#define TRACE_BEGIN(name, key, arg) ((void)0)
+/** Bez makra GAMMA_TRACE zdarzenia nie są zapisywane. */
+#define TRACE_END(name) ((void)0)
+#endif
+
+/** @brief Włącza śledzenie.
+ * @param[in] path      - plik, do którego @ref trace_stop zapisze zdarzenia
+ * @param[in] events    - pojemność bufora każdego wątku, dodatnia
+ * @return Wartość @p true, jeżeli śledzenie zostało włączone, @p false gdy
+ * @p path ma wartość NULL, śledzenie już trwa albo program skompilowano
+ * bez makra @p GAMMA_TRACE.
+ */
+bool trace_start(const char *path, uint64_t events);
+
+/** @brief Zapisuje zdarzenie w buforze bieżącego wątku.
+ * Należy używać przez makra @ref TRACE_BEGIN i @ref TRACE_END.
+ * @param[in] name      - nazwa operacji, napis statyczny
+ * @param[in] phase     - 'B' dla początku, 'E' dla końca operacji
+ * @param[in] key       - nazwa parametru (napis statyczny) lub NULL
+ * @param[in] arg       - wartość parametru
+ */
+void trace_event(const char *name, char phase, const char *key, uint64_t arg);
+
+/** @brief Wyłącza śledzenie i zapisuje zebrane zdarzenia.
+ * Inne wątki nie mogą już w tym czasie zapisywać zdarzeń (np. pula wątków
+ * zakończyła pracę). Bufory wątków są zwalniane.
+ * @return Wartość @p true, jeżeli zapis się udał lub śledzenie nie trwało.
+ */
+bool trace_stop(void);
+
+#endif //GAMMA_TRACE_H
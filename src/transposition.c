@@ -0,0 +1,81 @@
+/** @file
+ * Implementacja współbieżnej tablicy transpozycji
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "transposition.h"
+
+/** @brief Wpis tablicy.
+ * Wyzerowany wpis oznacza brak danych, bo zerowy skrót przypisany do
+ * zerowych danych nie jest odróżnialny od pustego miejsca - taki wpis
+ * po prostu nigdy nie zostanie znaleziony.
+ */
+typedef struct entry {
+    _Atomic uint64_t check;     ///< Skrót xor dane.
+    _Atomic uint64_t data;      ///< Dane.
+} entry;
+
+/** @brief Struktura tablicy transpozycji. */
+struct transposition {
+    entry* entries;             ///< Tablica wpisów.
+    uint64_t mask;              ///< Liczba wpisów pomniejszona o jeden.
+};
+
+transposition* transposition_new(uint64_t entries) {
+    transposition *table;
+    uint64_t size = 1;
+
+    while (size < entries && size < (UINT64_MAX >> 1) / sizeof(entry))
+        size *= 2;
+
+    table = malloc(sizeof(transposition));
+    if (table == NULL)
+        return NULL;
+
+    table->entries = calloc(size, sizeof(entry));
+    table->mask = size - 1;
+
+    if (table->entries == NULL) {
+        free(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+void transposition_delete(transposition *table) {
+    if (table != NULL) {
+        free(table->entries);
+        free(table);
+    }
+}
+
+bool transposition_probe(transposition *table, uint64_t hash, uint64_t *data) {
+    entry *e = &table->entries[hash & table->mask];
+    uint64_t check = atomic_load_explicit(&e->check, memory_order_relaxed);
+    uint64_t value = atomic_load_explicit(&e->data, memory_order_relaxed);
+
+    if ((check ^ value) != hash || (check == 0 && value == 0))
+        return false;
+
+    *data = value;
+    return true;
+}
+
+void transposition_store(transposition *table, uint64_t hash, uint64_t data) {
+    entry *e = &table->entries[hash & table->mask];
+
+    atomic_store_explicit(&e->check, hash ^ data, memory_order_relaxed);
+    atomic_store_explicit(&e->data, data, memory_order_relaxed);
+}
+
+void transposition_clear(transposition *table) {
+    for (uint64_t i = 0; i <= table->mask; i++) {
+        atomic_store_explicit(&table->entries[i].check, 0, memory_order_relaxed);
+        atomic_store_explicit(&table->entries[i].data, 0, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,60 @@
+/** @file
+ * Interfejs współbieżnej tablicy transpozycji
+ *
+ * Tablica przypisuje skrótom stanów gry (np. z funkcji @ref gamma_hash)
+ * 64-bitowe dane. Wiele wątków może ją jednocześnie czytać i zapisywać bez
+ * blokad: wpis przechowuje dane i skrót xor dane, więc rozerwany przez
+ * równoległy zapis wpis nie przejdzie sprawdzenia przy odczycie. <br>
+ * Każdy skrót ma jedno miejsce w tablicy i nowszy wpis zastępuje starszy.
+ * Równoległe modyfikacje tego samego wpisu mogą się wzajemnie nadpisać,
+ * więc tablica nadaje się do danych przybliżonych, takich jak statystyki
+ * przeszukiwania.
+ *
+ * @author Bartosz Ruszewski <b.ruszewski@student.uw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 19.10.2026
+ */
+
+#ifndef GAMMA_TRANSPOSITION_H
+#define GAMMA_TRANSPOSITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Struktura tablicy transpozycji. */
+typedef struct transposition transposition;
+
+/** @brief Tworzy pustą tablicę transpozycji.
+ * @param[in] entries   - minimalna liczba wpisów, zaokrąglana w górę
+ *                        do potęgi dwójki
+ * @return Wskaźnik na tablicę lub NULL, gdy zabrakło pamięci.
+ */
+transposition* transposition_new(uint64_t entries);
+
+/** @brief Usuwa tablicę transpozycji.
+ * @param[in] table     - wskaźnik na tablicę, może być NULL
+ */
+void transposition_delete(transposition *table);
+
+/** @brief Szuka danych przypisanych do skrótu.
+ * @param[in] table     - wskaźnik na tablicę
+ * @param[in] hash      - skrót stanu gry
+ * @param[out] data     - znalezione dane
+ * @return Wartość @p true, jeżeli tablica zawiera wpis dla @p hash.
+ */
+bool transposition_probe(transposition *table, uint64_t hash, uint64_t *data);
+
+/** @brief Przypisuje dane do skrótu, zastępując poprzedni wpis.
+ * @param[in,out] table - wskaźnik na tablicę
+ * @param[in] hash      - skrót stanu gry
+ * @param[in] data      - zapisywane dane
+ */
+void transposition_store(transposition *table, uint64_t hash, uint64_t data);
+
+/** @brief Usuwa wszystkie wpisy.
+ * Nie może być wywoływana równolegle z innymi funkcjami.
+ * @param[in,out] table - wskaźnik na tablicę
+ */
+void transposition_clear(transposition *table);
+
+#endif //GAMMA_TRANSPOSITION_H